@@ -43,17 +43,34 @@ class animation_hook : public wf::custom_data_t
         }
     }
 
-    /* Update animation right before each frame */
-    wf::effect_hook_t update_animation_hook = [=] ()
+    bool bounding_boxes_changed(const wf::geometry_t& view_box, const wf::geometry_t& unmapped_box)
     {
+        return (view->get_transformed_node()->get_bounding_box() != view_box) ||
+               (unmapped_contents && (unmapped_contents->get_bounding_box() != unmapped_box));
+    }
+
+    /* Update animation right before each frame. The effects are timed by wf::animation::frame_duration_t,
+     * which samples them at the predicted presentation time of the frame. */
+    wf::animation_hook_t update_animation_hook = [=] (int64_t)
+    {
+        const auto view_box     = view->get_transformed_node()->get_bounding_box();
+        const auto unmapped_box = unmapped_contents ? unmapped_contents->get_bounding_box() : wf::geometry_t{};
         damage_whole_view();
         bool result = animation->step();
-        damage_whole_view();
+
+        // Effects which do not move the view (e.g. fade) repaint the same region, which we have
+        // already damaged above.
+        if (bounding_boxes_changed(view_box, unmapped_box))
+        {
+            damage_whole_view();
+        }
 
         if (!result)
         {
             stop_hook(false);
         }
+
+        return result;
     };
 
     /**
@@ -64,13 +81,12 @@ class animation_hook : public wf::custom_data_t
     {
         if (current_output)
         {
-            current_output->render->rem_effect(&update_animation_hook);
+            current_output->render->rem_animation(&update_animation_hook);
         }
 
         if (new_output)
         {
-            new_output->render->add_effect(&update_animation_hook,
-                wf::OUTPUT_EFFECT_PRE);
+            new_output->render->add_animation(&update_animation_hook);
         }
 
         current_output = new_output;
@@ -2,7 +2,7 @@
 #define ANIMATE_H_
 
 #include <wayfire/view.hpp>
-#include <wayfire/util/duration.hpp>
+#include <wayfire/frame-animation.hpp>
 #include <wayfire/option-wrapper.hpp>
 
 #define WF_ANIMATE_HIDING_ANIMATION (1 << 0)
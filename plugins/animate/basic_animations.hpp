@@ -11,7 +11,7 @@ class fade_animation : public wf::animate::animation_base_t
     wayfire_view view;
 
     float start = 0, end = 1;
-    wf::animation::simple_animation_t progression;
+    wf::animation::simple_frame_animation_t progression;
     std::string name;
 
   public:
@@ -20,7 +20,7 @@ class fade_animation : public wf::animate::animation_base_t
     {
         this->view = view;
         this->progression =
-            wf::animation::simple_animation_t(wf::create_option<wf::animation_description_t>(dur));
+            wf::animation::simple_frame_animation_t(wf::create_option<wf::animation_description_t>(dur));
 
         this->progression.animate(start, end);
 
@@ -58,14 +58,14 @@ class fade_animation : public wf::animate::animation_base_t
 
 using namespace wf::animation;
 
-class zoom_animation_t : public duration_t
+class zoom_animation_t : public frame_duration_t
 {
   public:
-    using duration_t::duration_t;
-    timed_transition_t alpha{*this};
-    timed_transition_t zoom{*this};
-    timed_transition_t offset_x{*this};
-    timed_transition_t offset_y{*this};
+    using frame_duration_t::frame_duration_t;
+    frame_transition_t alpha{*this};
+    frame_transition_t zoom{*this};
+    frame_transition_t offset_x{*this};
+    frame_transition_t offset_y{*this};
 };
 
 class zoom_animation : public fade_animation::animation_base_t
@@ -79,13 +79,13 @@ class zoom_animation : public fade_animation::animation_base_t
     {
         this->view = view;
         this->progression = zoom_animation_t(wf::create_option<wf::animation_description_t>(dur));
-        this->progression.alpha = wf::animation::timed_transition_t(
+        this->progression.alpha = wf::animation::frame_transition_t(
             this->progression, 0, 1);
-        this->progression.zoom = wf::animation::timed_transition_t(
+        this->progression.zoom = wf::animation::frame_transition_t(
             this->progression, 1. / 3, 1);
-        this->progression.offset_x = wf::animation::timed_transition_t(
+        this->progression.offset_x = wf::animation::frame_transition_t(
             this->progression, 0, 0);
-        this->progression.offset_y = wf::animation::timed_transition_t(
+        this->progression.offset_y = wf::animation::frame_transition_t(
             this->progression, 0, 0);
         this->progression.start();
 
@@ -17,14 +17,6 @@ static wf::option_wrapper_t<double> fire_particle_size{"animate/fire_particle_si
 static wf::option_wrapper_t<bool> random_fire_color{"animate/random_fire_color"};
 static wf::option_wrapper_t<wf::color_t> fire_color{"animate/fire_color"};
 
-// generate a random float between s and e
-static float random(float s, float e)
-{
-    double r = 1.0 * (std::rand() % RAND_MAX) / (RAND_MAX - 1);
-
-    return (s * r + (1 - r) * e);
-}
-
 static int particle_count_for_width(int width)
 {
     int particles = fire_particles;
@@ -39,62 +31,42 @@ class fire_node_t : public wf::scene::floating_inner_node_t
     fire_node_t() : floating_inner_node_t(false)
     {
         ps = std::make_unique<ParticleSystem>(1);
-        ps->set_initer(
-            [=] (Particle& p)
-        {
-            init_particle_with_node(p, get_children_bounding_box(), progress_line);
-        });
     }
 
-    static void init_particle_with_node(Particle& p,
-        wf::geometry_t bounding_box, double progress)
+    ParticleEmitter get_emitter()
     {
-        p.life = 1;
-        p.fade = random(0.1, 0.6);
+        auto bounding_box = get_children_bounding_box();
+        const float cur_pos = bounding_box.height * progress_line;
+
+        ParticleEmitter emitter;
+        emitter.pos_min   = {0, cur_pos - 10};
+        emitter.pos_max   = {bounding_box.width, cur_pos + 10};
+        emitter.speed_min = {-10, -25};
+        emitter.speed_max = {10, 5};
+        emitter.gravity   = {-1, -3};
+        emitter.fade_min  = 0.1;
+        emitter.fade_max  = 0.6;
 
-        wf::color_t color_setting = fire_color;
-
-        float r;
-        float g;
-        float b;
+        double size = fire_particle_size;
+        emitter.radius_min = size * 0.8;
+        emitter.radius_max = size * 1.2;
 
         if (!random_fire_color)
         {
             // The calculation here makes the variation lower at darker values
-            float randomize_amount_r = (color_setting.r * 0.857) / 2;
-            float randomize_amount_g = (color_setting.g * 0.857) / 2;
-            float randomize_amount_b = (color_setting.b * 0.857) / 2;
-
-            r = random(color_setting.r - randomize_amount_r,
-                std::min(color_setting.r + randomize_amount_r,
-                    1.0));
-            g = random(color_setting.g - randomize_amount_g,
-                std::min(color_setting.g + randomize_amount_g,
-                    1.0));
-            b = random(color_setting.b - randomize_amount_b,
-                std::min(color_setting.b + randomize_amount_b,
-                    1.0));
+            wf::color_t color_setting = fire_color;
+            glm::vec3 color{color_setting.r, color_setting.g, color_setting.b};
+            emitter.color_min = color - color * 0.857f / 2.0f;
+            emitter.color_max = glm::min(color + color * 0.857f / 2.0f, glm::vec3(1.0));
         } else
         {
-            r = random(0, 1);
-            g = random(0, 1);
-            b = random(0, 1);
-
-            r = 2 * pow(r, 16);
-            g = 2 * pow(g, 16);
-            b = 2 * pow(b, 16);
+            emitter.color_min = glm::vec3(0.0);
+            emitter.color_max = glm::vec3(1.0);
+            emitter.color_exponent = 16;
+            emitter.color_scale    = 2;
         }
 
-        p.color = {r, g, b, 1};
-
-        const double cur_pos = bounding_box.height * progress;
-        p.pos = {random(0, bounding_box.width), random(cur_pos - 10, cur_pos + 10)};
-        p.start_pos = p.pos;
-        p.speed     = {random(-10, 10), random(-25, 5)};
-        p.g = {-1, -3};
-
-        double size = fire_particle_size;
-        p.base_radius = p.radius = random(size * 0.8, size * 1.2);
+        return emitter;
     }
 
     std::string stringify() const override
@@ -236,7 +208,7 @@ void FireAnimation::init(wayfire_view view, wf::animation_description_t dur, wf:
 
     auto bbox = view->get_transformed_node()->get_bounding_box();
     dur.length_ms    *= fire_duration_mod_for_height(bbox.height);
-    this->progression = wf::animation::simple_animation_t(
+    this->progression = wf::animation::simple_frame_animation_t(
         wf::create_option<wf::animation_description_t>(dur));
     this->progression.animate(0, 1);
 
@@ -260,7 +232,7 @@ bool FireAnimation::step()
     transformer->set_progress_line(this->progression);
     if (this->progression.running())
     {
-        transformer->ps->spawn(transformer->ps->size() / 10);
+        transformer->ps->spawn(transformer->ps->size() / 10, transformer->get_emitter());
     }
 
     transformer->ps->update();
@@ -12,7 +12,7 @@ class FireAnimation : public wf::animate::animation_base_t
 {
     std::string name; // the name of the transformer in the view's table
     wayfire_view view;
-    wf::animation::simple_animation_t progression;
+    wf::animation::simple_frame_animation_t progression;
 
   public:
 
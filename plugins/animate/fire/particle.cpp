@@ -1,149 +1,169 @@
 #include "particle.hpp"
 #include "shaders.hpp"
 #include <wayfire/core.hpp>
-
-void Particle::update(float time)
-{
-    if (life <= 0) // ignore
-    {
-        return;
-    }
-
-    const float slowdown = 0.8;
-
-    pos   += speed * 0.2f * slowdown;
-    speed += g * 0.3f * slowdown;
-
-    if (life != 0)
-    {
-        color.a /= life;
-    }
-
-    life    -= fade * 0.3 * slowdown;
-    radius   = base_radius * std::pow(life, 0.5);
-    color.a *= life;
-
-    if (start_pos.x < pos.x)
-    {
-        g.x = -1;
-    } else
-    {
-        g.x = 1;
-    }
-
-    if (life <= 0)
-    {
-        /* move outside */
-        pos = {-10000, -10000};
-    }
-}
+#include <wayfire/task-pool.hpp>
 
 ParticleSystem::ParticleSystem(int particles)
 {
-    resize(particles);
-    last_update_msec = wf::get_current_time();
-    create_program();
-
     particles_alive.store(0);
-}
-
-void ParticleSystem::set_initer(ParticleIniter init)
-{
-    this->pinit_func = init;
+    rng.seed(std::random_device{}());
+    resize(particles);
 }
 
 ParticleSystem::~ParticleSystem()
 {
-    wf::gles::run_in_context([&]
+    if (program_created)
     {
-        program.free_resources();
-    });
+        wf::gles::run_in_context([&]
+        {
+            program.free_resources();
+        });
+    }
 }
 
-int ParticleSystem::spawn(int num)
+float ParticleSystem::random(float s, float e)
 {
-    std::atomic<int> spawned(0);
+    const float r = 1.0f * (rng() - rng.min()) / (rng.max() - rng.min());
+    return s + (e - s) * r;
+}
 
-#   pragma omp parallel for
-    for (size_t i = 0; i < ps.size(); i++)
+int ParticleSystem::spawn(int num, const ParticleEmitter& emitter)
+{
+    // Only a fraction of the particles is spawned per frame, so this is done serially.
+    int spawned = 0;
+    for (size_t i = 0; (i < life.size()) && (spawned < num); i++)
     {
-        if ((ps[i].life <= 0) && (spawned < num))
+        if (life[i] > 0)
+        {
+            continue;
+        }
+
+        life[i] = 1;
+        fade[i] = random(emitter.fade_min, emitter.fade_max);
+
+        pos_x[i]   = start_x[i] = random(emitter.pos_min.x, emitter.pos_max.x);
+        pos_y[i]   = random(emitter.pos_min.y, emitter.pos_max.y);
+        speed_x[i] = random(emitter.speed_min.x, emitter.speed_max.x);
+        speed_y[i] = random(emitter.speed_min.y, emitter.speed_max.y);
+        gravity_x[i] = emitter.gravity.x;
+        gravity_y[i] = emitter.gravity.y;
+
+        base_radius[i] = radius[i] = random(emitter.radius_min, emitter.radius_max);
+        center[2 * i]     = pos_x[i];
+        center[2 * i + 1] = pos_y[i];
+
+        for (int j = 0; j < 3; j++)
         {
-            pinit_func(ps[i]);
-            ++spawned;
-            ++particles_alive;
+            float c = random(emitter.color_min[j], emitter.color_max[j]);
+            c = emitter.color_scale * std::pow(c, emitter.color_exponent);
+            color[4 * i + j] = c;
+            dark_color[4 * i + j] = c * 0.5;
         }
+
+        color[4 * i + 3] = 1;
+        dark_color[4 * i + 3] = 0.5;
+        ++spawned;
     }
 
+    particles_alive += spawned;
     return spawned;
 }
 
 void ParticleSystem::resize(int num)
 {
-    if (num == (int)ps.size())
+    if (num == (int)life.size())
     {
         return;
     }
 
-#   pragma omp parallel for
-    for (size_t i = num; i < ps.size(); i++)
+    for (size_t i = num; i < life.size(); i++)
     {
-        if (ps[i].life >= 0)
+        if (life[i] > 0)
         {
             --particles_alive;
         }
     }
 
-    ps.resize(num);
-
-    color.resize(color_per_particle * num);
-    dark_color.resize(color_per_particle * num);
-    radius.resize(radius_per_particle * num);
-    center.resize(center_per_particle * num);
+    life.resize(num, -1);
+    fade.resize(num, 0);
+    base_radius.resize(num, 0);
+    pos_x.resize(num, 0);
+    pos_y.resize(num, 0);
+    speed_x.resize(num, 0);
+    speed_y.resize(num, 0);
+    gravity_x.resize(num, 0);
+    gravity_y.resize(num, 0);
+    start_x.resize(num, 0);
+
+    color.resize(color_per_particle * num, 0);
+    dark_color.resize(color_per_particle * num, 0);
+    radius.resize(radius_per_particle * num, 0);
+    center.resize(center_per_particle * num, -10000);
 }
 
 int ParticleSystem::size()
 {
-    return ps.size();
+    return life.size();
 }
 
-void ParticleSystem::update_worker(float time, int i)
+int ParticleSystem::update_range(size_t begin, size_t end)
 {
-    if (ps[i].life <= 0)
-    {
-        return;
-    }
-
-    ps[i].update(time);
-
-    if (ps[i].life <= 0)
-    {
-        --particles_alive;
-    }
-
-    for (int j = 0; j < 4; j++) // maybe use memcpy?
+    const float slowdown = 0.8;
+    const float move     = 0.2f * slowdown;
+    const float accel    = 0.3f * slowdown;
+    const float decay    = 0.3f * slowdown;
+
+    // Plain pointers tell the compiler that the arrays do not alias, and the loop body has no branches,
+    // so that the loop can be vectorized. Dead particles are processed too, but they do not change.
+    float *__restrict l  = life.data();
+    const float *__restrict f = fade.data();
+    const float *__restrict br = base_radius.data();
+    float *__restrict px = pos_x.data();
+    float *__restrict py = pos_y.data();
+    float *__restrict sx = speed_x.data();
+    float *__restrict sy = speed_y.data();
+    float *__restrict gx = gravity_x.data();
+    const float *__restrict gy = gravity_y.data();
+    const float *__restrict st = start_x.data();
+    float *__restrict out_color  = color.data();
+    float *__restrict out_dark   = dark_color.data();
+    float *__restrict out_radius = radius.data();
+    float *__restrict out_center = center.data();
+
+    int died = 0;
+    for (size_t i = begin; i < end; i++)
     {
-        color[4 * i + j] = ps[i].color[j];
-        dark_color[4 * i + j] = ps[i].color[j] * 0.5;
+        const float alive = (l[i] > 0) ? 1.0f : 0.0f;
+
+        px[i] += alive * sx[i] * move;
+        py[i] += alive * sy[i] * move;
+        sx[i] += alive * gx[i] * accel;
+        sy[i] += alive * gy[i] * accel;
+        gx[i]  = (st[i] < px[i]) ? -1.0f : 1.0f;
+
+        const float new_life = l[i] - alive * f[i] * decay;
+        died += (alive > 0) & (new_life <= 0);
+        l[i]  = new_life;
+
+        // The alpha of a particle fades out together with its life
+        const float visible_life = std::max(new_life, 0.0f);
+        const bool visible = new_life > 0;
+        out_radius[i] = br[i] * std::sqrt(visible_life);
+        out_color[4 * i + 3] = visible_life;
+        out_dark[4 * i + 3]  = 0.5f * visible_life;
+        out_center[2 * i]     = visible ? px[i] : -10000.0f;
+        out_center[2 * i + 1] = visible ? py[i] : -10000.0f;
     }
 
-    center[2 * i]     = ps[i].pos[0];
-    center[2 * i + 1] = ps[i].pos[1];
-
-    radius[i] = ps[i].radius;
+    return died;
 }
 
 void ParticleSystem::update()
 {
-    // FIXME: don't hardcode 60FPS
-    float time = (wf::get_current_time() - last_update_msec) / 16.0;
-    last_update_msec = wf::get_current_time();
-
-#   pragma omp parallel for
-    for (size_t i = 0; i < ps.size(); i++)
+    wf::get_core().task_pool->parallel_for(0, life.size(), 4096, [&] (size_t begin, size_t end)
     {
-        update_worker(time, i);
-    }
+        particles_alive -= update_range(begin, end);
+    });
 }
 
 int ParticleSystem::statistic()
@@ -158,10 +178,16 @@ void ParticleSystem::create_program()
         program.set_simple(OpenGL::compile_program(particle_vert_source,
             particle_frag_source));
     });
+    program_created = true;
 }
 
 void ParticleSystem::render(glm::mat4 matrix)
 {
+    if (!program_created)
+    {
+        create_program();
+    }
+
     program.use(wf::TEXTURE_TYPE_RGBA);
     static float vertex_data[] = {
         -1, -1,
@@ -191,13 +217,13 @@ void ParticleSystem::render(glm::mat4 matrix)
     program.uniform1f("smoothing", 0.7);
 
     // TODO: optimize shaders for this case
-    GL_CALL(glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, ps.size()));
+    GL_CALL(glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, life.size()));
 
     // particle color
     program.attrib_pointer("color", 4, 0, color.data());
     GL_CALL(glBlendFunc(GL_SRC_ALPHA, GL_ONE));
     program.uniform1f("smoothing", 0.5);
-    GL_CALL(glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, ps.size()));
+    GL_CALL(glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, life.size()));
 
     GL_CALL(glDisable(GL_BLEND));
     GL_CALL(glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
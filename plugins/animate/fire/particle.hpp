@@ -2,48 +2,45 @@
 #define ANIMATION_FIRE_PARTICLE_HPP
 
 #include <wayfire/opengl.hpp>
-#include <functional>
 #include <atomic>
+#include <random>
 #include <vector>
 
-struct Particle
+/* Describes how new particles are spawned. Each value is picked uniformly
+ * from the range [min, max] for every new particle. */
+struct ParticleEmitter
 {
-    float life = -1;
-    float fade;
-
-    float radius, base_radius;
-
-    glm::vec2 pos{0.0, 0.0}, speed{0.0, 0.0}, g{0.0, 0.0};
-    glm::vec2 start_pos;
-
-    glm::vec4 color{1.0, 1.0, 1.0, 1.0};
-
-    /* update the given particle
-     * time is the percentage of the frame which has elapsed
-     * must be thread-safe */
-    void update(float time);
+    glm::vec2 pos_min{0.0, 0.0}, pos_max{0.0, 0.0};
+    glm::vec2 speed_min{0.0, 0.0}, speed_max{0.0, 0.0};
+    glm::vec2 gravity{0.0, 0.0};
+
+    float fade_min = 0.1, fade_max = 0.1;
+    float radius_min = 1, radius_max = 1;
+
+    /* the color channels of each particle are computed as
+     * color_scale * pow(random(color_min, color_max), color_exponent) */
+    glm::vec3 color_min{1.0, 1.0, 1.0}, color_max{1.0, 1.0, 1.0};
+    float color_exponent = 1;
+    float color_scale    = 1;
 };
 
-/* a function to initialize a particle */
-using ParticleIniter = std::function<void (Particle&)>;
-
+/* A particle system which keeps its particles in a struct-of-arrays layout.
+ * Positions, radii and colors are updated directly in the arrays which are
+ * used as vertex attributes for rendering. */
 class ParticleSystem
 {
   public:
-    /* the user of this class has to set up a proper GL context
-     * before creating the ParticleSystem */
     ParticleSystem(int num_part);
     ~ParticleSystem();
-    void set_initer(ParticleIniter init);
 
     ParticleSystem(const ParticleSystem &) = delete;
     ParticleSystem(ParticleSystem &&) = delete;
     ParticleSystem& operator =(const ParticleSystem&) = delete;
     ParticleSystem& operator =(ParticleSystem&&) = delete;
 
-    /* spawn at most num new particles.
+    /* spawn at most num new particles from the given emitter.
      * returns the number of actually spawned particles */
-    int spawn(int num);
+    int spawn(int num, const ParticleEmitter& emitter);
 
     /* change the maximal number of particles
      * Warning: This might kill a lot of particles */
@@ -59,19 +56,23 @@ class ParticleSystem
     int statistic();
 
     /* render particles, each will be multiplied by matrix
-     * The user of this class has to set up the same GL context that was
-     * used during the creation of the particle system */
+     * The user of this class has to set up a proper GL context before
+     * rendering, the shaders are compiled on first use. */
     void render(glm::mat4 matrix);
 
   private:
     ParticleSystem() = delete;
 
-    ParticleIniter pinit_func = [] (auto) {};
-    uint32_t last_update_msec;
+    std::minstd_rand rng;
 
     std::atomic<int> particles_alive;
-    std::vector<Particle> ps;
 
+    /* simulation state, one entry per particle */
+    std::vector<float> life, fade, base_radius;
+    std::vector<float> pos_x, pos_y, speed_x, speed_y;
+    std::vector<float> gravity_x, gravity_y, start_x;
+
+    /* vertex attributes, updated in place by update() */
     static constexpr int color_per_particle = 4;
     std::vector<float> color, dark_color;
 
@@ -82,7 +83,12 @@ class ParticleSystem
     std::vector<float> center;
 
     OpenGL::program_t program;
-    void update_worker(float time, int i);
+    bool program_created = false;
+
+    float random(float s, float e);
+
+    /* update the particles in [begin, end), returns how many of them died */
+    int update_range(size_t begin, size_t end);
     void create_program();
 };
 
@@ -38,10 +38,10 @@ namespace spin
 {
 static const std::string spin_transformer_name = "spin-transformer";
 using namespace wf::animation;
-class spin_animation_t : public duration_t
+class spin_animation_t : public frame_duration_t
 {
   public:
-    using duration_t::duration_t;
+    using frame_duration_t::frame_duration_t;
 };
 class spin_animation : public animate::animation_base_t
 {
@@ -33,7 +33,7 @@
 #include <wayfire/txn/transaction-manager.hpp>
 #include <wayfire/render-manager.hpp>
 #include <wayfire/scene-render.hpp>
-#include <wayfire/util/duration.hpp>
+#include <wayfire/frame-animation.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "animate.hpp"
@@ -169,11 +169,11 @@ namespace squeezimize
 static std::string squeezimize_transformer_name = "animation-squeezimize";
 using namespace wf::scene;
 using namespace wf::animation;
-class squeezimize_animation_t : public duration_t
+class squeezimize_animation_t : public frame_duration_t
 {
   public:
-    using duration_t::duration_t;
-    timed_transition_t squeeze{*this};
+    using frame_duration_t::frame_duration_t;
+    frame_transition_t squeeze{*this};
 };
 class squeezimize_transformer : public wf::scene::view_2d_transformer_t
 {
@@ -5,12 +5,12 @@
 #include <wayfire/output.hpp>
 #include <wayfire/opengl.hpp>
 #include <wayfire/render-manager.hpp>
-#include <wayfire/util/duration.hpp>
+#include <wayfire/frame-animation.hpp>
 
 /* animates wake from suspend/startup by fading in the whole output */
 class wf_system_fade
 {
-    wf::animation::simple_animation_t progression;
+    wf::animation::simple_frame_animation_t progression;
 
     wf::output_t *output;
 
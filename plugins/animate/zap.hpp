@@ -35,10 +35,10 @@ namespace zap
 {
 static const std::string zap_transformer_name = "zap-transformer";
 using namespace wf::animation;
-class zap_animation_t : public duration_t
+class zap_animation_t : public frame_duration_t
 {
   public:
-    using duration_t::duration_t;
+    using frame_duration_t::frame_duration_t;
 };
 class zap_animation : public animate::animation_base_t
 {
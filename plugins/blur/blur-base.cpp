@@ -63,6 +63,8 @@ void main()
 wf_blur_base::wf_blur_base(std::string name)
 {
     this->algorithm_name = name;
+    this->fb[0].set_owner("blur");
+    this->fb[1].set_owner("blur");
 
     this->saturation_opt.load_option("blur/saturation");
     this->alpha_threshold_opt.load_option("blur/alpha_threshold");
@@ -98,6 +100,12 @@ wf_blur_base::~wf_blur_base()
     });
 }
 
+void wf_blur_base::release_buffers()
+{
+    fb[0].free();
+    fb[1].free();
+}
+
 int wf_blur_base::calculate_blur_radius()
 {
     return offset_opt * degrade_opt * std::max(1, (int)iterations_opt);
@@ -81,6 +81,7 @@ class blur_node_t : public transformer_base_node_t
 
         saved_pixels.emplace_back();
         saved_pixels.back().taken = true;
+        saved_pixels.back().pixels.set_owner("blur");
         return &saved_pixels.back();
     }
 
@@ -88,6 +89,12 @@ class blur_node_t : public transformer_base_node_t
     {
         buffer->taken = false;
     }
+
+    /** Free the saved pixel buffers which are not used by a render instance at the moment. */
+    void trim_saved_pixel_buffers()
+    {
+        saved_pixels.remove_if([] (const saved_pixels_t& buffer) { return !buffer.taken; });
+    }
 };
 
 class blur_render_instance_t : public transformer_render_instance_t<blur_node_t>
@@ -341,6 +348,24 @@ class wayfire_blur : public wf::plugin_interface_t
         }
     }
 
+    wf::signal::connection_t<wf::buffer_memory_pressure_signal> on_memory_pressure = [=] (auto)
+    {
+        // The saved pixels are full-size copies of the render target. They are needed only while a blurred
+        // view is being rendered, so they can be safely dropped between frames.
+        for (auto& view : wf::get_core().get_all_views())
+        {
+            if (auto node = view->get_transformed_node()->get_transformer<wf::scene::blur_node_t>())
+            {
+                node->trim_saved_pixel_buffers();
+            }
+        }
+
+        if (blur_algorithm)
+        {
+            blur_algorithm->release_buffers();
+        }
+    };
+
   public:
     void init() override
     {
@@ -353,6 +378,7 @@ class wayfire_blur : public wf::plugin_interface_t
         }
 
         wf::get_core().connect(&on_render_pass_begin);
+        wf::get_core().connect(&on_memory_pressure);
         blur_method_changed = [=] ()
         {
             blur_algorithm = create_blur_from_name(method_opt);
@@ -133,6 +133,9 @@ class wf_blur_base
 
     virtual int calculate_blur_radius();
 
+    /* free the temporary buffers, they are reallocated on the next blur */
+    void release_buffers();
+
     /**
      * Calculate the blurred background region.
      *
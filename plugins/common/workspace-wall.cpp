@@ -152,6 +152,13 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
                     const auto ws_bbox     = self->wall->get_workspace_rectangle({i, j});
                     const auto visible_box =
                         geometry_intersection(self->wall->viewport, ws_bbox) - wf::origin(ws_bbox);
+                    if (!self->aux_buffers[i][j].get_buffer() &&
+                        (visible_box.width > 0) && (visible_box.height > 0))
+                    {
+                        // The buffer was released under memory pressure, but the workspace is visible again.
+                        self->allocate_workspace_buffer(i, j);
+                    }
+
                     wf::regionf_t visible_damage = self->aux_buffer_damage[i][j] & visible_box;
                     if (consider_rescale_workspace_buffer(i, j, visible_damage))
                     {
@@ -202,6 +209,10 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
                     auto B   = self->get_bounding_box();
                     auto render_geometry = wf::scale_box(A, B, box);
                     auto& buffer = self->aux_buffers[i][j];
+                    if (!buffer.get_buffer())
+                    {
+                        continue;
+                    }
 
                     float dim = self->wall->get_color_for_workspace({i, j});
                     const auto& subbox = self->aux_buffer_current_subbox[i][j];
@@ -257,19 +268,11 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
                 auto node = std::make_shared<workspace_stream_node_t>(
                     wall->output, wf::point_t{i, j});
                 workspaces[i].push_back(node);
-
-                auto bbox = workspaces[i][j]->get_bounding_box();
-
-                aux_buffers[i][j].allocate(wf::dimensions(bbox), wall->output->handle->scale,
-                    wf::buffer_allocation_hints_t{
-                        .needs_alpha = false,
-                        .hdr_linear  = wall->output && wall->output->is_hdr(),
-                    });
-                aux_buffer_damage[i][j] |= bbox;
-                aux_buffer_current_scale[i][j]  = 1.0;
-                aux_buffer_current_subbox[i][j] = std::nullopt;
+                allocate_workspace_buffer(i, j);
             }
         }
+
+        wf::get_core().connect(&on_memory_pressure);
     }
 
     virtual void gen_render_instances(
@@ -299,6 +302,37 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
     workspace_wall_t *wall;
     std::vector<std::vector<std::shared_ptr<workspace_stream_node_t>>> workspaces;
 
+    void allocate_workspace_buffer(int i, int j)
+    {
+        auto bbox = workspaces[i][j]->get_bounding_box();
+        aux_buffers[i][j].set_owner("workspace-wall");
+        aux_buffers[i][j].allocate(wf::dimensions(bbox), wall->output->handle->scale,
+            wf::buffer_allocation_hints_t{
+                .needs_alpha = false,
+                .hdr_linear  = wall->output && wall->output->is_hdr(),
+            });
+        aux_buffer_damage[i][j] |= bbox;
+        aux_buffer_current_scale[i][j]  = 1.0;
+        aux_buffer_current_subbox[i][j] = std::nullopt;
+    }
+
+    // Under memory pressure, drop the buffers of workspaces which are not visible in the current viewport.
+    // They are reallocated and fully repainted once they become visible again.
+    wf::signal::connection_t<wf::buffer_memory_pressure_signal> on_memory_pressure = [=] (auto)
+    {
+        for (int i = 0; i < (int)workspaces.size(); i++)
+        {
+            for (int j = 0; j < (int)workspaces[i].size(); j++)
+            {
+                auto visible = geometry_intersection(wall->viewport, wall->get_workspace_rectangle({i, j}));
+                if ((visible.width <= 0) || (visible.height <= 0))
+                {
+                    aux_buffers[i][j].free();
+                }
+            }
+        }
+    };
+
     // Buffers keeping the contents of almost-static workspaces
     per_workspace_map_t<wf::auxilliary_buffer_t> aux_buffers;
     // Damage accumulated for those buffers
@@ -104,6 +104,7 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
                 {
                     const float scale = self->cube->output->handle->scale;
                     auto bbox = self->workspaces[i]->get_bounding_box();
+                    framebuffers[i].set_owner("cube");
                     framebuffers[i].allocate(wf::dimensions(bbox), scale,
                         wf::buffer_allocation_hints_t{.hdr_linear = is_hdr});
 
@@ -216,7 +217,7 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
             background = std::make_unique<wf_cube_background_skydome>(output);
         } else if (last_background_mode == "cubemap")
         {
-            background = std::make_unique<wf_cube_background_cubemap>();
+            background = std::make_unique<wf_cube_background_cubemap>(output);
         } else
         {
             LOGE("cube: Unrecognized background mode %s. Using default \"simple\"",
@@ -3,7 +3,7 @@
 
 #include <config.h>
 #include <wayfire/option-wrapper.hpp>
-#include <wayfire/util/duration.hpp>
+#include <wayfire/frame-animation.hpp>
 #include <wayfire/util/log.hpp>
 #include <wayfire/opengl.hpp>
 
@@ -11,15 +11,15 @@
 
 using namespace wf::animation;
 
-class cube_animation_t : public duration_t
+class cube_animation_t : public frame_duration_t
 {
   public:
-    using duration_t::duration_t;
-    timed_transition_t offset_y{*this};
-    timed_transition_t offset_z{*this};
-    timed_transition_t rotation{*this};
-    timed_transition_t zoom{*this};
-    timed_transition_t ease_deformation{*this};
+    using frame_duration_t::frame_duration_t;
+    frame_transition_t offset_y{*this};
+    frame_transition_t offset_z{*this};
+    frame_transition_t rotation{*this};
+    frame_transition_t zoom{*this};
+    frame_transition_t ease_deformation{*this};
 };
 
 struct wf_cube_animation_attribs
@@ -4,11 +4,13 @@
 #include <config.h>
 #include <wayfire/core.hpp>
 #include <wayfire/img.hpp>
+#include <wayfire/render-manager.hpp>
 
 #include "cubemap-shaders.tpp"
 
-wf_cube_background_cubemap::wf_cube_background_cubemap()
+wf_cube_background_cubemap::wf_cube_background_cubemap(wf::output_t *output)
 {
+    this->output = output;
     create_program();
     reload_texture();
 }
@@ -18,7 +20,6 @@ wf_cube_background_cubemap::~wf_cube_background_cubemap()
     wf::gles::run_in_context([&]
     {
         program.free_resources();
-        GL_CALL(glDeleteTextures(1, &tex));
         GL_CALL(glDeleteBuffers(1, &vbo_cube_vertices));
         GL_CALL(glDeleteBuffers(1, &ibo_cube_indices));
     });
@@ -30,6 +31,8 @@ void wf_cube_background_cubemap::create_program()
     {
         program.set_simple(
             OpenGL::compile_program(cubemap_vertex, cubemap_fragment));
+        GL_CALL(glGenBuffers(1, &vbo_cube_vertices));
+        GL_CALL(glGenBuffers(1, &ibo_cube_indices));
     });
 }
 
@@ -40,44 +43,18 @@ void wf_cube_background_cubemap::reload_texture()
         return;
     }
 
+    /* Decoding happens on a worker thread, keep showing the old image until the new one is ready. */
     last_background_image = background_image;
-
-    wf::gles::run_in_context([&]
+    pending_texture = image_io::load_texture_async(last_background_image, GL_TEXTURE_CUBE_MAP);
+    pending_texture->then([this] ()
     {
-        if (tex == (uint32_t)-1)
-        {
-            GL_CALL(glGenTextures(1, &tex));
-            GL_CALL(glGenBuffers(1, &vbo_cube_vertices));
-            GL_CALL(glGenBuffers(1, &ibo_cube_indices));
-        }
-
-        GL_CALL(glBindTexture(GL_TEXTURE_CUBE_MAP, tex));
-        if (!image_io::load_from_file(last_background_image, GL_TEXTURE_CUBE_MAP))
-        {
-            LOGE("Failed to load cubemap background image from \"%s\".",
-                last_background_image.c_str());
-
-            GL_CALL(glDeleteTextures(1, &tex));
-            GL_CALL(glDeleteBuffers(1, &vbo_cube_vertices));
-            GL_CALL(glDeleteBuffers(1, &ibo_cube_indices));
-            tex = -1;
-        }
-
-        if (tex != (uint32_t)-1)
+        if (!pending_texture->get_texture())
         {
-            GL_CALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER,
-                GL_LINEAR));
-            GL_CALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER,
-                GL_LINEAR));
-            GL_CALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S,
-                GL_CLAMP_TO_EDGE));
-            GL_CALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T,
-                GL_CLAMP_TO_EDGE));
-            GL_CALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R,
-                GL_CLAMP_TO_EDGE));
+            LOGE("Failed to load cubemap background image from \"", last_background_image, "\".");
         }
 
-        GL_CALL(glBindTexture(GL_TEXTURE_CUBE_MAP, 0));
+        texture = std::move(pending_texture);
+        output->render->damage_whole();
     });
 }
 
@@ -86,7 +63,14 @@ void wf_cube_background_cubemap::render_frame(const wf::render_target_t& fb,
 {
     reload_texture();
 
-    if (tex == (uint32_t)-1)
+    if (!texture)
+    {
+        GL_CALL(glClearColor(0.0, 0.0, 0.0, 1.0));
+        GL_CALL(glClear(GL_COLOR_BUFFER_BIT));
+        return;
+    }
+
+    if (!texture->get_texture())
     {
         GL_CALL(glClearColor(TEX_ERROR_FLAG_COLOR));
         GL_CALL(glClear(GL_COLOR_BUFFER_BIT));
@@ -96,7 +80,7 @@ void wf_cube_background_cubemap::render_frame(const wf::render_target_t& fb,
     program.use(wf::TEXTURE_TYPE_RGBA);
     GL_CALL(glDepthMask(GL_FALSE));
 
-    GL_CALL(glBindTexture(GL_TEXTURE_CUBE_MAP, tex));
+    GL_CALL(glBindTexture(GL_TEXTURE_CUBE_MAP, texture->get_texture()));
 
     GLfloat cube_vertices[] = {
         -1.0, 1.0, 1.0,
@@ -2,22 +2,28 @@
 #define WF_CUBE_CUBEMAP_HPP
 
 #include "cube-background.hpp"
+#include "wayfire/output.hpp"
+#include <wayfire/img.hpp>
+#include <memory>
 
 class wf_cube_background_cubemap : public wf_cube_background_base
 {
   public:
-    wf_cube_background_cubemap();
+    wf_cube_background_cubemap(wf::output_t *output);
     virtual void render_frame(const wf::render_target_t& fb,
         wf_cube_animation_attribs& attribs) override;
 
     ~wf_cube_background_cubemap();
 
   private:
+    wf::output_t *output;
+
     void reload_texture();
     void create_program();
 
     OpenGL::program_t program;
-    GLuint tex = -1;
+    /* The texture being displayed, and the one which is loaded after the image option changed */
+    std::unique_ptr<image_io::texture_future_t> texture, pending_texture;
     GLuint vbo_cube_vertices;
     GLuint ibo_cube_indices;
 
@@ -3,6 +3,7 @@
 #include <wayfire/img.hpp>
 
 #include <wayfire/output.hpp>
+#include <wayfire/render-manager.hpp>
 #include <wayfire/workspace-set.hpp>
 
 
@@ -24,10 +25,6 @@ wf_cube_background_skydome::~wf_cube_background_skydome()
     wf::gles::run_in_context([&]
     {
         program.free_resources();
-        if (tex != (GLuint) - 1)
-        {
-            GL_CALL(glDeleteTextures(1, &tex));
-        }
     });
 }
 
@@ -46,29 +43,19 @@ void wf_cube_background_skydome::reload_texture()
         return;
     }
 
+    /* Decoding happens on a worker thread, keep showing the old image until the new one is ready. */
     last_background_image = background_image;
-    if (tex == (uint32_t)-1)
+    pending_texture = image_io::load_texture_async(last_background_image, GL_TEXTURE_2D);
+    pending_texture->then([this] ()
     {
-        GL_CALL(glGenTextures(1, &tex));
-    }
-
-    GL_CALL(glBindTexture(GL_TEXTURE_2D, tex));
-
-    if (image_io::load_from_file(last_background_image, GL_TEXTURE_2D))
-    {
-        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-    } else
-    {
-        LOGE("Failed to load skydome image from \"%s\".",
-            last_background_image.c_str());
-        GL_CALL(glDeleteTextures(1, &tex));
-        tex = -1;
-    }
+        if (!pending_texture->get_texture())
+        {
+            LOGE("Failed to load skydome image from \"", last_background_image, "\".");
+        }
 
-    GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+        texture = std::move(pending_texture);
+        output->render->damage_whole();
+    });
 }
 
 void wf_cube_background_skydome::fill_vertices()
@@ -132,7 +119,15 @@ void wf_cube_background_skydome::render_frame(const wf::render_target_t& fb,
     fill_vertices();
     reload_texture();
 
-    if (tex == (uint32_t)-1)
+    if (!texture)
+    {
+        GL_CALL(glClearColor(0.0, 0.0, 0.0, 1.0));
+        GL_CALL(glClear(GL_COLOR_BUFFER_BIT));
+
+        return;
+    }
+
+    if (!texture->get_texture())
     {
         GL_CALL(glClearColor(TEX_ERROR_FLAG_COLOR));
         GL_CALL(glClear(GL_COLOR_BUFFER_BIT));
@@ -165,7 +160,7 @@ void wf_cube_background_skydome::render_frame(const wf::render_target_t& fb,
     program.uniformMatrix4f("model", model);
 
     GL_CALL(glActiveTexture(GL_TEXTURE0));
-    GL_CALL(glBindTexture(GL_TEXTURE_2D, tex));
+    GL_CALL(glBindTexture(GL_TEXTURE_2D, texture->get_texture()));
 
     GL_CALL(glDrawElements(GL_TRIANGLES,
         6 * SKYDOME_GRID_WIDTH * (SKYDOME_GRID_HEIGHT - 2),
@@ -3,6 +3,8 @@
 
 #include "cube-background.hpp"
 #include "wayfire/output.hpp"
+#include <wayfire/img.hpp>
+#include <memory>
 #include <vector>
 
 class wf_cube_background_skydome : public wf_cube_background_base
@@ -22,7 +24,8 @@ class wf_cube_background_skydome : public wf_cube_background_base
     void reload_texture();
 
     OpenGL::program_t program;
-    GLuint tex = -1;
+    /* The texture being displayed, and the one which is loaded after the image option changed */
+    std::unique_ptr<image_io::texture_future_t> texture, pending_texture;
 
     std::vector<GLfloat> vertices;
     std::vector<GLfloat> coords;
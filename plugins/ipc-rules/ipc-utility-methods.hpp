@@ -5,16 +5,23 @@
 #include "wayfire/debug.hpp"
 #include "wayfire/signal-definitions.hpp"
 #include "wayfire/config-backend.hpp"
+#include <map>
 #include <set>
 #include <cstdlib>
 #include <filesystem>
 #include <wayfire/plugin.hpp>
 #include <wayfire/render-manager.hpp>
+#include <wayfire/img.hpp>
+#include <wayfire/seat.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wayfire/output-layout.hpp>
 #include <wayfire/config/compound-option.hpp>
 #include <wayfire/config/config-manager.hpp>
 
+#if WF_HAS_VULKANFX
+    #include <wayfire/vulkan.hpp>
+#endif
+
 extern "C" {
 #include <wlr/backend/headless.h>
 #include <wlr/backend/multi.h>
@@ -40,6 +47,12 @@ class ipc_rules_utility_methods_t
         method_repository->register_method("wayfire/reload-config-metadata", reload_config_metadata);
         method_repository->register_method("wayfire/reload-plugins", reload_plugins);
         method_repository->register_method("wayfire/render-metrics", get_render_metrics);
+        method_repository->register_method("wayfire/buffer-memory", get_buffer_memory);
+        method_repository->register_method("wayfire/frame-pacing", get_frame_pacing);
+        method_repository->register_method("wayfire/pointer-motion-stats", get_pointer_motion_stats);
+        method_repository->register_method("wayfire/promotion-stats", get_promotion_stats);
+        method_repository->register_method("wayfire/plugin-load-stats", get_plugin_load_stats);
+        method_repository->register_method("wayfire/startup-timeline", get_startup_timeline);
         method_repository->register_method("wayfire/get-keyboard-state", get_kb_state);
         method_repository->register_method("wayfire/set-keyboard-state", set_kb_state);
     }
@@ -55,6 +68,12 @@ class ipc_rules_utility_methods_t
         method_repository->unregister_method("wayfire/reload-config-metadata");
         method_repository->unregister_method("wayfire/reload-plugins");
         method_repository->unregister_method("wayfire/render-metrics");
+        method_repository->unregister_method("wayfire/buffer-memory");
+        method_repository->unregister_method("wayfire/frame-pacing");
+        method_repository->unregister_method("wayfire/pointer-motion-stats");
+        method_repository->unregister_method("wayfire/promotion-stats");
+        method_repository->unregister_method("wayfire/plugin-load-stats");
+        method_repository->unregister_method("wayfire/startup-timeline");
         method_repository->unregister_method("wayfire/get-keyboard-state");
         method_repository->unregister_method("wayfire/set-keyboard-state");
     }
@@ -222,6 +241,205 @@ class ipc_rules_utility_methods_t
         return response;
     };
 
+    wf::ipc::method_callback get_buffer_memory = [=] (const wf::json_t&)
+    {
+        const auto stats = wf::get_buffer_memory_stats();
+        auto response    = wf::ipc::json_ok();
+        response["total-bytes"]     = stats.total_bytes;
+        response["peak-bytes"]      = stats.peak_bytes;
+        response["total-buffers"]   = stats.total_buffers;
+        response["budget-bytes"]    = stats.budget_bytes;
+        response["pressure-events"] = stats.pressure_events;
+
+        wf::json_t owners = wf::json_t::array();
+        for (const auto& owner : stats.owners)
+        {
+            wf::json_t entry;
+            entry["owner"]   = owner.owner;
+            entry["buffers"] = owner.buffers;
+            entry["bytes"]   = owner.bytes;
+            owners.append(entry);
+        }
+
+        response["owners"] = owners;
+
+        const auto pool_stats = wf::get_buffer_pool_stats();
+        wf::json_t pool;
+        pool["hits"]    = pool_stats.hits;
+        pool["misses"]  = pool_stats.misses;
+        pool["trimmed"] = pool_stats.trimmed;
+        pool["pooled-buffers"] = pool_stats.pooled_buffers;
+        pool["pooled-bytes"]   = pool_stats.pooled_bytes;
+        response["pool"] = pool;
+
+        const auto image_stats = image_io::get_cache_stats();
+        wf::json_t image_cache;
+        image_cache["hits"]   = image_stats.hits;
+        image_cache["misses"] = image_stats.misses;
+        image_cache["evictions"]    = image_stats.evictions;
+        image_cache["cached-bytes"] = image_stats.cached_bytes;
+        response["image-cache"]     = image_cache;
+
+#if WF_HAS_VULKANFX
+        if (wf::get_core().is_vulkan())
+        {
+            const auto frame_stats =
+                wf::vulkan_render_state_t::get().get_context()->get_frame_allocator_stats();
+            wf::json_t frame_allocator;
+            frame_allocator["blocks"] = frame_stats.num_blocks;
+            frame_allocator["block-bytes"]     = frame_stats.block_bytes;
+            frame_allocator["in-flight-bytes"] = frame_stats.in_flight_bytes;
+            frame_allocator["peak-frame-bytes"]  = frame_stats.peak_frame_bytes;
+            frame_allocator["allocations"]       = frame_stats.allocations;
+            frame_allocator["block-allocations"] = frame_stats.block_allocations;
+            response["vulkan-frame-allocator"]   = frame_allocator;
+        }
+
+#endif
+        return response;
+    };
+
+    static wf::scene::wlr_surface_node_t *find_surface_node(wf::scene::node_t *root, wlr_surface *surface)
+    {
+        auto node = dynamic_cast<wf::scene::wlr_surface_node_t*>(root);
+        if (node && (node->get_surface() == surface))
+        {
+            return node;
+        }
+
+        for (auto& child : root->get_children())
+        {
+            if (auto found = find_surface_node(child.get(), surface))
+            {
+                return found;
+            }
+        }
+
+        return nullptr;
+    }
+
+    wf::ipc::method_callback get_frame_pacing = [=] (const wf::json_t&)
+    {
+        // Frame callbacks are requested per client, so the measured rates of all views of a client are
+        // reported together.
+        struct client_entry_t
+        {
+            wf::json_t views = wf::json_t::array();
+            std::string app_id;
+            pid_t pid   = 0;
+            double rate = 0.0;
+        };
+
+        std::vector<wl_client*> order;
+        std::map<wl_client*, client_entry_t> clients;
+        for (auto& view : wf::get_core().get_all_views())
+        {
+            auto surface = view->get_wlr_surface();
+            auto node    = surface ? find_surface_node(view->get_surface_root_node().get(), surface) : nullptr;
+            if (!node || !view->get_client())
+            {
+                continue;
+            }
+
+            if (!clients.count(view->get_client()))
+            {
+                order.push_back(view->get_client());
+                clients[view->get_client()].app_id = view->get_app_id();
+                wl_client_get_credentials(view->get_client(), &clients[view->get_client()].pid, 0, 0);
+            }
+
+            auto& client = clients[view->get_client()];
+            const double rate = node->get_frame_callback_rate();
+            wf::json_t entry;
+            entry["id"] = view->get_id();
+            entry["frame-callback-rate"] = rate;
+            entry["limit-reason"] = node->get_frame_pacing().reason;
+            client.views.append(entry);
+            client.rate += rate;
+        }
+
+        wf::json_t result = wf::json_t::array();
+        for (auto& key : order)
+        {
+            auto& client = clients[key];
+            wf::json_t entry;
+            entry["pid"]    = client.pid;
+            entry["app-id"] = client.app_id;
+            entry["frame-callback-rate"] = client.rate;
+            entry["views"] = client.views;
+            result.append(entry);
+        }
+
+        auto response = wf::ipc::json_ok();
+        response["clients"] = result;
+
+        return response;
+    };
+
+    wf::ipc::method_callback get_pointer_motion_stats = [=] (const wf::json_t&)
+    {
+        const auto stats = wf::get_core().seat->get_pointer_motion_stats();
+        auto response    = wf::ipc::json_ok();
+        response["motion-events"]    = stats.motion_events;
+        response["forwarded-events"] = stats.forwarded_events;
+        response["position-updates"] = stats.position_updates;
+        return response;
+    };
+
+    wf::ipc::method_callback get_promotion_stats = [=] (const wf::json_t&)
+    {
+        wf::json_t response = wf::json_t::array();
+        for (auto output : wf::get_core().output_layout->get_outputs())
+        {
+            const auto stats = output->get_promotion_stats();
+            wf::json_t entry;
+            entry["output"]      = output->to_string();
+            entry["events"]      = stats.events;
+            entry["searches"]    = stats.searches;
+            entry["evaluations"] = stats.evaluations;
+            entry["promotions"]  = stats.promotions;
+            response.append(entry);
+        }
+
+        return response;
+    };
+
+    wf::ipc::method_callback get_plugin_load_stats = [=] (const wf::json_t&)
+    {
+        auto response = wf::ipc::json_ok();
+        wf::json_t plugins = wf::json_t::array();
+        for (const auto& stats : wf::get_plugin_load_stats())
+        {
+            wf::json_t entry;
+            entry["name"] = stats.name;
+            entry["load-time-us"] = stats.load_time_us;
+            entry["init-time-us"] = stats.init_time_us;
+            entry["lazy"] = stats.lazy;
+            entry["initialized"] = stats.initialized;
+            plugins.append(entry);
+        }
+
+        response["plugins"] = plugins;
+        return response;
+    };
+
+    wf::ipc::method_callback get_startup_timeline = [=] (const wf::json_t&)
+    {
+        auto response = wf::ipc::json_ok();
+        wf::json_t phases = wf::json_t::array();
+        for (const auto& phase : wf::get_startup_timeline())
+        {
+            wf::json_t entry;
+            entry["name"] = phase.name;
+            entry["start-us"]    = phase.start_us;
+            entry["duration-us"] = phase.duration_us;
+            phases.append(entry);
+        }
+
+        response["phases"] = phases;
+        return response;
+    };
+
     wf::ipc::method_callback create_headless_output = [=] (const wf::json_t& data)
     {
         auto width  = wf::ipc::json_get_uint64(data, "width");
@@ -96,8 +96,16 @@ class headless_input_backend_t
     headless_input_backend_t()
     {
         auto& core = wf::get_core();
-        backend = wlr_headless_backend_create(core.ev_loop);
-        wlr_multi_backend_add(core.backend, backend);
+        if (wlr_backend_is_multi(core.backend))
+        {
+            backend = wlr_headless_backend_create(core.ev_loop);
+            wlr_multi_backend_add(core.backend, backend);
+        } else
+        {
+            /* Core runs directly on a single backend, for example a headless one in tests. Devices announced
+             * on it reach core all the same. */
+            backend = core.backend;
+        }
 
         wlr_pointer_init(&pointer, &pointer_impl, "stipc_pointer");
         wlr_keyboard_init(&keyboard, &keyboard_impl, "stipc_keyboard");
@@ -112,7 +120,7 @@ class headless_input_backend_t
         wl_signal_emit_mutable(&backend->events.new_input, &tablet.base);
         wl_signal_emit_mutable(&backend->events.new_input, &tablet_pad.base);
 
-        if (core.get_current_state() >= compositor_state_t::RUNNING)
+        if ((backend != core.backend) && (core.get_current_state() >= compositor_state_t::RUNNING))
         {
             wlr_backend_start(backend);
         }
@@ -128,8 +136,11 @@ class headless_input_backend_t
         wlr_touch_finish(&touch);
         wlr_tablet_finish(&tablet);
         wlr_tablet_pad_finish(&tablet_pad);
-        wlr_multi_backend_remove(core.backend, backend);
-        wlr_backend_destroy(backend);
+        if (backend != core.backend)
+        {
+            wlr_multi_backend_remove(core.backend, backend);
+            wlr_backend_destroy(backend);
+        }
     }
 
     void do_key(uint32_t key, wl_keyboard_key_state state)
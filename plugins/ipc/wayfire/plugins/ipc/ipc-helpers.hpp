@@ -4,6 +4,7 @@
 #include "wayfire/geometry.hpp"
 #include <wayfire/output.hpp>
 #include <wayfire/view.hpp>
+#include <wayfire/view-registry.hpp>
 #include <wayfire/workspace-set.hpp>
 #include <wayfire/core.hpp>
 #include <wayfire/output-layout.hpp>
@@ -102,15 +103,7 @@ inline uint64_t json_get_view_id(const wf::json_t& data, bool support_shorthand
 
 inline wayfire_view find_view_by_id(uint32_t id)
 {
-    for (auto view : wf::get_core().get_all_views())
-    {
-        if (view->get_id() == id)
-        {
-            return view;
-        }
-    }
-
-    return nullptr;
+    return wf::view_registry_t::get().find_by_id(id);
 }
 
 inline wayfire_view json_find_view_or_throw(const wf::json_t& data)
@@ -3,6 +3,8 @@
 #include <functional>
 #include <map>
 #include "wayfire/signal-provider.hpp"
+#include "wayfire/signal-definitions.hpp"
+#include <wayfire/core.hpp>
 #include <wayfire/nonstd/json.hpp>
 #include <string>
 
@@ -97,6 +99,17 @@ class method_repository_t : public wf::signal::provider_t
     wf::json_t call_method(std::string method, json_t data,
         client_interface_t *client = nullptr)
     {
+        // The method may belong to a plugin which is initialized on first use. The plugin's name is one of
+        // the path components of the method, e.g. "alpha" in "wf/alpha/set-view-alpha".
+        for (size_t start = 0, end = method.find('/');
+             !this->methods.count(method) && (end != std::string::npos);
+             start = end + 1, end = method.find('/', start))
+        {
+            wf::lazy_plugin_requested_signal ev;
+            ev.name = method.substr(start, end - start);
+            wf::get_core().emit(&ev);
+        }
+
         if (this->methods.count(method))
         {
             try {
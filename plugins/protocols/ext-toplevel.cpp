@@ -9,6 +9,8 @@
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wayfire/toplevel-view.hpp>
 #include <wayfire/window-manager.hpp>
+#include <wayfire/plugins/ipc/ipc-helpers.hpp>
+#include <wayfire/plugins/ipc/ipc-method-repository.hpp>
 #include "gtk-shell.hpp"
 #include "config.h"
 
@@ -22,25 +24,26 @@ extern "C"
 class wayfire_foreign_toplevel;
 using foreign_toplevel_map_type = std::map<wayfire_toplevel_view, std::unique_ptr<wayfire_foreign_toplevel>>;
 
-void get_state(wayfire_view view, struct wlr_ext_foreign_toplevel_handle_v1_state *state)
-{
-    std::string title_buffer = view->get_title();
-    std::string appid_buffer = get_app_id(view);
-
-    // Update the state
-    state->title  = strdup(title_buffer.c_str());
-    state->app_id = strdup(appid_buffer.c_str());
-}
-
 class wayfire_ext_foreign_toplevel
 {
     wayfire_toplevel_view view;
     wlr_ext_foreign_toplevel_handle_v1 *handle;
+    toplevel_update_stats_t& stats;
+    toplevel_update_batch_t updates;
+    std::string sent_title;
+    std::string sent_app_id;
 
   public:
-    wayfire_ext_foreign_toplevel(wayfire_toplevel_view view, wlr_ext_foreign_toplevel_handle_v1 *hndl) :
+    wayfire_ext_foreign_toplevel(wayfire_toplevel_view view, wlr_ext_foreign_toplevel_handle_v1 *hndl,
+        toplevel_update_stats_t& stats) :
         view(view),
-        handle(hndl)
+        handle(hndl),
+        stats(stats),
+        updates(stats, [=] (uint32_t)
+        {
+            // Title, app_id and done
+            return toplevel_send_state() ? 3 : 0;
+        })
     {
         /**
          * This is future-proofing.
@@ -98,25 +101,38 @@ class wayfire_ext_foreign_toplevel
         wlr_ext_foreign_toplevel_handle_v1_destroy(handle);
     }
 
-    virtual void toplevel_send_state()
+    /** @return Whether the state was sent. */
+    virtual bool toplevel_send_state()
     {
-        // Prepare the state
+        std::string title  = view->get_title();
+        std::string app_id = get_app_id(view);
+        if ((title == sent_title) && (app_id == sent_app_id))
+        {
+            return false;
+        }
+
+        sent_title  = title;
+        sent_app_id = app_id;
+
         struct wlr_ext_foreign_toplevel_handle_v1_state new_state;
-        get_state(view, &new_state);
+        new_state.title  = sent_title.c_str();
+        new_state.app_id = sent_app_id.c_str();
 
         /** Send the state; done() is sent by wlroots */
         wlr_ext_foreign_toplevel_handle_v1_update_state(handle,
             &new_state);
+        return true;
     }
 
+    // The title and the app_id are always sent together.
     wf::signal::connection_t<wf::view_title_changed_signal> on_title_changed = [=] (auto)
     {
-        toplevel_send_state();
+        updates.schedule(TOPLEVEL_UPDATE_TITLE | TOPLEVEL_UPDATE_APP_ID);
     };
 
     wf::signal::connection_t<wf::view_app_id_changed_signal> on_app_id_changed = [=] (auto)
     {
-        toplevel_send_state();
+        updates.schedule(TOPLEVEL_UPDATE_TITLE | TOPLEVEL_UPDATE_APP_ID);
     };
 };
 
@@ -134,6 +150,7 @@ class wayfire_ext_foreign_toplevel_protocol_impl : public wf::plugin_interface_t
 
         wf::get_core().connect(&on_view_mapped);
         wf::get_core().connect(&on_view_unmapped);
+        ipc_repo->register_method("wf/ext-toplevel/update-stats", ipc_get_update_stats);
 
         for (auto& view : wf::get_core().get_all_views())
         {
@@ -147,6 +164,7 @@ class wayfire_ext_foreign_toplevel_protocol_impl : public wf::plugin_interface_t
     {
         // Clear the toplevel handle pointers.
         handle_for_view.clear();
+        ipc_repo->unregister_method("wf/ext-toplevel/update-stats");
 
         // toplevel_manager will be cleared by wlroots.
     }
@@ -161,8 +179,12 @@ class wayfire_ext_foreign_toplevel_protocol_impl : public wf::plugin_interface_t
     {
         if (auto toplevel = wf::toplevel_cast(ev->view))
         {
+            std::string title  = toplevel->get_title();
+            std::string app_id = get_app_id(toplevel);
+
             struct wlr_ext_foreign_toplevel_handle_v1_state new_state;
-            get_state(toplevel, &new_state);
+            new_state.title  = title.c_str();
+            new_state.app_id = app_id.c_str();
 
             auto handle = wlr_ext_foreign_toplevel_handle_v1_create(toplevel_manager, &new_state);
             if (!handle)
@@ -171,7 +193,8 @@ class wayfire_ext_foreign_toplevel_protocol_impl : public wf::plugin_interface_t
                 return;
             }
 
-            handle_for_view[toplevel] = std::make_unique<wayfire_ext_foreign_toplevel>(toplevel, handle);
+            handle_for_view[toplevel] =
+                std::make_unique<wayfire_ext_foreign_toplevel>(toplevel, handle, stats);
             handle->data = ev->view.get();
         }
     };
@@ -181,8 +204,19 @@ class wayfire_ext_foreign_toplevel_protocol_impl : public wf::plugin_interface_t
         handle_for_view.erase(toplevel_cast(ev->view));
     };
 
+    wf::ipc::method_callback ipc_get_update_stats = [=] (const wf::json_t&)
+    {
+        auto response = wf::ipc::json_ok();
+        response["changes"] = stats.changes;
+        response["batches"] = stats.batches;
+        response["saved-events"] = stats.saved_events;
+        return response;
+    };
+
     wlr_ext_foreign_toplevel_list_v1 *toplevel_manager;
     std::map<wayfire_toplevel_view, std::unique_ptr<wayfire_ext_foreign_toplevel>> handle_for_view;
+    toplevel_update_stats_t stats;
+    wf::shared_data::ref_ptr_t<wf::ipc::method_repository_t> ipc_repo;
 };
 
 DECLARE_WAYFIRE_PLUGIN(wayfire_ext_foreign_toplevel_protocol_impl);
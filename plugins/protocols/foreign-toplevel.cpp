@@ -9,6 +9,8 @@
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wayfire/toplevel-view.hpp>
 #include <wayfire/window-manager.hpp>
+#include <wayfire/plugins/ipc/ipc-helpers.hpp>
+#include <wayfire/plugins/ipc/ipc-method-repository.hpp>
 #include "gtk-shell.hpp"
 #include "config.h"
 
@@ -22,10 +24,15 @@ class wayfire_foreign_toplevel
     wayfire_toplevel_view view;
     wlr_foreign_toplevel_handle_v1 *handle;
     foreign_toplevel_map_type *view_to_toplevel;
+    toplevel_update_stats_t& stats;
+    toplevel_update_batch_t updates;
+    std::string sent_title;
+    std::string sent_app_id;
 
   public:
     wayfire_foreign_toplevel(wayfire_toplevel_view view, wlr_foreign_toplevel_handle_v1 *handle,
-        foreign_toplevel_map_type *view_to_toplevel)
+        foreign_toplevel_map_type *view_to_toplevel, toplevel_update_stats_t& stats) :
+        stats(stats), updates(stats, [=] (uint32_t parts) { return send_updates(parts); })
     {
         this->view   = view;
         this->handle = handle;
@@ -67,16 +74,59 @@ class wayfire_foreign_toplevel
     }
 
   private:
-    void toplevel_send_title()
+    /** @return Whether the title was sent. */
+    bool toplevel_send_title()
     {
-        wlr_foreign_toplevel_handle_v1_set_title(handle, view->get_title().c_str());
+        auto title = view->get_title();
+        if ((title == sent_title) && !sent_title.empty())
+        {
+            return false;
+        }
+
+        sent_title = title;
+        wlr_foreign_toplevel_handle_v1_set_title(handle, title.c_str());
+        return true;
     }
 
-    void toplevel_send_app_id()
+    /** @return Whether the app id was sent. */
+    bool toplevel_send_app_id()
     {
         std::string app_id = get_app_id(view);
+        if ((app_id == sent_app_id) && !sent_app_id.empty())
+        {
+            return false;
+        }
 
+        sent_app_id = app_id;
         wlr_foreign_toplevel_handle_v1_set_app_id(handle, app_id.c_str());
+        return true;
+    }
+
+    /**
+     * Send the parts of the state which changed since the last batch, wlroots sends done afterwards.
+     * @return The number of events sent, counting the state as a single event.
+     */
+    uint32_t send_updates(uint32_t parts)
+    {
+        uint32_t sent = 0;
+        if ((parts & TOPLEVEL_UPDATE_TITLE) && toplevel_send_title())
+        {
+            sent++;
+        }
+
+        if ((parts & TOPLEVEL_UPDATE_APP_ID) && toplevel_send_app_id())
+        {
+            sent++;
+        }
+
+        if (parts & TOPLEVEL_UPDATE_STATE)
+        {
+            toplevel_send_state();
+            sent++;
+        }
+
+        // The done event
+        return sent ? sent + 1 : 0;
     }
 
     void toplevel_send_state()
@@ -100,6 +150,8 @@ class wayfire_foreign_toplevel
 
     void toplevel_update_output(wf::output_t *output, bool enter)
     {
+        // Keep the order of events as the client would have seen it without batching.
+        updates.flush();
         if (output && enter)
         {
             wlr_foreign_toplevel_handle_v1_output_enter(handle, output->handle);
@@ -113,12 +165,12 @@ class wayfire_foreign_toplevel
 
     wf::signal::connection_t<wf::view_title_changed_signal> on_title_changed = [=] (auto)
     {
-        toplevel_send_title();
+        updates.schedule(TOPLEVEL_UPDATE_TITLE);
     };
 
     wf::signal::connection_t<wf::view_app_id_changed_signal> on_app_id_changed = [=] (auto)
     {
-        toplevel_send_app_id();
+        updates.schedule(TOPLEVEL_UPDATE_APP_ID);
     };
 
     wf::signal::connection_t<wf::view_set_output_signal> on_set_output = [=] (wf::view_set_output_signal *ev)
@@ -129,27 +181,27 @@ class wayfire_foreign_toplevel
 
     wf::signal::connection_t<wf::view_minimized_signal> on_minimized = [=] (auto)
     {
-        toplevel_send_state();
+        updates.schedule(TOPLEVEL_UPDATE_STATE);
     };
 
     wf::signal::connection_t<wf::view_fullscreen_signal> on_fullscreen = [=] (auto)
     {
-        toplevel_send_state();
+        updates.schedule(TOPLEVEL_UPDATE_STATE);
     };
 
     wf::signal::connection_t<wf::view_tiled_signal> on_tiled = [=] (auto)
     {
-        toplevel_send_state();
+        updates.schedule(TOPLEVEL_UPDATE_STATE);
     };
 
     wf::signal::connection_t<wf::view_activated_state_signal> on_activated = [=] (auto)
     {
-        toplevel_send_state();
+        updates.schedule(TOPLEVEL_UPDATE_STATE);
     };
 
     wf::signal::connection_t<wf::view_parent_changed_signal> on_parent_changed = [=] (auto)
     {
-        toplevel_send_state();
+        updates.schedule(TOPLEVEL_UPDATE_STATE);
     };
 
     wf::wl_listener_wrapper toplevel_handle_v1_maximize_request;
@@ -230,10 +282,13 @@ class wayfire_foreign_toplevel_protocol_impl : public wf::plugin_interface_t
         toplevel_manager = wlr_foreign_toplevel_manager_v1_create(wf::get_core().display);
         wf::get_core().connect(&on_view_mapped);
         wf::get_core().connect(&on_view_unmapped);
+        ipc_repo->register_method("wf/foreign-toplevel/update-stats", ipc_get_update_stats);
     }
 
     void fini() override
-    {}
+    {
+        ipc_repo->unregister_method("wf/foreign-toplevel/update-stats");
+    }
 
     bool is_unloadable() override
     {
@@ -247,7 +302,7 @@ class wayfire_foreign_toplevel_protocol_impl : public wf::plugin_interface_t
         {
             auto handle = wlr_foreign_toplevel_handle_v1_create(toplevel_manager);
             handle_for_view[toplevel] =
-                std::make_unique<wayfire_foreign_toplevel>(toplevel, handle, &handle_for_view);
+                std::make_unique<wayfire_foreign_toplevel>(toplevel, handle, &handle_for_view, stats);
         }
     };
 
@@ -256,8 +311,19 @@ class wayfire_foreign_toplevel_protocol_impl : public wf::plugin_interface_t
         handle_for_view.erase(toplevel_cast(ev->view));
     };
 
+    wf::ipc::method_callback ipc_get_update_stats = [=] (const wf::json_t&)
+    {
+        auto response = wf::ipc::json_ok();
+        response["changes"] = stats.changes;
+        response["batches"] = stats.batches;
+        response["saved-events"] = stats.saved_events;
+        return response;
+    };
+
     wlr_foreign_toplevel_manager_v1 *toplevel_manager;
     std::map<wayfire_toplevel_view, std::unique_ptr<wayfire_foreign_toplevel>> handle_for_view;
+    toplevel_update_stats_t stats;
+    wf::shared_data::ref_ptr_t<wf::ipc::method_repository_t> ipc_repo;
 };
 
 DECLARE_WAYFIRE_PLUGIN(wayfire_foreign_toplevel_protocol_impl);
@@ -3,6 +3,9 @@
 #include "wayfire/view.hpp"
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wayfire/toplevel-view.hpp>
+#include <algorithm>
+#include <bitset>
+#include <functional>
 #include "gtk-shell.hpp"
 
 std::string get_app_id(wayfire_view view)
@@ -45,3 +48,74 @@ std::string get_app_id(wayfire_view view)
     // Safely copy to the output buffer
     return result;
 }
+
+/** Counters for the toplevel updates which were batched instead of being sent right away. */
+struct toplevel_update_stats_t
+{
+    /** Number of view changes which required an update. */
+    uint64_t changes = 0;
+    /** Number of batches sent to clients, each of them followed by a single done event. */
+    uint64_t batches = 0;
+    /**
+     * Number of events (including done) which would have been sent if each change was sent right away, but
+     * were not sent because of batching or because nothing changed.
+     */
+    uint64_t saved_events = 0;
+};
+
+enum toplevel_update_flags_t : uint32_t
+{
+    TOPLEVEL_UPDATE_TITLE  = (1 << 0),
+    TOPLEVEL_UPDATE_APP_ID = (1 << 1),
+    TOPLEVEL_UPDATE_STATE  = (1 << 2),
+};
+
+/**
+ * Collects the changes of a single toplevel and sends them once the event loop goes idle, so that a burst of
+ * changes (for example a client setting its title in a loop) results in a single update for each client.
+ */
+class toplevel_update_batch_t
+{
+  public:
+    /** Sends the given parts and returns the number of events (including done) which were actually sent. */
+    using flush_callback_t = std::function<uint32_t (uint32_t)>;
+
+    toplevel_update_batch_t(toplevel_update_stats_t& stats, flush_callback_t flush) :
+        stats(stats), on_flush(std::move(flush))
+    {}
+
+    /** Schedule an update of the given parts (a combination of toplevel_update_flags_t). */
+    void schedule(uint32_t updates)
+    {
+        stats.changes++;
+        // Sending the change right away would have sent each part and a done event.
+        unbatched_events += 1 + std::bitset<32>(updates).count();
+        pending_updates  |= updates;
+        idle_flush.run_once([=] { flush(); });
+    }
+
+    /** Send the pending updates immediately. */
+    void flush()
+    {
+        idle_flush.disconnect();
+        if (!pending_updates)
+        {
+            return;
+        }
+
+        const uint32_t updates = pending_updates;
+        const uint64_t unbatched = unbatched_events;
+        pending_updates  = 0;
+        unbatched_events = 0;
+        stats.batches++;
+        const uint64_t sent = on_flush(updates);
+        stats.saved_events += unbatched - std::min(sent, unbatched);
+    }
+
+  private:
+    toplevel_update_stats_t& stats;
+    flush_callback_t on_flush;
+    uint32_t pending_updates  = 0;
+    uint64_t unbatched_events = 0;
+    wf::wl_idle_call idle_flush;
+};
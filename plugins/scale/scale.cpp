@@ -8,7 +8,7 @@
 #include <wayfire/seat.hpp>
 #include <wayfire/per-output-plugin.hpp>
 #include <wayfire/output.hpp>
-#include <wayfire/util/duration.hpp>
+#include <wayfire/frame-animation.hpp>
 #include <wayfire/view-transform.hpp>
 #include <wayfire/render-manager.hpp>
 #include <wayfire/workspace-set.hpp>
@@ -41,14 +41,14 @@
 static constexpr const char *SCALE_TRANSFORMER = "scale";
 using namespace wf::animation;
 
-class scale_animation_t : public duration_t
+class scale_animation_t : public frame_duration_t
 {
   public:
-    using duration_t::duration_t;
-    timed_transition_t scale_x{*this};
-    timed_transition_t scale_y{*this};
-    timed_transition_t translation_x{*this};
-    timed_transition_t translation_y{*this};
+    using frame_duration_t::frame_duration_t;
+    frame_transition_t scale_x{*this};
+    frame_transition_t scale_y{*this};
+    frame_transition_t translation_x{*this};
+    frame_transition_t translation_y{*this};
 };
 
 struct wf_scale_animation_attribs
@@ -61,7 +61,7 @@ struct view_scale_data
 {
     int row, col;
     std::shared_ptr<wf::scene::view_2d_transformer_t> transformer;
-    wf::animation::simple_animation_t fade_animation;
+    wf::animation::simple_frame_animation_t fade_animation;
     wf_scale_animation_attribs animation;
     enum class view_visibility_t
     {
@@ -792,7 +792,7 @@ class wayfire_scale : public wf::per_output_plugin_instance_t,
         view_data.animation.scale_animation.translation_y.set(
             view_data.transformer->translation_y, translation_y);
         view_data.animation.scale_animation.start();
-        view_data.fade_animation = wf::animation::simple_animation_t(
+        view_data.fade_animation = wf::animation::simple_frame_animation_t(
             wf::option_wrapper_t<wf::animation_description_t>{"scale/duration"});
         view_data.fade_animation.animate(view_data.transformer->alpha,
             target_alpha);
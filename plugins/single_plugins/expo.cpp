@@ -2,6 +2,7 @@
 #include "wayfire/plugins/common/util.hpp"
 #include "wayfire/plugins/ipc/ipc-activator.hpp"
 #include "wayfire/render-manager.hpp"
+#include "wayfire/frame-animation.hpp"
 #include "wayfire/scene-input.hpp"
 #include "wayfire/scene.hpp"
 #include "wayfire/signal-definitions.hpp"
@@ -72,7 +73,7 @@ class wayfire_expo : public wf::per_output_plugin_instance_t, public wf::keyboar
     uint32_t key_pressed = 0;
 
     /* fade animations for each workspace */
-    std::vector<std::vector<wf::animation::simple_animation_t>> ws_fade;
+    std::vector<std::vector<wf::animation::simple_frame_animation_t>> ws_fade;
     std::unique_ptr<wf::input_grab_t> input_grab;
 
   public:
@@ -20,7 +20,7 @@ class wayfire_passthrough_screen : public wf::per_output_plugin_instance_t
             return;
         }
 
-        output->render->add_post(&render_hook);
+        output->render->add_post(&render_hook, wf::POST_HOOK_POINTWISE);
 
         vk_renderer = wlr_vk_renderer_create_with_drm_fd(wlr_renderer_get_drm_fd(wf::get_core().renderer));
     }
@@ -63,7 +63,10 @@ class wayfire_passthrough_screen : public wf::per_output_plugin_instance_t
         tex.filter_mode = WLR_SCALE_FILTER_BILINEAR; // Use bilinear filtering for a smooth copy
         tex.transform   = WL_OUTPUT_TRANSFORM_NORMAL;
         tex.alpha = NULL;
-        tex.clip  = NULL;
+
+        // The copy is pointwise, so only the damaged part of the output needs to be updated
+        auto damage = output->render->get_swap_damage();
+        tex.clip = damage.to_pixman();
         wlr_render_pass_add_texture(pass, &tex);
         wlr_render_pass_submit(pass);
         wlr_texture_destroy(vk_tex);
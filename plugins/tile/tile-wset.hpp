@@ -133,7 +133,11 @@ class tile_workspace_set_data_t : public wf::custom_data_t
         update_gaps();
     }
 
-    void update_root_size()
+    /**
+     * Resize the roots to the current workarea. Unless @full_relayout is set, only the subtrees whose
+     * geometry changed or which were invalidated are laid out again.
+     */
+    void update_root_size(bool full_relayout = true)
     {
         auto wo = wset.lock()->get_attached_output();
         wf::geometry_t workarea = wo ? wo->workarea->get_workarea() : tile::default_output_resolution;
@@ -141,6 +145,7 @@ class tile_workspace_set_data_t : public wf::custom_data_t
         wf::geometry_t output_geometry =
             wset.lock()->get_last_output_geometry().value_or(tile::default_output_resolution);
 
+        autocommit_transaction_t tx;
         auto wsize = wset.lock()->get_workspace_grid_size();
         for (int i = 0; i < wsize.width; i++)
         {
@@ -151,7 +156,11 @@ class tile_workspace_set_data_t : public wf::custom_data_t
                 vp_geometry.x += i * output_geometry.width;
                 vp_geometry.y += j * output_geometry.height;
 
-                autocommit_transaction_t tx;
+                if (full_relayout)
+                {
+                    roots[i][j]->invalidate_subtree_layout();
+                }
+
                 roots[i][j]->set_geometry(vp_geometry, tx.tx);
             }
         }
@@ -337,14 +346,22 @@ class tile_workspace_set_data_t : public wf::custom_data_t
     {
         /* Set fullscreen, and trigger resizing of the views (which will commit the view) */
         view->toplevel()->pending().fullscreen = fullscreen;
-        update_root_size();
+        if (auto node = tile::view_node_t::get_node(view))
+        {
+            node->invalidate_layout();
+            update_root_size(false);
+        } else
+        {
+            update_root_size();
+        }
     }
 
     void set_view_maximized(wayfire_toplevel_view view, bool should_maximize)
     {
         auto node = tile::view_node_t::get_node(view);
         node->show_maximized = should_maximize;
-        update_root_size();
+        node->invalidate_layout();
+        update_root_size(false);
     }
 };
 }
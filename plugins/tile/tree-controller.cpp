@@ -324,7 +324,11 @@ void resize_view_controller_t::input_motion()
         vertical_pair.second->set_geometry(g2, tx);
     }
 
-    wf::get_core().tx_manager->schedule_transaction(std::move(tx));
+    if (!tx->get_objects().empty())
+    {
+        wf::get_core().tx_manager->schedule_transaction(std::move(tx));
+    }
+
     this->last_point = input;
 }
 
@@ -24,6 +24,23 @@ void tree_node_t::set_geometry(wf::geometry_t geometry, wf::txn::transaction_upt
     this->geometry = geometry;
 }
 
+void tree_node_t::invalidate_layout()
+{
+    for (tree_node_t *node = this; node; node = node->parent.get())
+    {
+        node->needs_layout = true;
+    }
+}
+
+void tree_node_t::invalidate_subtree_layout()
+{
+    needs_layout = true;
+    for (auto& child : children)
+    {
+        child->invalidate_subtree_layout();
+    }
+}
+
 nonstd::observer_ptr<split_node_t> tree_node_t::as_split_node()
 {
     return nonstd::make_observer(dynamic_cast<split_node_t*>(this));
@@ -92,6 +109,7 @@ int32_t split_node_t::calculate_splittable() const
 
 void split_node_t::recalculate_children(wf::geometry_t available, wf::txn::transaction_uptr& tx)
 {
+    this->needs_layout = false;
     if (this->children.empty())
     {
         return;
@@ -113,8 +131,6 @@ void split_node_t::recalculate_children(wf::geometry_t available, wf::txn::trans
         return (current / old_child_sum) * total_splittable;
     };
 
-    set_gaps(this->gaps);
-
     /* For each child, assign its percentage of the whole. */
     for (auto& child : this->children)
     {
@@ -160,6 +176,8 @@ void split_node_t::add_child(std::unique_ptr<tree_node_t> child, wf::txn::transa
 
     // Set size of the child to make sure it gets properly recalculated later
     child->geometry = get_child_geometry(0, size_new_child);
+    // The child may be a subtree moved from elsewhere, which was laid out for a different geometry
+    child->invalidate_layout();
 
     this->children.emplace(this->children.begin() + index, std::move(child));
 
@@ -189,6 +207,7 @@ std::unique_ptr<tree_node_t> split_node_t::remove_child(
     }
 
     /* Remaining children have the full geometry */
+    set_gaps(this->gaps);
     recalculate_children(this->geometry, tx);
     result->parent = nullptr;
 
@@ -197,12 +216,26 @@ std::unique_ptr<tree_node_t> split_node_t::remove_child(
 
 void split_node_t::set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx)
 {
+    if ((geometry == this->geometry) && !this->needs_layout)
+    {
+        return;
+    }
+
     tree_node_t::set_geometry(geometry, tx);
     recalculate_children(geometry, tx);
 }
 
 void split_node_t::set_gaps(const gap_size_t& gaps)
 {
+    if ((this->gaps.top != gaps.top) ||
+        (this->gaps.bottom != gaps.bottom) ||
+        (this->gaps.left != gaps.left) ||
+        (this->gaps.right != gaps.right) ||
+        (this->gaps.internal != gaps.internal))
+    {
+        invalidate_layout();
+    }
+
     this->gaps = gaps;
     for (const auto& child : this->children)
     {
@@ -368,6 +401,7 @@ void view_node_t::set_gaps(const gap_size_t& size)
         (this->gaps.right != size.right))
     {
         this->gaps = size;
+        invalidate_layout();
     }
 }
 
@@ -481,17 +515,27 @@ static nonstd::observer_ptr<wf::grid::grid_animation_t> ensure_animation(
 void view_node_t::set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx)
 {
     tree_node_t::set_geometry(geometry, tx);
+    this->needs_layout = false;
 
     if (!view->is_mapped())
     {
         return;
     }
 
+    auto target = calculate_target_geometry();
+    auto& pending = view->toplevel()->pending();
+    if ((pending.tiled_edges == TILED_EDGES_ALL) && (pending.geometry == target) &&
+        (pending.fullscreen == view->toplevel()->committed().fullscreen))
+    {
+        // The view already has (or is animating towards) the target state, nothing to configure.
+        // A fullscreen change may leave the geometry unchanged, but it still has to be committed.
+        return;
+    }
+
     wf::get_core().default_wm->update_last_windowed_geometry(view);
-    view->toplevel()->pending().tiled_edges = TILED_EDGES_ALL;
+    pending.tiled_edges = TILED_EDGES_ALL;
     tx->add_object(view->toplevel());
 
-    auto target = calculate_target_geometry();
     if (this->needs_crossfade() && (target != view->get_geometry()))
     {
         view->get_transformed_node()->rem_transformer(scale_transformer_name);
@@ -554,6 +598,7 @@ bool flatten_tree(std::unique_ptr<tree_node_t>& root)
         if (!flatten_tree(*it))
         {
             it = root->children.erase(it);
+            root->invalidate_layout();
         } else
         {
             ++it;
@@ -585,6 +630,8 @@ bool flatten_tree(std::unique_ptr<tree_node_t>& root)
     /* Rewire the tree, skipping the current root */
     child_ptr->parent = root->parent;
     root = std::move(root->children.front());
+    /* The parent has a different child now, and the child gets the geometry of the removed node */
+    root->invalidate_layout();
     return true;
 }
 
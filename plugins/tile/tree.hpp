@@ -48,9 +48,22 @@ struct tree_node_t
     /** The geometry occupied by the node */
     wf::geometry_t geometry;
 
-    /** Set the geometry available for the node and its subnodes. */
+    /**
+     * Set the geometry available for the node and its subnodes.
+     * Subtrees whose available geometry did not change and which were not invalidated are skipped.
+     */
     virtual void set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx);
 
+    /**
+     * Mark the node and its ancestors as needing a relayout on the next set_geometry(), even if their
+     * geometry stays the same. Necessary when anything besides the geometry affects the layout of the node,
+     * for example its gaps or the fullscreen state of a view.
+     */
+    void invalidate_layout();
+
+    /** Mark the node and all of its descendants as needing a relayout. */
+    void invalidate_subtree_layout();
+
     /** Set the gaps for the node and subnodes. */
     virtual void set_gaps(const gap_size_t& gaps) = 0;
 
@@ -70,6 +83,9 @@ struct tree_node_t
   protected:
     /* Gaps */
     gap_size_t gaps;
+
+    /* Whether the layout of the node's subtree has to be recalculated even if its geometry is unchanged */
+    bool needs_layout = true;
 };
 
 /**
@@ -108,6 +124,8 @@ struct split_node_t : public tree_node_t
      * Set the total geometry available to the node. This will recursively
      * resize the children nodes, so that they fit inside the new geometry and
      * have a size proportional to their old size.
+     *
+     * Nothing is done if the geometry is unchanged and the layout was not invalidated.
      */
     void set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx) override;
 
@@ -166,6 +184,8 @@ struct view_node_t : public tree_node_t
      * Note that the resulting view geometry will not always be equal to the
      * geometry of the node. For example, a fullscreen view will always have
      * the geometry of the whole output.
+     *
+     * The view is added to the transaction only if its state actually changes.
      */
     void set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx) override;
 
@@ -10,18 +10,19 @@
 #include "wayfire/unstable/translation-node.hpp"
 #include "wayfire/scene-operations.hpp"
 #include "wayfire/render-manager.hpp"
+#include "wayfire/frame-animation.hpp"
 
 namespace wf
 {
 namespace vswitch
 {
 using namespace animation;
-class workspace_animation_t : public duration_t
+class workspace_animation_t : public frame_duration_t
 {
   public:
-    using duration_t::duration_t;
-    timed_transition_t dx{*this};
-    timed_transition_t dy{*this};
+    using frame_duration_t::frame_duration_t;
+    frame_transition_t dx{*this};
+    frame_transition_t dy{*this};
 };
 
 /**
@@ -1,4 +1,6 @@
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <wayfire/per-output-plugin.hpp>
@@ -105,10 +107,16 @@ class wayfire_window_rules_t : public wf::per_output_plugin_instance_t
     // Auto-reload on changes to config file
     wf::signal::connection_t<wf::reload_config_signal> _reload_config = [=] (wf::reload_config_signal *ev)
     {
-        setup_rules_from_config();
+        if (ev->section_changed("window-rules"))
+        {
+            setup_rules_from_config();
+        }
     };
 
     std::vector<std::shared_ptr<wf::rule_t>> _rules;
+    // Parsed rules by their source text, so that unchanged rules are not parsed again on reload.
+    // Rules which failed to parse are stored as nullptr.
+    std::map<std::string, std::shared_ptr<wf::rule_t>> _parsed_rules;
 
     wf::view_access_interface_t _access_interface;
     wf::view_action_interface_t _action_interface;
@@ -232,16 +240,29 @@ void wayfire_window_rules_t::setup_rules_from_config()
     wf::option_wrapper_t<wf::config::compound_list_t<std::string>> rule_list_option{"window-rules/rules"};
     auto rule_list = rule_list_option.value();
 
+    std::map<std::string, std::shared_ptr<wf::rule_t>> parsed_rules;
     for (const auto& [name, rule_str] : rule_list)
     {
-        LOGD("Registering ", rule_str);
-        _lexer.reset(rule_str);
-        auto rule = wf::rule_parser_t().parse(_lexer);
+        auto it = _parsed_rules.find(rule_str);
+        std::shared_ptr<wf::rule_t> rule;
+        if (it != _parsed_rules.end())
+        {
+            rule = it->second;
+        } else
+        {
+            LOGD("Registering ", rule_str);
+            _lexer.reset(rule_str);
+            rule = wf::rule_parser_t().parse(_lexer);
+        }
+
+        parsed_rules[rule_str] = rule;
         if (rule != nullptr)
         {
             _rules.push_back(rule);
         }
     }
+
+    _parsed_rules = std::move(parsed_rules);
 }
 
 DECLARE_WAYFIRE_PLUGIN(wf::per_output_plugin_t<wayfire_window_rules_t>);
@@ -611,10 +611,6 @@ class wobbly_transformer_node_t : public wf::scene::transformer_base_node_t
 
     OpenGL::program_t *wobbly_program;
 
-#if WF_HAS_VULKANFX
-    std::array<std::shared_ptr<wf::vk::gpu_buffer_t>, 4> vulkan_vertex_buffer;
-#endif
-
   private:
     wayfire_toplevel_view view;
 
@@ -693,7 +689,10 @@ class wobbly_transformer_node_t : public wf::scene::transformer_base_node_t
     }
 
   public:
-    void update_model()
+    /**
+     * Advance the model to the given time in milliseconds.
+     */
+    void update_model(int64_t now)
     {
         view->damage();
 
@@ -704,8 +703,6 @@ class wobbly_transformer_node_t : public wf::scene::transformer_base_node_t
         view->connect(&on_view_geometry_changed);
 
         /* Update all the wobbly model */
-        auto now = wf::get_current_time();
-
         if (now > last_frame)
         {
             view->get_transformed_node()->begin_transform_update();
@@ -873,7 +870,7 @@ class wobbly_render_instance_t :
     public wf::scene::transformer_render_instance_t<wobbly_transformer_node_t>
 {
     wf::output_t *wo = nullptr;
-    wf::effect_hook_t pre_hook;
+    wf::animation_hook_t pre_hook;
 
   public:
     wobbly_render_instance_t(wobbly_transformer_node_t *self, wf::scene::damage_callback push_damage,
@@ -882,8 +879,13 @@ class wobbly_render_instance_t :
         if (shown_on)
         {
             wo = shown_on;
-            pre_hook = [=] () { self->update_model(); };
-            wo->render->add_effect(&pre_hook, wf::OUTPUT_EFFECT_PRE);
+            // The model runs until the transformer removes itself, which also destroys this instance.
+            pre_hook = [=] (int64_t presentation_ns)
+            {
+                self->update_model(presentation_ns / 1'000'000);
+                return true;
+            };
+            wo->render->add_animation(&pre_hook);
         }
     }
 
@@ -891,7 +893,7 @@ class wobbly_render_instance_t :
     {
         if (wo)
         {
-            wo->render->rem_effect(&pre_hook);
+            wo->render->rem_animation(&pre_hook);
         }
     }
 
@@ -968,25 +970,6 @@ class wobbly_render_instance_t :
         return *ptr;
     }
 
-    std::shared_ptr<wf::vk::gpu_buffer_t> find_buffer(
-        std::shared_ptr<wf::vk::context_t> ctx, VkDeviceSize total_size)
-    {
-        auto& buffers = self->vulkan_vertex_buffer;
-        for (size_t i = 0; i < buffers.size(); i++)
-        {
-            auto& buffer = buffers[i];
-            // Try to reuse the vertex buffer if possible, to avoid reallocations.
-            if (buffer && (buffer->get_size() >= total_size) && (buffer.use_count() == 1))
-            {
-                return buffers[i];
-            }
-        }
-
-        buffers[0] = ctx->create_buffer(total_size,
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-        return buffers[0];
-    }
-
 #endif
 
     void render(const wf::scene::render_instruction_t& data) override
@@ -1015,19 +998,22 @@ class wobbly_render_instance_t :
         {
             auto& our_state = ensure_vk(state);
 
-            std::vector<float> unified_buffer;
-            for (size_t i = 0; i < vert.size() / 2; i++)
+            // Interleave positions and texture coordinates directly into the per-frame vertex memory.
+            const size_t num_vertices = vert.size() / 2;
+            auto vertices = cmd_buf.allocate(num_vertices * 4 * sizeof(float));
+            if (!vertices.data)
             {
-                unified_buffer.push_back(vert[2 * i]);
-                unified_buffer.push_back(vert[2 * i + 1]);
-                unified_buffer.push_back(uv[2 * i]);
-                unified_buffer.push_back(uv[2 * i + 1]);
+                return;
             }
 
-            VkDeviceSize total_size = unified_buffer.size() * sizeof(float);
-
-            auto buffer = find_buffer(state.get_context(), total_size);
-            buffer->write(unified_buffer.data(), total_size);
+            float *unified_buffer = static_cast<float*>(vertices.data);
+            for (size_t i = 0; i < num_vertices; i++)
+            {
+                unified_buffer[4 * i]     = vert[2 * i];
+                unified_buffer[4 * i + 1] = vert[2 * i + 1];
+                unified_buffer[4 * i + 2] = uv[2 * i];
+                unified_buffer[4 * i + 3] = uv[2 * i + 1];
+            }
 
             auto texture  = get_texture(data.target.scale);
             auto tex_dset = state.get_descriptor_pool()->get_descriptor_set(cmd_buf, texture);
@@ -1050,9 +1036,7 @@ class wobbly_render_instance_t :
             vkCmdPushConstants(cmd_buf, layout, VK_SHADER_STAGE_VERTEX_BIT,
                 0, sizeof(vulkan_push_constants_t), &push_constants);
 
-            cmd_buf.bind_buffer(buffer);
-            VkDeviceSize offset = 0;
-            vkCmdBindVertexBuffers(cmd_buf, 0, 1, &buffer->get_buffer(), &offset);
+            vkCmdBindVertexBuffers(cmd_buf, 0, 1, &vertices.buffer, &vertices.offset);
 
             cmd_buf.for_each_scissor_rect(data.target, (data.damage & data.target.geometry), [&]
             {
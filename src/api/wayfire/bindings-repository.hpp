@@ -2,6 +2,7 @@
 
 #include <any>
 #include <memory>
+#include <vector>
 #include <wayfire/bindings.hpp>
 #include <wayfire/config/option-wrapper.hpp>
 #include <wayfire/config/types.hpp>
@@ -94,6 +95,24 @@ class bindings_repository_t
     bool handle_extension_generic(std::function<bool(const std::any& stored_tag)> callback,
         const wf::activator_data_t& data);
 
+    /**
+     * Run the callbacks of all bindings which are activated by the given option, as if it was triggered.
+     * This allows a binding to forward its event to other bindings of the same option, for example to
+     * bindings which were registered while the event was being handled.
+     *
+     * @param skip Callbacks which should not be run.
+     *
+     * @return true if any of the callbacks consume the event.
+     */
+    bool call_key_bindings(const option_sptr_t<keybinding_t>& key, const wf::keybinding_t& pressed,
+        const std::vector<void*>& skip = {});
+    bool call_axis_bindings(const option_sptr_t<keybinding_t>& axis, wlr_pointer_axis_event *ev,
+        const std::vector<void*>& skip = {});
+    bool call_button_bindings(const option_sptr_t<buttonbinding_t>& button,
+        const wf::buttonbinding_t& pressed, const std::vector<void*>& skip = {});
+    bool call_activator_bindings(const option_sptr_t<activatorbinding_t>& activator,
+        const wf::activator_data_t& data, const std::vector<void*>& skip = {});
+
     /** Erase binding of any type by callback */
     void rem_binding(void *callback);
 
@@ -3,9 +3,13 @@
 #include <wayfire/config/config-manager.hpp>
 #include <wayland-server-core.h>
 #include <wayfire/nonstd/wlroots.hpp>
+#include <map>
+#include <string>
 
 namespace wf
 {
+struct reload_config_signal;
+
 /**
  * A base class for configuration backend plugins.
  *
@@ -66,6 +70,20 @@ class config_backend_t
   protected:
     /** A helper to read the XML directories that Wayfire looks at */
     virtual std::vector<std::string> get_xml_dirs() const;
+
+    /** The string values of all options, indexed by section and option name. */
+    using config_snapshot_t = std::map<std::string, std::map<std::string, std::string>>;
+
+    /** Record the current values of all options in @config. */
+    static config_snapshot_t take_config_snapshot(const config::config_manager_t& config);
+
+    /**
+     * Compare @before with the current state of @config and store the changed sections and options in @ev.
+     *
+     * @return Whether anything changed.
+     */
+    static bool diff_config_snapshot(const config_snapshot_t& before,
+        const config::config_manager_t& config, reload_config_signal& ev);
 };
 }
 
@@ -21,6 +21,7 @@ class toplevel_view_interface_t;
 class window_manager_t;
 class workspace_set_t;
 class config_backend_t;
+class task_pool_t;
 
 namespace scene
 {
@@ -158,6 +159,11 @@ class compositor_core_t : public wf::object_base_t, public signal::provider_t
     std::unique_ptr<wf::txn::transaction_manager_t> tx_manager;
     std::unique_ptr<wf::window_manager_t> default_wm;
 
+    /**
+     * The shared worker thread pool, see task-pool.hpp.
+     */
+    std::unique_ptr<wf::task_pool_t> task_pool;
+
     /**
      * Various protocols supported by wlroots
      */
@@ -304,7 +310,8 @@ class compositor_core_t : public wf::object_base_t, public signal::provider_t
         nonstd::observer_ptr<wf::touch::gesture_t> gesture) = 0;
 
     /**
-     * @deprecated. Use tracking_allocator_t<view_interface_t>::get_all()
+     * @deprecated. Use view_registry_t::get_all(), or one of the view_registry_t indexes to find views with
+     *   a given app-id, output, workspace set or role.
      *
      * @return A list of all views core manages, regardless of their output,
      *  properties, etc.
@@ -423,6 +430,23 @@ inline void move_view_to_output(wayfire_toplevel_view v, wf::output_t *new_outpu
  */
 void start_move_view_to_wset(wayfire_toplevel_view v, std::shared_ptr<wf::workspace_set_t> new_wset);
 
+/** A single step of compositor startup, see get_startup_timeline(). */
+struct startup_phase_t
+{
+    std::string name;
+    /** When the phase started, relative to process start. */
+    int64_t start_us = 0;
+    /** How long the phase took, or -1 if it is still running. Markers have a duration of zero. */
+    int64_t duration_us = 0;
+};
+
+/**
+ * Get the phases of compositor startup in the order in which they were started: backend creation, renderer
+ * and config initialization, core initialization, Xwayland spawn, plugin loading and the first output commit.
+ * Phases may be nested, for example Xwayland is spawned during core initialization.
+ */
+std::vector<startup_phase_t> get_startup_timeline();
+
 /**
  * Simply a convenience function to call wf::compositor_core_t::get()
  */
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <wayfire/config/types.hpp>
+#include <wayfire/config/option.hpp>
+#include <wayfire/util/duration.hpp>
+
+namespace wf
+{
+namespace animation
+{
+/**
+ * The time at which animations are sampled, in CLOCK_MONOTONIC nanoseconds.
+ *
+ * While an output is being repainted, this is the predicted presentation time of the frame being built, see
+ * render_manager::get_frame_presentation_time_ns(). Otherwise, it is the current time.
+ */
+int64_t get_frame_time_ns();
+
+/**
+ * A drop-in replacement for wf::animation::duration_t which is timed by get_frame_time_ns() instead of the
+ * wall clock, so that each frame shows the state of the animation at the time the frame is presented.
+ *
+ * Copies share their state, and frame_transition_t objects follow the duration they were created with.
+ */
+class frame_duration_t
+{
+  public:
+    /**
+     * @param length The length and easing of the animation. Without a length, the animation is always
+     *   finished.
+     * @param smooth The easing to use if the option does not specify one.
+     */
+    frame_duration_t(std::shared_ptr<config::option_t<animation_description_t>> length = nullptr,
+        smoothing::smooth_function smooth = smoothing::circle);
+
+    /** Start the animation at the current frame time. */
+    void start();
+
+    /** @return The eased progress in [0, 1] at the current frame time. */
+    double progress() const;
+
+    /** @return The eased progress in [0, 1] at the given time in CLOCK_MONOTONIC nanoseconds. */
+    double progress_at(int64_t time_ns) const;
+
+    /** @return Whether the animation has been started and has not reached its end at the current frame time. */
+    bool running();
+
+    /** Run the animation backwards from its current progress. */
+    void reverse();
+
+    /** @return 1 if the animation runs forwards, 0 if it has been reversed. */
+    int get_direction();
+
+    struct state_t;
+
+  protected:
+    std::shared_ptr<state_t> priv;
+    friend class frame_transition_t;
+};
+
+/**
+ * A drop-in replacement for wf::animation::timed_transition_t, driven by a frame_duration_t.
+ */
+class frame_transition_t
+{
+  public:
+    frame_transition_t(const frame_duration_t& duration, double start = 0, double end = 0);
+
+    /** Set the start to the current value and the end to @new_end. */
+    void restart_with_end(double new_end);
+
+    /** Set the start to the current value, keeping the end. */
+    void restart_same_end();
+
+    void set(double start, double end);
+
+    /** Swap the start and the end. */
+    void flip();
+
+    /** @return The value at the current progress of the duration. */
+    operator double() const;
+
+    double start = 0;
+    double end   = 0;
+
+  private:
+    std::shared_ptr<const frame_duration_t::state_t> duration;
+};
+
+/**
+ * A drop-in replacement for wf::animation::simple_animation_t: a single value animated over a
+ * frame_duration_t.
+ */
+class simple_frame_animation_t : public frame_duration_t, public frame_transition_t
+{
+  public:
+    simple_frame_animation_t(std::shared_ptr<config::option_t<animation_description_t>> length = nullptr,
+        smoothing::smooth_function smooth = smoothing::circle);
+
+    /** Animate from @start to @end. */
+    void animate(double start, double end);
+
+    /** Animate from the current value to @end. */
+    void animate(double end);
+
+    /** Animate from the current value to the current end. */
+    void animate();
+};
+}
+}
@@ -2,7 +2,11 @@
 #define IMG_HPP_
 
 #include <wayfire/opengl.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace image_io
 {
@@ -11,6 +15,113 @@ namespace image_io
  * Guaranteed: doesn't change any GL state except pixel packing */
 bool load_from_file(std::string name, GLuint target);
 
+/* An image decoded into memory: 8-bit RGB or RGBA pixels, tightly packed, top row first */
+struct decoded_image_t
+{
+    int width    = 0;
+    int height   = 0;
+    int channels = 0;
+    std::vector<uint8_t> pixels;
+};
+
+/* Decode the image from the given file into memory.
+ * Doesn't use GL or any compositor state, so it may be called from worker threads.
+ * Returns nullptr on failure */
+std::shared_ptr<const decoded_image_t> decode_file(const std::string& name);
+
+/* Upload a decoded image to the given GL texture target (GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP)
+ * Bind the texture before you call this function
+ * Guaranteed: doesn't change any GL state except pixel packing */
+bool upload(const decoded_image_t& image, GLuint target);
+
+/**
+ * The result of decode_file_async(). Completed on the main thread, when the image has been decoded.
+ */
+class image_future_t : public std::enable_shared_from_this<image_future_t>
+{
+  public:
+    /** Whether decoding has finished, successfully or not. */
+    bool is_ready() const;
+
+    /** The decoded image, or nullptr if decoding failed or has not finished yet. */
+    std::shared_ptr<const decoded_image_t> get() const;
+
+    /**
+     * Call @callback on the main thread when decoding has finished, or immediately if it already has.
+     * Futures may be shared, so the callback should not keep the caller alive.
+     */
+    void then(std::function<void()> callback);
+
+    /** Called by the image cache when decoding has finished. */
+    void set_result(std::shared_ptr<const decoded_image_t> image);
+
+  private:
+    bool ready = false;
+    std::shared_ptr<const decoded_image_t> image;
+    std::vector<std::function<void()>> callbacks;
+};
+
+/**
+ * Decode the image from the given file on a worker thread of the core task pool.
+ *
+ * Decoded images are cached by path and modification time, so loading an unchanged file again (for example
+ * from the plugin instance of each output) shares the result of the first load. The cache only keeps an
+ * image while its future or the decoded image is referenced elsewhere. Must be called from the main thread.
+ */
+std::shared_ptr<image_future_t> decode_file_async(const std::string& name);
+
+/**
+ * A GL texture which is loaded asynchronously: the image is decoded with decode_file_async() and then
+ * uploaded on the main thread. The texture is deleted together with the future.
+ */
+class texture_future_t
+{
+  public:
+    texture_future_t(std::string name, GLuint target);
+    ~texture_future_t();
+
+    texture_future_t(const texture_future_t&) = delete;
+    texture_future_t& operator =(const texture_future_t&) = delete;
+
+    /** Whether loading has finished, successfully or not. */
+    bool is_ready() const;
+
+    /** The texture, or 0 if loading failed or has not finished yet. */
+    GLuint get_texture() const;
+
+    /** Call @callback on the main thread when the texture has been loaded, or immediately if it already has. */
+    void then(std::function<void()> callback);
+
+  private:
+    GLuint target;
+    GLuint tex = 0;
+    bool ready = false;
+    std::vector<std::function<void()>> callbacks;
+    std::shared_ptr<image_future_t> image;
+    std::shared_ptr<bool> alive = std::make_shared<bool>(true);
+
+    void upload_image();
+};
+
+/* Load the image from the given file into a new texture of the given target (GL_TEXTURE_2D or
+ * GL_TEXTURE_CUBE_MAP), without blocking the main thread for decoding.
+ * The texture uses linear filtering and clamps to edge */
+std::unique_ptr<texture_future_t> load_texture_async(std::string name, GLuint target);
+
+struct image_cache_stats_t
+{
+    /** Number of decode_file_async() calls which were served from the cache. */
+    uint64_t hits = 0;
+    /** Number of decode_file_async() calls which started a new decode. */
+    uint64_t misses = 0;
+    /** Number of cache entries dropped because their image was no longer referenced. */
+    uint64_t evictions = 0;
+    /** Total size of the decoded images which are cached and still referenced, in bytes. */
+    uint64_t cached_bytes = 0;
+};
+
+image_cache_stats_t get_cache_stats();
+
 /* Function that saves the given pixels(in rgba format) to a (currently) png file */
 void write_to_file(std::string name, uint8_t *pixels, int w, int h,
     std::string type, bool invert = false);
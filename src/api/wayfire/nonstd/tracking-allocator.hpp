@@ -2,6 +2,8 @@
 #include <memory>
 #include <functional>
 #include <algorithm>
+#include <unordered_map>
+#include <vector>
 #include <wayfire/dassert.hpp>
 #include <wayfire/nonstd/observer_ptr.h>
 #include <wayfire/signal-provider.hpp>
@@ -44,17 +46,52 @@ class tracking_allocator_t
             new ConcreteObjectType(std::forward<Args>(args)...),
             std::bind(&tracking_allocator_t<ObjectType>::deallocate_object, this, std::placeholders::_1));
 
+        index_of[ptr.get()] = allocated_objects.size();
         allocated_objects.push_back(ptr.get());
         return ptr;
     }
 
+    /**
+     * Get all allocated objects, in the order in which they were allocated.
+     */
     const std::vector<nonstd::observer_ptr<ObjectType>>& get_all()
     {
+        compact();
         return allocated_objects;
     }
 
   private:
     std::vector<nonstd::observer_ptr<ObjectType>> allocated_objects;
+
+    /**
+     * The position of each object in allocated_objects. Freeing an object leaves a hole in the list instead
+     * of erasing it, so that freeing is O(1) even when many short-lived objects come and go between two
+     * get_all() calls. The holes are removed in a single pass by compact().
+     */
+    std::unordered_map<ObjectType*, size_t> index_of;
+    size_t num_holes = 0;
+
+    void compact()
+    {
+        if (num_holes == 0)
+        {
+            return;
+        }
+
+        size_t next = 0;
+        for (auto& obj : allocated_objects)
+        {
+            if (obj)
+            {
+                index_of[obj.get()] = next;
+                allocated_objects[next++] = obj;
+            }
+        }
+
+        allocated_objects.resize(next);
+        num_holes = 0;
+    }
+
     void deallocate_object(ObjectType *obj)
     {
         if constexpr (std::is_base_of_v<wf::signal::provider_t, ObjectType>)
@@ -64,11 +101,17 @@ class tracking_allocator_t
             obj->emit(&event);
         }
 
-        auto it = std::find(allocated_objects.begin(), allocated_objects.end(),
-            nonstd::observer_ptr<ObjectType>{obj});
-        wf::dassert(it != allocated_objects.end(), "Object is not allocated?");
-        allocated_objects.erase(it);
+        auto it = index_of.find(obj);
+        wf::dassert(it != index_of.end(), "Object is not allocated?");
+        allocated_objects[it->second] = nullptr;
+        index_of.erase(it);
         delete obj;
+
+        /* Bound the memory used by holes if get_all() is not called for a long time */
+        if (++num_holes > allocated_objects.size() / 2)
+        {
+            compact();
+        }
     }
 };
 }
@@ -121,6 +121,7 @@ extern "C"
 // Output management
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/types/wlr_output_management_v1.h>
+#include <wlr/types/wlr_output_swapchain_manager.h>
 
 #if __has_include(<wlr-output-power-management-unstable-v1-protocol.h>)
     #include <wlr/types/wlr_output_power_management_v1.h>
@@ -46,6 +46,22 @@ enum plugin_activation_flags_t
     PLUGIN_ACTIVATE_ALLOW_MULTIPLE   = (1 << 1),
 };
 
+/**
+ * Counters describing how often the output re-evaluated whether a fullscreen view should be displayed above
+ * the top layer, see output_t::get_promotion_stats().
+ */
+struct promotion_stats_t
+{
+    /** Scenegraph, view and workspace events which the output received. */
+    uint64_t events = 0;
+    /** Searches for the topmost visible view caused by those events. */
+    uint64_t searches    = 0;
+    /** Times the promotion state was re-evaluated, with or without a new search. */
+    uint64_t evaluations = 0;
+    /** Times a fullscreen view was promoted above the top layer. */
+    uint64_t promotions  = 0;
+};
+
 class output_t : public wf::object_base_t, public wf::signal::provider_t
 {
   public:
@@ -171,6 +187,11 @@ class output_t : public wf::object_base_t, public wf::signal::provider_t
      */
     virtual bool is_plugin_active(std::string owner_name) const = 0;
 
+    /**
+     * Get statistics about the promotion of fullscreen views above the top layer on this output.
+     */
+    virtual promotion_stats_t get_promotion_stats() const = 0;
+
     /**
      * Sets (or unsets) the output as inhibited, so that no plugins can be activated
      * except those that ignore inhibitions.
@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 #include <cstdint>
 
 class wayfire_config;
@@ -93,6 +94,25 @@ class plugin_interface_t
 
     virtual ~plugin_interface_t() = default;
 };
+
+/** Timing information about a dynamically loaded plugin. */
+struct plugin_load_stats_t
+{
+    std::string name;
+    /** Time spent opening the plugin's .so file and looking up its symbols. */
+    int64_t load_time_us = 0;
+    /** Time spent in the plugin's init(). Zero if the plugin has not been initialized. */
+    int64_t init_time_us = 0;
+    /** Whether the plugin is listed in core/lazy_plugins. */
+    bool lazy = false;
+    bool initialized = false;
+};
+
+/**
+ * Get the load and init times of the dynamically loaded plugins, in the order in which they are listed in
+ * core/plugins.
+ */
+std::vector<plugin_load_stats_t> get_plugin_load_stats();
 }
 
 /**
@@ -107,7 +127,7 @@ using wayfire_plugin_load_func = wf::plugin_interface_t * (*)();
 /**
  * The version is defined as macro as well, to allow conditional compilation.
  */
-#define WAYFIRE_API_ABI_VERSION_MACRO 2026'08'01
+#define WAYFIRE_API_ABI_VERSION_MACRO 2026'10'19
 
 /**
  * The version of Wayfire's API/ABI
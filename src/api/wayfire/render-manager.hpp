@@ -6,12 +6,26 @@
 #include <wayfire/region.hpp>
 #include <cstdint>
 
+namespace OpenGL
+{
+class program_t;
+}
+
 namespace wf
 {
 /* Effect hooks provide the plugins with a way to execute custom code
  * at certain parts of the repaint cycle */
 using effect_hook_t = std::function<void ()>;
 
+/**
+ * Animation hooks are stepped once per frame by the output's animation timeline, before any effect hooks.
+ *
+ * The hook receives the time at which the frame being built is expected to be presented, in CLOCK_MONOTONIC
+ * nanoseconds. It should advance its animation to that time, damage the parts of the scene which changed and
+ * return whether the animation needs more frames. Hooks which return false are removed from the timeline.
+ */
+using animation_hook_t = std::function<bool (int64_t presentation_ns)>;
+
 enum output_effect_type_t
 {
     /* Pre hooks are called before starting to repaint the output */
@@ -125,6 +139,45 @@ struct render_debug_info_t
 using post_hook_t = std::function<void (wf::auxilliary_buffer_t& source,
     const wf::render_buffer_t& destination)>;
 
+enum post_hook_flags_t
+{
+    /**
+     * The hook is pointwise: each pixel of the destination depends only on the same pixel of the source.
+     * Such a hook may restrict its work to render_manager::get_swap_damage(). If all active hooks are
+     * pointwise, only the damaged parts of the output are repainted, instead of the whole output.
+     */
+    POST_HOOK_POINTWISE = (1 << 0),
+};
+
+/**
+ * A pointwise postprocessing effect like color inversion or a color filter, which is described by a shader
+ * function instead of a post hook.
+ *
+ * All active pointwise effects on an output are fused into a single shader pass, which runs after all post
+ * hooks and only on the damaged parts of the output. Pointwise effects are supported only with the GLES
+ * renderer.
+ */
+struct pointwise_post_effect_t
+{
+    /**
+     * A unique name of the effect. It is used as the name of the effect function, so it must be a valid
+     * GLSL identifier.
+     */
+    std::string name;
+
+    /**
+     * GLSL ES 1.00 source which defines the function `highp vec4 <name>(highp vec4 color)` together with
+     * any uniforms it uses. The function gets the premultiplied color of a pixel and returns its new color.
+     * Uniforms should be prefixed with the name of the effect to avoid clashes with other effects.
+     */
+    std::string source;
+
+    /**
+     * Called every frame while the fused program is in use, to update the uniforms of the effect.
+     */
+    std::function<void (OpenGL::program_t& program)> set_uniforms;
+};
+
 /**
  * The frame-done signal is emitted on an output when the frame has been completed (regardless of whether new
  * content was painted or not).
@@ -182,12 +235,32 @@ class render_manager
      */
     void rem_effect(effect_hook_t *hook);
 
+    /**
+     * Add an animation to the output's timeline. All animations are stepped in a single pass at the start of
+     * each frame, and the output keeps repainting while at least one of them is active.
+     */
+    void add_animation(animation_hook_t *hook);
+
+    /**
+     * Remove an animation from the timeline. No-op if the hook wasn't added.
+     */
+    void rem_animation(animation_hook_t *hook);
+
+    /**
+     * @return The predicted presentation time of the frame currently being built, in CLOCK_MONOTONIC
+     * nanoseconds. Animations should sample their progress at this time instead of the current time, since
+     * the repaint may be delayed by a variable amount after the previous frame. Outside of a repaint, or when
+     * no prediction is available, the current time is returned.
+     */
+    int64_t get_frame_presentation_time_ns();
+
     /**
      * Add a new post hook.
      *
      * @param hook The hook callback
+     * @param flags A bitmask of post_hook_flags_t describing the hook.
      */
-    void add_post(post_hook_t *hook);
+    void add_post(post_hook_t *hook, uint32_t flags = 0);
 
     /**
      * Remove a post hook. No-op if hook isn't active.
@@ -196,6 +269,17 @@ class render_manager
      */
     void rem_post(post_hook_t *hook);
 
+    /**
+     * Add a pointwise postprocessing effect, see pointwise_post_effect_t.
+     * The effect is applied after all post hooks, in the order in which the effects were added.
+     */
+    void add_pointwise_post(pointwise_post_effect_t *effect);
+
+    /**
+     * Remove a pointwise postprocessing effect. No-op if the effect isn't active.
+     */
+    void rem_pointwise_post(pointwise_post_effect_t *effect);
+
     /**
      * @return The damaged region on the current output for the current
      * frame that is used when swapping buffers. This function should
@@ -8,6 +8,7 @@
 
 #include "wayfire/signal-provider.hpp"
 #include <memory>
+#include <string>
 #include <vector>
 #include <wayfire/config/types.hpp>
 #include <wayfire/nonstd/wlroots.hpp>
@@ -345,6 +346,8 @@ struct auxilliary_buffer_t
 
     /**
      * Free the wlr_buffer/wlr_texture backing this framebuffer.
+     * The wlr_buffer may be kept in a pool for a short time, so that it can be reused by the next allocation
+     * with the same format and size.
      */
     void free();
 
@@ -370,11 +373,95 @@ struct auxilliary_buffer_t
      */
     wlr_texture *get_texture();
 
+    /**
+     * Set the owner of the buffer, for example the plugin, node or output which uses it.
+     * The owner is used to attribute the memory of the buffer in get_buffer_memory_stats().
+     * Buffers without an owner are accounted as "unknown".
+     */
+    void set_owner(const std::string& owner);
+
+    /**
+     * Get the owner of the buffer, as set by set_owner().
+     */
+    const std::string& get_owner() const;
+
   private:
     render_buffer_t buffer;
 
     // The wlr_texture creating from this framebuffer.
     wlr_texture *texture = NULL;
+
+    // The owner tag and the number of bytes accounted to it for the current buffer.
+    std::string owner;
+    uint64_t accounted_bytes = 0;
+
+    // The DRM format of the current buffer, used to return it to the buffer pool.
+    uint32_t drm_format = 0;
+};
+
+/**
+ * Memory used by the auxilliary buffers of a single owner, see auxilliary_buffer_t::set_owner().
+ */
+struct buffer_memory_owner_stats_t
+{
+    std::string owner;
+    uint32_t buffers = 0;
+    uint64_t bytes   = 0;
+};
+
+/**
+ * A snapshot of the memory used by all currently allocated auxilliary buffers.
+ * Sizes are estimated from the buffer dimensions and pixel format.
+ */
+struct buffer_memory_stats_t
+{
+    uint64_t total_bytes   = 0;
+    uint64_t peak_bytes    = 0;
+    uint32_t total_buffers = 0;
+    /** The configured budget (workarounds/aux_buffer_budget) in bytes, or 0 if unlimited. */
+    uint64_t budget_bytes  = 0;
+    /** Number of times buffer_memory_pressure_signal was emitted. */
+    uint32_t pressure_events = 0;
+    std::vector<buffer_memory_owner_stats_t> owners;
+};
+
+/**
+ * Get the current memory usage of auxilliary buffers, in total and per owner.
+ */
+buffer_memory_stats_t get_buffer_memory_stats();
+
+/**
+ * Statistics of the pool which recycles the wlr_buffers of freed auxilliary buffers.
+ */
+struct buffer_pool_stats_t
+{
+    /** Allocations which were served from the pool. */
+    uint64_t hits    = 0;
+    /** Allocations which needed a new buffer from the allocator. */
+    uint64_t misses  = 0;
+    /** Pooled buffers which were destroyed because they were not reused in time. */
+    uint64_t trimmed = 0;
+    uint32_t pooled_buffers = 0;
+    uint64_t pooled_bytes   = 0;
+};
+
+/**
+ * Get the current statistics of the auxilliary buffer pool.
+ */
+buffer_pool_stats_t get_buffer_pool_stats();
+
+/**
+ * Emitted on core when the memory used by auxilliary buffers exceeds the configured budget
+ * (workarounds/aux_buffer_budget). The signal is emitted once when the budget is exceeded, and again
+ * only after usage has dropped below the budget in the meantime.
+ *
+ * Owners of buffers which are not needed for the current frame should release them, or reallocate them
+ * with a lower resolution.
+ */
+struct buffer_memory_pressure_signal
+{
+    uint64_t used_bytes;
+    uint64_t budget_bytes;
 };
 
 /**
@@ -42,6 +42,65 @@ enum class direct_scanout
     SUCCESS,
 };
 
+/**
+ * Collects buffers which can be displayed on output layers (hardware overlay planes) instead of being
+ * composited, see render_instance_t::collect_plane_candidates().
+ *
+ * Render instances are visited from top to bottom. Instances report coordinates in their own coordinate
+ * system, @offset translates them to the coordinate system of the scenegraph root. Container instances adjust
+ * it for their children, see collect_plane_candidates_from_list().
+ */
+class plane_collector_t
+{
+  public:
+    struct candidate_t
+    {
+        /**
+         * Set by the render manager after the assignment: true if the buffer is displayed on an output layer
+         * for the current frame. In that case, the instance should not render it.
+         */
+        bool *promoted;
+        wlr_buffer *buffer;
+        wlr_fbox src_box;
+        /* The position of the buffer, in the coordinate system of the scenegraph root. */
+        wf::geometry_t geometry;
+    };
+
+    /**
+     * @param output_geometry The area of the output, in the coordinate system of the scenegraph root.
+     * @param max_candidates The maximal number of candidates to collect. Further buffers are composited.
+     */
+    plane_collector_t(const wf::geometry_t& output_geometry, size_t max_candidates);
+
+    wf::pointf_t offset = {0.0, 0.0};
+
+    /**
+     * Add a buffer displayed at @geometry as a candidate. The candidate is rejected if it would be displayed
+     * below composited content or is not fully inside the output, in which case it is treated like
+     * composited content itself. Buffers outside of the output are ignored.
+     *
+     * @param promoted See candidate_t::promoted. It is reset to false.
+     */
+    void add_candidate(bool *promoted, wlr_buffer *buffer, const wlr_fbox& src_box,
+        const wf::geometry_t& geometry);
+
+    /** Mark a region as composited, so that nothing below it is put on an output layer. */
+    void occlude(const wf::regionf_t& region);
+
+    /** Mark the whole output as composited. */
+    void occlude_all();
+
+    /** The collected candidates, from top to bottom. */
+    const std::vector<candidate_t>& get_candidates() const;
+
+  private:
+    wf::geometry_t output_geometry;
+    size_t max_candidates;
+    std::vector<candidate_t> candidates;
+    wf::regionf_t occluded;
+    bool all_occluded = false;
+};
+
 /**
  * A single rendering call in a render pass.
  */
@@ -142,6 +201,17 @@ class render_instance_t
      */
     virtual void compute_visibility(wf::output_t *output, wf::regionf_t& visible)
     {}
+
+    /**
+     * Report buffers which can be displayed on output layers instead of being composited, and the parts of
+     * the output which the instance composites.
+     *
+     * By default, we do not know where the instance draws, so it occludes the whole output.
+     */
+    virtual void collect_plane_candidates(wf::output_t *output, plane_collector_t& collector)
+    {
+        collector.occlude_all();
+    }
 };
 
 using damage_callback = std::function<void (const wf::regionf_t&)>;
@@ -189,6 +259,13 @@ direct_scanout try_scanout_from_list(
 void compute_visibility_from_list(const std::vector<render_instance_uptr>& instances, wf::output_t *output,
     wf::regionf_t& region, const wf::pointf_t& offset);
 
+/**
+ * A helper function for collect_plane_candidates implementations. It applies an offset to the collector and
+ * reverts it afterwards, and calls collect_plane_candidates for the children instances.
+ */
+void collect_plane_candidates_from_list(const std::vector<render_instance_uptr>& instances,
+    wf::output_t *output, plane_collector_t& collector, const wf::pointf_t& offset);
+
 /**
  * A helper class for easier implementation of render instances.
  * It automatically schedules instruction for the current node and tracks damage from the main node.
@@ -215,6 +292,11 @@ class simple_render_instance_t : public render_instance_t
                 });
     }
 
+    void collect_plane_candidates(wf::output_t *output, plane_collector_t& collector) override
+    {
+        collector.occlude(self->get_bounding_box());
+    }
+
   protected:
     std::shared_ptr<Node> self;
     wf::signal::connection_t<scene::node_damage_signal> on_self_damage = [=] (scene::node_damage_signal *ev)
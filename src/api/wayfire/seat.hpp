@@ -32,6 +32,19 @@ struct keyboard_focus_changed_signal
 struct seat_activity_signal
 {};
 
+/**
+ * Counters describing how pointer motion events were processed, see input/coalesce_pointer_motion.
+ */
+struct pointer_motion_stats_t
+{
+    /** Motion events received from pointer devices. */
+    uint64_t motion_events    = 0;
+    /** Motion events which were sent to the focused client as they arrived. */
+    uint64_t forwarded_events = 0;
+    /** Full position updates (hit test, focus update, grab motion) caused by motion events. */
+    uint64_t position_updates = 0;
+};
+
 /**
  * A seat represents a group of input devices (mouse, keyboard, etc.) which logically belong together.
  * Each seat has its own keyboard, touch, pointer and tablet focus.
@@ -127,6 +140,11 @@ class seat_t
      */
     void notify_activity();
 
+    /**
+     * Get statistics about the processing of pointer motion events.
+     */
+    pointer_motion_stats_t get_pointer_motion_stats() const;
+
     /**
      * Create and initialize a new seat.
      */
@@ -3,6 +3,9 @@
 
 #include "wayfire/view.hpp"
 #include "wayfire/output.hpp"
+#include <optional>
+#include <set>
+#include <wayfire/config/option.hpp>
 
 /**
  * Documentation of signals emitted from core components.
@@ -192,7 +195,52 @@ struct touch_focus_changed_signal
  * when: When the config file is reloaded
  */
 struct reload_config_signal
-{};
+{
+    /**
+     * The sections which were added, removed, or had an option changed by the reload. If not set, the
+     * backend does not know what changed, and listeners should assume that everything did.
+     */
+    std::optional<std::set<std::string>> changed_sections;
+
+    /** The options whose value changed. Only meaningful if changed_sections is set. */
+    std::set<std::shared_ptr<wf::config::option_base_t>> changed_options;
+
+    /** Whether options in @section may have changed. */
+    bool section_changed(const std::string& section) const
+    {
+        return !changed_sections.has_value() || changed_sections->count(section);
+    }
+
+    /** Whether options in @section, or in any section whose name starts with "<section>:", may have changed. */
+    bool section_or_instances_changed(const std::string& section) const
+    {
+        if (section_changed(section))
+        {
+            return true;
+        }
+
+        auto it = changed_sections->lower_bound(section + ":");
+        return (it != changed_sections->end()) && (it->rfind(section + ":", 0) == 0);
+    }
+
+    /** Whether the value of @option may have changed. */
+    bool option_changed(const std::shared_ptr<wf::config::option_base_t>& option) const
+    {
+        return !changed_sections.has_value() || changed_options.count(option);
+    }
+};
+
+/**
+ * on: core
+ * when: Functionality of a plugin is requested, for example an IPC method "<name>/..." or "wf/<name>/..."
+ *   which is not registered. If the plugin is listed in core/lazy_plugins and has not been initialized yet, core
+ *   initializes it and sets @initialized, so that the caller can try again.
+ */
+struct lazy_plugin_requested_signal
+{
+    std::string name;
+    bool initialized = false;
+};
 
 /**
  * on: core
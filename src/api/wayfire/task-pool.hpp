@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+struct wl_event_loop;
+
+namespace wf
+{
+/**
+ * A small, bounded pool of worker threads shared by core and plugins.
+ *
+ * It is meant for CPU-heavy work which does not touch compositor state, like particle simulation, image
+ * decoding, text rasterization or encoding captured frames. Each worker has its own job queue, and idle
+ * workers steal jobs from the queues of busy workers.
+ *
+ * Jobs run on a worker thread and must not call into wlroots or Wayfire APIs. Results are handed back to the
+ * main thread through the optional completion callback, which is dispatched from the event loop.
+ *
+ * The pool is available as wf::get_core().task_pool. The number of workers is set by the
+ * core/worker_threads option at startup.
+ */
+class task_pool_t
+{
+  public:
+    using job_t = std::function<void ()>;
+    using range_job_t = std::function<void (size_t begin, size_t end)>;
+
+    /**
+     * Create a pool with @num_workers threads. If @num_workers is zero, all jobs run inline on the calling
+     * thread. Completion callbacks are dispatched from @loop.
+     */
+    task_pool_t(wl_event_loop *loop, int num_workers);
+    ~task_pool_t();
+
+    task_pool_t(const task_pool_t &) = delete;
+    task_pool_t(task_pool_t &&) = delete;
+    task_pool_t& operator =(const task_pool_t&) = delete;
+    task_pool_t& operator =(task_pool_t&&) = delete;
+
+    /**
+     * Run @job on a worker thread.
+     *
+     * @param on_done An optional callback which is invoked on the main thread after @job has finished.
+     *   Jobs which have not started when the pool is destroyed are discarded together with their callbacks.
+     *
+     * If the pool has no workers, @job and @on_done are both run immediately.
+     */
+    void submit(job_t job, job_t on_done = {});
+
+    /**
+     * Split the range [begin, end) into chunks of at least @min_chunk elements and run @job on each of them,
+     * using the workers and the calling thread. Returns after all chunks have been processed.
+     *
+     * When called from a worker thread, the whole range is processed inline.
+     */
+    void parallel_for(size_t begin, size_t end, size_t min_chunk, const range_job_t& job);
+
+    /** The number of worker threads, not counting the main thread. */
+    int get_num_workers() const;
+
+    /** Whether the calling thread is one of the pool's workers. */
+    static bool is_worker_thread();
+
+    struct impl;
+
+  private:
+    std::unique_ptr<impl> priv;
+};
+}
@@ -61,6 +61,7 @@ class translation_node_instance_t : public render_instance_t
     void presentation_feedback(wf::output_t *output) override;
     wf::scene::direct_scanout try_scanout(wf::output_t *output) override;
     void compute_visibility(wf::output_t *output, wf::regionf_t& visible) override;
+    void collect_plane_candidates(wf::output_t *output, plane_collector_t& collector) override;
 };
 }
 }
@@ -27,6 +27,9 @@ struct surface_state_t
     wl_output_transform transform = WL_OUTPUT_TRANSFORM_NORMAL;
     wf::color_transform_t color_transform;
 
+    // Lazily created by get_texture(), dropped when the buffer changes.
+    mutable std::shared_ptr<wf::texture_t> cached_texture;
+
     // Sequence number of the last commit read from a wlr_surface state
     std::optional<uint32_t> seq{};
 
@@ -34,6 +37,16 @@ struct surface_state_t
     // and accumulate damage.
     void merge_state(wlr_surface *surface);
 
+    // Get a texture wrapper for the current buffer, or nullptr if there is no buffer.
+    //
+    // The wrapper is created once per buffer and shared between all callers. Its source box, transform,
+    // color transform and wait timeline are reset to the surface state (and the filter mode is cleared) on
+    // every call, so callers which modify it should do so right before using it.
+    std::shared_ptr<wf::texture_t> get_texture() const;
+
+    // Keep the cached texture wrapper from @other if it wraps the same buffer as this state.
+    void reuse_texture_from(surface_state_t& other);
+
     surface_state_t() = default;
 
     // Releases the lock on the current_buffer, if one is held.
@@ -45,6 +58,19 @@ struct surface_state_t
     surface_state_t& operator =(surface_state_t&& other);
 };
 
+/**
+ * The limit for the rate of frame callbacks sent to a surface, see the core/frame_pacing_* options.
+ */
+struct frame_pacing_t
+{
+    /** The maximal number of frame callbacks per second, or 0 if the rate is not limited. */
+    int max_rate = 0;
+    /** Which surface state caused the limit: none, occluded, minimized, other-workspace, thumbnail or rule. */
+    std::string reason = "none";
+    /** The largest fraction of the surface visible on any output. */
+    double visible_fraction = 1.0;
+};
+
 /**
  * An implementation of node_t for wlr_surfaces.
  *
@@ -78,6 +104,18 @@ class wlr_surface_node_t : public node_t, public zero_copy_texturable_node_t
     void apply_current_surface_state();
     void send_frame_done(bool delay_until_vblank);
 
+    /**
+     * Get the current frame callback rate limit of the surface. Frame callbacks sent because outputs are
+     * repainted are delayed to respect the limit, but send_frame_done() always sends them immediately.
+     */
+    const frame_pacing_t& get_frame_pacing();
+
+    /**
+     * Get the number of frame callbacks per second which were actually sent to the surface, measured over
+     * the last second.
+     */
+    double get_frame_callback_rate();
+
   private:
     std::unique_ptr<pointer_interaction_t> ptr_interaction;
     std::unique_ptr<touch_interaction_t> tch_interaction;
@@ -87,6 +125,20 @@ class wlr_surface_node_t : public node_t, public zero_copy_texturable_node_t
     std::map<wf::output_t*, int> pending_visibility_delta;
     wf::signal::connection_t<wf::output_removed_signal> on_output_remove;
 
+    // The fraction of the surface which was visible on each output during the last visibility computation.
+    std::map<wf::output_t*, double> visible_fraction;
+    frame_pacing_t frame_pacing;
+    int64_t frame_pacing_updated = 0;
+    bool frame_pacing_dirty = true;
+    int64_t last_frame_done  = 0;
+    wf::wl_timer<false> delayed_frame_done;
+    int64_t frame_rate_window_start = 0;
+    int frames_in_window = 0;
+    double frame_callback_rate = 0.0;
+    void update_frame_callback_rate(int64_t now);
+    void send_paced_frame_done();
+    void set_visible_fraction(wf::output_t *output, double fraction);
+
     class wlr_surface_render_instance_t;
     void handle_enter(wf::output_t *output);
     void handle_leave(wf::output_t *output);
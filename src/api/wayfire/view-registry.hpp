@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <wayfire/view.hpp>
+
+namespace wf
+{
+class workspace_set_t;
+
+/**
+ * The view registry keeps indexes of all views which exist (mapped or not), so that the views with a given
+ * id, app-id, output, workspace set or role can be found without going through the list of all views.
+ *
+ * The indexes are kept up to date through the signals of the views (app-id changes, output changes, map and
+ * unmap), by set_role() and by the workspace sets when views are added to or removed from them.
+ *
+ * The lists returned by the registry are not copies: they are valid only until the next view is created,
+ * destroyed or changes one of the indexed properties. Callers which may cause such changes while iterating
+ * should iterate over a copy. The views in each list except get_all() are in no particular order.
+ */
+class view_registry_t
+{
+  public:
+    /**
+     * Get the single global instance of the view registry.
+     */
+    static view_registry_t& get();
+
+    /**
+     * All views, in the order in which they were created. This is the same list as
+     * tracking_allocator_t<view_interface_t>::get_all().
+     */
+    const std::vector<wayfire_view>& get_all();
+
+    /** Find the view with the given id, or nullptr if there is no such view. */
+    wayfire_view find_by_id(uint32_t id);
+
+    /** All views with the given app-id. */
+    const std::vector<wayfire_view>& with_app_id(const std::string& app_id);
+
+    /** All views whose output is @output. Views without an output can be found with nullptr. */
+    const std::vector<wayfire_view>& on_output(wf::output_t *output);
+
+    /** All toplevel views in the given workspace set. */
+    const std::vector<wayfire_view>& in_wset(wf::workspace_set_t *wset);
+
+    /** All views with the given role. */
+    const std::vector<wayfire_view>& with_role(view_role_t role);
+
+    /**
+     * Add a newly created view to the registry. Called when the view is initialized.
+     */
+    void add_view(wayfire_view view);
+
+    /**
+     * Remove a view from the registry. Called when the view is destroyed.
+     */
+    void remove_view(view_interface_t *view);
+
+    /**
+     * Update the indexes of the given view after one of its indexed properties changed without a signal,
+     * for example when the view was added to or removed from a workspace set.
+     */
+    void update_view(wayfire_view view);
+
+  private:
+    view_registry_t();
+    ~view_registry_t();
+
+    struct impl;
+    std::unique_ptr<impl> priv;
+};
+}
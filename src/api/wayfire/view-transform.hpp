@@ -22,6 +22,9 @@ class zero_copy_texturable_node_t
      * Get a texture from the node without copying.
      * Note that this operation might fail for non-trivial transformers.
      *
+     * The returned texture may be cached by the node and shared with other callers, so changes to its
+     * rendering properties (e.g. the filter mode) are only guaranteed to last until the next call.
+     *
      * @param out_logical_size If provided, the logical size of the returned texture is written here.
      */
     virtual std::shared_ptr<wf::texture_t> to_texture(
@@ -250,6 +253,12 @@ class transformer_render_instance_t : public render_instance_t
             }
         }
     }
+
+    void collect_plane_candidates(wf::output_t *output, plane_collector_t& collector) override
+    {
+        // The transformer composites its children, so none of them can be put on a plane.
+        collector.occlude(self->get_bounding_box());
+    }
 };
 
 /**
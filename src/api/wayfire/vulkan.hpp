@@ -7,8 +7,10 @@
 #endif
 
 #if WF_HAS_VULKANFX
+    #include <future>
     #include <memory>
     #include <map>
+    #include <set>
     #include <string>
     #include <string_view>
     #include <variant>
@@ -22,12 +24,48 @@
 
 namespace wf
 {
+class task_pool_t;
+
 namespace vk
 {
 class context_t;
 class gpu_buffer_t;
 class graphics_pipeline_t;
 class image_descriptor_set_pool_t;
+struct frame_arena_t;
+
+/**
+ * A range of host-visible GPU memory suballocated for a single command buffer, see
+ * command_buffer_t::allocate().
+ */
+struct frame_allocation_t
+{
+    /** The buffer containing the allocation, usable as a vertex, index or uniform buffer or transfer source. */
+    VkBuffer buffer = VK_NULL_HANDLE;
+    /** The offset of the allocation in @buffer. */
+    VkDeviceSize offset = 0;
+    VkDeviceSize size   = 0;
+    /** The persistently mapped memory of the allocation. Writes do not need to be flushed. */
+    void *data = nullptr;
+};
+
+/** Usage statistics of a context's per-frame allocator, see context_t::get_frame_allocator_stats(). */
+struct frame_allocator_stats_t
+{
+    /** The number of memory blocks, including idle blocks kept for reuse. */
+    uint64_t num_blocks = 0;
+    /** The total size of all memory blocks. */
+    uint64_t block_bytes = 0;
+    /** Bytes suballocated by command buffers which have not finished executing yet. */
+    uint64_t in_flight_bytes = 0;
+    /** The largest number of bytes used by a single command buffer. */
+    uint64_t peak_frame_bytes = 0;
+    /** The number of suballocations made. */
+    uint64_t allocations = 0;
+    /** The number of times a new block had to be allocated from the driver. */
+    uint64_t block_allocations = 0;
+};
+
 /**
  * A class which encapsulates the information for specialization of a graphics pipeline for a specific render
  * pass. Specializations are used in order to reuse the same shader in different configurations, for example
@@ -68,6 +106,14 @@ class pipeline_specialization_t
     void add_specialization_for_texture(const std::shared_ptr<wf::texture_t>& texture,
         const uint32_t constant_id = 0, const uint32_t offset = 0);
 
+    /**
+     * Get the specializations which add_specialization_for_texture() produces for the common texture transfer
+     * functions (sRGB, linear and gamma 2.2) in all rotations, without the texture itself. They can be passed
+     * to graphics_pipeline_t::add_expected_specialization().
+     */
+    static std::vector<pipeline_specialization_t> get_common_texture_specializations(
+        const uint32_t constant_id = 0, const uint32_t offset = 0);
+
     /**
      * Get the specialization map entries.
      */
@@ -106,6 +152,7 @@ class command_buffer_t : public wf::signal::provider_t
     friend class gpu_buffer_t;
     friend class graphics_pipeline_t;
     std::vector<std::shared_ptr<gpu_buffer_t>> bound_buffers;
+    std::unique_ptr<frame_arena_t> arena;
 
     VkCommandBuffer cmd;
     VkRenderPass current_pass = VK_NULL_HANDLE;
@@ -169,6 +216,26 @@ class command_buffer_t : public wf::signal::provider_t
      */
     void bind_texture(const std::shared_ptr<wf::texture_t>& texture);
 
+    /**
+     * Allocate host-visible memory for vertex, index, uniform or staging data which is used by this command
+     * buffer. The memory is suballocated from large persistently mapped blocks owned by the context and stays
+     * valid until the command buffer has finished executing, after which it is reused for later frames.
+     *
+     * This is the preferred way to upload data which changes every frame, since it does not allocate any
+     * Vulkan objects in the common case.
+     *
+     * @param size The size of the allocation in bytes.
+     * @param alignment The required alignment of the allocation. Allocations are always aligned at least to
+     *   the device's minimum uniform buffer offset alignment.
+     * @return The allocation, with a null buffer if allocation failed.
+     */
+    frame_allocation_t allocate(VkDeviceSize size, VkDeviceSize alignment = 16);
+
+    /**
+     * Allocate memory as with allocate() and copy @size bytes from @data into it.
+     */
+    frame_allocation_t upload(const void *data, VkDeviceSize size, VkDeviceSize alignment = 16);
+
     operator VkCommandBuffer() const
     {
         return cmd;
@@ -189,7 +256,8 @@ class command_buffer_t : public wf::signal::provider_t
  * Suitable for uniform buffers, vertex buffers, or any other buffer usage.
  *
  * Use context_t::create_buffer() to allocate, and command_buffer_t::bind_buffer() to keep it alive
- * for the duration of a command buffer's execution.
+ * for the duration of a command buffer's execution. Data which is uploaded anew every frame should use
+ * command_buffer_t::allocate() instead.
  */
 class gpu_buffer_t : public std::enable_shared_from_this<gpu_buffer_t>
 {
@@ -317,6 +385,12 @@ class context_t : public std::enable_shared_from_this<context_t>
      * The renderer needs to be a vulkan renderer.
      */
     context_t(wlr_renderer *renderer);
+
+    /**
+     * Create a context for a device which is not owned by a wlroots renderer, for example for offscreen
+     * rendering. get_renderer() returns NULL for such contexts.
+     */
+    context_t(VkPhysicalDevice physical_device, VkDevice device, VkQueue queue);
     ~context_t();
     context_t(const context_t&) = delete;
     context_t(context_t&&) = delete;
@@ -361,12 +435,75 @@ class context_t : public std::enable_shared_from_this<context_t>
         return renderer;
     }
 
+    /**
+     * Get the pipeline cache shared by all pipelines created with this context.
+     *
+     * The cache is loaded from $XDG_CACHE_HOME/wayfire when the context is created and written back after new
+     * pipelines were created and when the context is destroyed, so that pipelines compiled in a previous
+     * session do not need to be compiled again. There is a separate file for each device and driver version.
+     */
+    VkPipelineCache get_pipeline_cache() const
+    {
+        return pipeline_cache;
+    }
+
+    /**
+     * Write the pipeline cache to disk.
+     * @return Whether the cache was written successfully.
+     */
+    bool save_pipeline_cache();
+
+    /**
+     * Notify the context that new pipelines were added to the pipeline cache. For contexts of a wlroots
+     * renderer, the cache is saved once no new pipelines were created for a few seconds, so that a crash
+     * later in the session does not lose the pipelines compiled at startup.
+     */
+    void pipeline_cache_updated();
+
+    /**
+     * The size of the pipeline cache data loaded from disk when the context was created, zero if there was
+     * no usable cache.
+     */
+    size_t get_loaded_pipeline_cache_size() const
+    {
+        return loaded_pipeline_cache_size;
+    }
+
+    /**
+     * Get the usage statistics of the per-frame allocator used by command_buffer_t::allocate().
+     */
+    frame_allocator_stats_t get_frame_allocator_stats() const;
+
   private:
+    friend struct frame_arena_t;
+    struct frame_block_t
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        std::byte *mapping = nullptr;
+    };
+
+    // Blocks of the per-frame allocator which are not used by any command buffer in flight.
+    std::vector<frame_block_t> idle_frame_blocks;
+    frame_allocator_stats_t frame_stats;
+    VkDeviceSize min_frame_alignment = 0;
+
+    frame_block_t acquire_frame_block(VkDeviceSize min_size);
+    void release_frame_blocks(std::vector<frame_block_t>& blocks, VkDeviceSize used_bytes);
+    void destroy_frame_block(const frame_block_t& block);
+
     // Vulkan core objects
     wlr_renderer *renderer = nullptr;
     VkDevice device;
     VkPhysicalDevice physical_device;
     VkQueue queue;
+
+    VkPipelineCache pipeline_cache = VK_NULL_HANDLE;
+    size_t loaded_pipeline_cache_size = 0;
+    std::string pipeline_cache_path;
+    wf::wl_timer<false> save_pipeline_cache_timer;
+    void create_pipeline_cache();
 };
 
 struct pipeline_shader_t
@@ -440,6 +577,32 @@ class graphics_pipeline_t
     std::pair<VkPipelineLayout, VkPipeline> pipeline_for(const command_buffer_t& pass,
         const pipeline_specialization_t& specialization = pipeline_specialization_t{});
 
+    /**
+     * Get or create a pipeline for a render pass which is not managed by wlroots, for example a render pass
+     * used for offscreen rendering. The specialization must not contain texture specializations, and the
+     * pipeline parameters must not contain texture descriptor sets.
+     */
+    std::pair<VkPipelineLayout, VkPipeline> pipeline_for_render_pass(VkRenderPass render_pass,
+        const pipeline_specialization_t& specialization = pipeline_specialization_t{});
+
+    /**
+     * Declare a specialization which is likely to be used with this pipeline, so that it can be compiled
+     * on a worker thread before it is needed, for example all texture transfer functions and rotations which
+     * a shader supports. The specialization must not contain texture specializations.
+     *
+     * For render passes managed by wlroots, the expected specializations are compiled as soon as the pipeline
+     * is used with the render pass for the first time, together with the texture descriptor set layouts of
+     * that first use. Render passes which are known up front can be warmed up with warm_up_render_pass().
+     */
+    void add_expected_specialization(const pipeline_specialization_t& specialization);
+
+    /**
+     * Start compiling the pipelines of all expected specializations for @render_pass on the workers of
+     * @pool. Later calls to pipeline_for_render_pass() wait for the compilation instead of compiling the
+     * same pipeline again. The pipeline parameters must not contain texture descriptor sets.
+     */
+    void warm_up_render_pass(VkRenderPass render_pass, wf::task_pool_t& pool);
+
   private:
     std::shared_ptr<context_t> context;
     pipeline_params_t params;
@@ -448,7 +611,31 @@ class graphics_pipeline_t
     // Cache key: (render pass, specialization data bytes, specialization texture ds)
     using pipeline_key_t = std::tuple<VkRenderPass, std::vector<std::byte>,
         std::vector<VkDescriptorSetLayout>>;
-    std::map<pipeline_key_t, std::pair<VkPipelineLayout, VkPipeline>> pipelines;
+    using pipeline_pair_t = std::pair<VkPipelineLayout, VkPipeline>;
+    std::map<pipeline_key_t, pipeline_pair_t> pipelines;
+
+    // Pipelines which are being compiled on a worker thread.
+    std::map<pipeline_key_t, std::shared_future<pipeline_pair_t>> pending_pipelines;
+    std::vector<pipeline_specialization_t> expected_specializations;
+    std::set<VkRenderPass> warmed_up_passes;
+
+    std::vector<VkDescriptorSetLayout> get_texture_layouts(const command_buffer_t& cmd_buf,
+        const pipeline_specialization_t& specialization);
+
+    /** Compile the expected specializations for @render_pass with @texture_layouts on @pool. */
+    void warm_up(VkRenderPass render_pass, const std::vector<VkDescriptorSetLayout>& texture_layouts,
+        wf::task_pool_t& pool);
+
+    /** Find the pipeline for @key, or create and store it. */
+    pipeline_pair_t get_or_create_pipeline(const pipeline_key_t& key,
+        const std::vector<VkSpecializationMapEntry>& entries);
+
+    /**
+     * Create a new pipeline. Does not modify the graphics pipeline, so it can be called from worker threads.
+     */
+    pipeline_pair_t create_pipeline(VkRenderPass render_pass, const std::vector<std::byte>& data,
+        const std::vector<VkSpecializationMapEntry>& entries,
+        const std::vector<VkDescriptorSetLayout>& texture_layouts) const;
 };
 
 /**
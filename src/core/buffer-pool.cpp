@@ -0,0 +1,137 @@
+#include "buffer-pool.hpp"
+#include <wayfire/nonstd/wlroots-full.hpp>
+#include <wayfire/option-wrapper.hpp>
+#include <wayfire/debug.hpp>
+#include <limits>
+
+wf::aux_buffer_pool_t::aux_buffer_pool_t()
+{
+    max_pool_size_mb.set_callback([this] ()
+    {
+        trim(std::numeric_limits<int64_t>::min(), std::max(0, (int)max_pool_size_mb) * 1024ull * 1024ull);
+    });
+}
+
+wf::aux_buffer_pool_t::~aux_buffer_pool_t()
+{
+    clear();
+}
+
+wf::aux_buffer_pool_t::pooled_buffer_t wf::aux_buffer_pool_t::acquire(uint32_t drm_format,
+    wf::dimensions_t size)
+{
+    auto it = buffers.find({drm_format, size.width, size.height});
+    if ((it == buffers.end()) || it->second.empty())
+    {
+        ++misses;
+        return {};
+    }
+
+    // Prefer the most recently used buffer, it is the most likely one to still be in the GPU caches.
+    auto result = it->second.back();
+    it->second.pop_back();
+    if (it->second.empty())
+    {
+        buffers.erase(it);
+    }
+
+    ++hits;
+    --pooled_buffers;
+    pooled_bytes -= result.bytes;
+    return result;
+}
+
+void wf::aux_buffer_pool_t::release(uint32_t drm_format, wf::dimensions_t size, pooled_buffer_t buffer)
+{
+    const uint64_t max_bytes = std::max(0, (int)max_pool_size_mb) * 1024ull * 1024ull;
+
+    // Buffers which are still locked elsewhere (for example, by a texture_t which is kept alive or by a
+    // pending render pass) could still be read from, so we cannot hand them out for rendering again.
+    if ((buffer.bytes > max_bytes) || (buffer.buffer->n_locks > 0))
+    {
+        wlr_buffer_drop(buffer.buffer);
+        return;
+    }
+
+    buffer.released_at = wf::get_current_time();
+    buffers[{drm_format, size.width, size.height}].push_back(buffer);
+    ++pooled_buffers;
+    pooled_bytes += buffer.bytes;
+    trim(std::numeric_limits<int64_t>::min(), max_bytes);
+
+    if (!trim_timer.is_connected() && (pooled_buffers > 0))
+    {
+        trim_timer.set_timeout(std::max(1, (int)idle_timeout_ms), [this] ()
+        {
+            trim(wf::get_current_time() - idle_timeout_ms,
+                std::max(0, (int)max_pool_size_mb) * 1024ull * 1024ull);
+            return pooled_buffers > 0;
+        });
+    }
+}
+
+void wf::aux_buffer_pool_t::trim(int64_t cutoff, uint64_t max_bytes)
+{
+    while (!buffers.empty())
+    {
+        // Find the globally oldest buffer, which is at the front of one of the lists.
+        auto oldest = buffers.begin();
+        for (auto it = buffers.begin(); it != buffers.end(); ++it)
+        {
+            if (it->second.front().released_at < oldest->second.front().released_at)
+            {
+                oldest = it;
+            }
+        }
+
+        auto& entry = oldest->second.front();
+        if ((entry.released_at >= cutoff) && (pooled_bytes <= max_bytes))
+        {
+            break;
+        }
+
+        wlr_buffer_drop(entry.buffer);
+        --pooled_buffers;
+        pooled_bytes -= entry.bytes;
+        ++trimmed;
+
+        oldest->second.erase(oldest->second.begin());
+        if (oldest->second.empty())
+        {
+            buffers.erase(oldest);
+        }
+    }
+}
+
+void wf::aux_buffer_pool_t::clear()
+{
+    for (auto& [key, list] : buffers)
+    {
+        for (auto& buffer : list)
+        {
+            wlr_buffer_drop(buffer.buffer);
+            ++trimmed;
+        }
+    }
+
+    buffers.clear();
+    pooled_buffers = 0;
+    pooled_bytes   = 0;
+    trim_timer.disconnect();
+}
+
+uint64_t wf::aux_buffer_pool_t::get_pooled_bytes() const
+{
+    return pooled_bytes;
+}
+
+wf::buffer_pool_stats_t wf::aux_buffer_pool_t::get_stats() const
+{
+    buffer_pool_stats_t stats;
+    stats.hits    = hits;
+    stats.misses  = misses;
+    stats.trimmed = trimmed;
+    stats.pooled_buffers = pooled_buffers;
+    stats.pooled_bytes   = pooled_bytes;
+    return stats;
+}
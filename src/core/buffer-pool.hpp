@@ -0,0 +1,81 @@
+#pragma once
+
+#include <map>
+#include <tuple>
+#include <vector>
+#include <wayfire/geometry.hpp>
+#include <wayfire/option-wrapper.hpp>
+#include <wayfire/render.hpp>
+#include <wayfire/util.hpp>
+
+namespace wf
+{
+/**
+ * A pool of recently freed auxilliary buffers.
+ *
+ * Freeing an auxilliary buffer returns its wlr_buffer to the pool.
+ * A later allocation with the same format and size takes the buffer from the pool instead of going through
+ * the allocator, which is slow on many drivers and typically happens on the first frame of an effect.
+ *
+ * Pooled buffers are destroyed after they have not been reused for workarounds/aux_buffer_pool_timeout
+ * milliseconds, or when the pool grows beyond workarounds/aux_buffer_pool_size MiB.
+ */
+class aux_buffer_pool_t
+{
+  public:
+    struct pooled_buffer_t
+    {
+        wlr_buffer *buffer = nullptr;
+        uint64_t bytes     = 0;
+        int64_t released_at = 0;
+    };
+
+    aux_buffer_pool_t();
+    ~aux_buffer_pool_t();
+
+    aux_buffer_pool_t(const aux_buffer_pool_t&) = delete;
+    aux_buffer_pool_t(aux_buffer_pool_t&&) = delete;
+    aux_buffer_pool_t& operator =(const aux_buffer_pool_t&) = delete;
+    aux_buffer_pool_t& operator =(aux_buffer_pool_t&&) = delete;
+
+    /**
+     * Take a buffer with the given format and size from the pool.
+     * @return The pooled buffer, or a buffer with a NULL wlr_buffer on a pool miss.
+     */
+    pooled_buffer_t acquire(uint32_t drm_format, wf::dimensions_t size);
+
+    /**
+     * Return a buffer to the pool. If the buffer cannot be pooled, it is destroyed immediately.
+     * Any textures created from the buffer must have been destroyed before.
+     */
+    void release(uint32_t drm_format, wf::dimensions_t size, pooled_buffer_t buffer);
+
+    /** Destroy all pooled buffers. */
+    void clear();
+
+    /** @return The number of bytes currently held by the pool. */
+    uint64_t get_pooled_bytes() const;
+
+    buffer_pool_stats_t get_stats() const;
+
+  private:
+    using key_t = std::tuple<uint32_t, int, int>;
+    // Buffers are appended on release, so every list is sorted from the oldest to the newest buffer.
+    std::map<key_t, std::vector<pooled_buffer_t>> buffers;
+
+    uint64_t pooled_bytes   = 0;
+    uint32_t pooled_buffers = 0;
+    uint64_t hits    = 0;
+    uint64_t misses  = 0;
+    uint64_t trimmed = 0;
+
+    wf::option_wrapper_t<int> max_pool_size_mb{"workarounds/aux_buffer_pool_size"};
+    wf::option_wrapper_t<int> idle_timeout_ms{"workarounds/aux_buffer_pool_timeout"};
+    wf::wl_timer<true> trim_timer;
+
+
+    /** Destroy buffers released before @cutoff, and the oldest buffers while the pool is larger than
+     * @max_bytes. */
+    void trim(int64_t cutoff, uint64_t max_bytes);
+};
+}
@@ -10,12 +10,15 @@
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wayfire/vulkan.hpp>
 #include "src/core/xdg-output-management.hpp"
+#include "src/core/startup-timeline.hpp"
+#include "src/core/launcher.hpp"
 
 namespace wf
 {
 class seat_t;
 class input_manager_t;
 class input_method_relay;
+class aux_buffer_pool_t;
 class compositor_core_impl_t : public compositor_core_t
 {
   public:
@@ -31,6 +34,10 @@ class compositor_core_impl_t : public compositor_core_t
     std::unique_ptr<input_method_relay> im_relay;
     std::unique_ptr<plugin_manager_t> plugin_mgr;
     std::unique_ptr<wf::xdg_output_manager_v1> xdg_output_manager;
+    std::unique_ptr<wf::aux_buffer_pool_t> buffer_pool;
+    wf::startup_timeline_t startup_timeline;
+    /** The process which spawns commands for run(), started at the beginning of main(). May be null. */
+    std::unique_ptr<wf::launcher_t> launcher;
 
     /**
      * Initialize the compositor core.
@@ -103,10 +110,18 @@ class compositor_core_impl_t : public compositor_core_t
     compositor_state_t state = compositor_state_t::UNKNOWN;
     struct rlimit user_maxfiles;
     void increase_nofile_limit();
-    void restore_nofile_limit();
 
   private:
     wf::option_wrapper_t<bool> discard_command_output;
+
+    /** The environment of commands started by run(). */
+    std::vector<std::string> get_command_environment();
+    /** Spawn a command directly with posix_spawn(), used when the launcher is not available. */
+    pid_t spawn_without_launcher(const std::string& command, const std::vector<std::string>& env);
+
+    /** Children spawned without the launcher, which have to be reaped by us. */
+    std::vector<pid_t> unreaped_children;
+    wf::wl_timer<true> reap_timer;
     static std::unique_ptr<compositor_core_impl_t> static_core;
 };
 
@@ -11,6 +11,7 @@
 #include "wayfire/txn/transaction-manager.hpp"
 #include "wayfire/bindings-repository.hpp"
 #include "wayfire/util.hpp"
+#include "wayfire/task-pool.hpp"
 #include <memory>
 #include "wayfire/config-backend.hpp" // IWYU pragma: keep
 
@@ -20,9 +21,14 @@
 #include "wayfire/touch/touch.hpp"
 #include "wayfire/view.hpp"
 #include <sys/wait.h>
+#include <spawn.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <float.h>
+#include <algorithm>
+#include <map>
+#include <string_view>
+#include <thread>
 
 #include <wayfire/img.hpp>
 #include <wayfire/output.hpp>
@@ -45,6 +51,7 @@
 #include <wayfire/window-manager.hpp>
 
 #include "core-impl.hpp"
+#include "buffer-pool.hpp"
 
 struct wf_pointer_constraint
 {
@@ -98,10 +105,21 @@ bool wf::compositor_core_t::is_pixman() const
 
 void wf::compositor_core_impl_t::init()
 {
-    this->scene_root = std::make_shared<scene::root_node_t>();
-    this->tx_manager = std::make_unique<txn::transaction_manager_t>();
+    startup_timeline.begin_phase("core-init");
+    this->buffer_pool = std::make_unique<aux_buffer_pool_t>();
+    this->scene_root  = std::make_shared<scene::root_node_t>();
+    this->tx_manager  = std::make_unique<txn::transaction_manager_t>();
     this->default_wm = std::make_unique<wf::window_manager_t>();
 
+    wf::option_wrapper_t<int> worker_threads{"core/worker_threads"};
+    int num_workers = worker_threads;
+    if (num_workers <= 0)
+    {
+        num_workers = std::clamp<int>(std::thread::hardware_concurrency() / 2, 1, 4);
+    }
+
+    this->task_pool = std::make_unique<wf::task_pool_t>(ev_loop, num_workers);
+
     wlr_renderer_init_wl_display(renderer, display);
 
     /* Order here is important:
@@ -313,6 +331,7 @@ void wf::compositor_core_impl_t::init()
     increase_nofile_limit();
 
     this->state = compositor_state_t::START_BACKEND;
+    startup_timeline.end_phase("core-init");
 }
 
 void wf::compositor_core_impl_t::increase_nofile_limit()
@@ -333,14 +352,6 @@ void wf::compositor_core_impl_t::increase_nofile_limit()
     }
 }
 
-void wf::compositor_core_impl_t::restore_nofile_limit()
-{
-    if (setrlimit(RLIMIT_NOFILE, &user_maxfiles) != 0)
-    {
-        LOGE("Failed to setrlimit(RLIMIT_NOFILE), could not restore maximum open file descriptors.");
-    }
-}
-
 void wf::compositor_core_impl_t::post_init()
 {
     discard_command_output.load_option("workarounds/discard_command_output");
@@ -348,8 +359,10 @@ void wf::compositor_core_impl_t::post_init()
     core_backend_started_signal backend_started_ev;
     this->emit(&backend_started_ev);
     this->state = compositor_state_t::START_PLUGINS;
-    plugin_mgr  = std::make_unique<wf::plugin_manager_t>();
+    startup_timeline.begin_phase("plugins");
+    plugin_mgr = std::make_unique<wf::plugin_manager_t>();
     plugin_mgr->start();
+    startup_timeline.end_phase("plugins");
     this->bindings->reparse_extensions();
 
     this->state = compositor_state_t::RUNNING;
@@ -425,12 +438,18 @@ void wf::compositor_core_impl_t::fini()
     input.reset();
     output_layout.reset();
     tx_manager.reset();
+    buffer_pool.reset();
+    task_pool.reset();
 
     OpenGL::fini();
 #if WF_HAS_VULKANFX
     vulkan_state.reset();
 #endif
 
+    launcher.reset();
+    reap_timer.disconnect();
+    startup_timeline.fini();
+
     disconnect_signals();
     wl_display_destroy(static_core->display);
 }
@@ -571,94 +590,109 @@ std::vector<wayfire_view> wf::compositor_core_t::get_all_views()
     return wf::tracking_allocator_t<view_interface_t>::get().get_all();
 }
 
-/**
- * Upon successful execution, returns the PID of the child process.
- * Returns 0 in case of failure.
- */
-pid_t wf::compositor_core_impl_t::run(std::string command)
+std::vector<std::string> wf::compositor_core_impl_t::get_command_environment()
 {
-    static constexpr size_t READ_END  = 0;
-    static constexpr size_t WRITE_END = 1;
+    std::map<std::string, std::string> overrides = {
+        {"_JAVA_AWT_WM_NONREPARENTING", "1"},
+        {"WAYLAND_DISPLAY", wayland_display},
+    };
 
-    int pipe_fd[2];
-    int ret = pipe2(pipe_fd, O_CLOEXEC);
-    if (ret == -1)
+#if WF_HAS_XWAYLAND
+    if (!xwayland_get_display().empty())
     {
-        LOGE("wf::compositor_core_impl_t::run: failed to create pipe2: ", strerror(errno));
-        return 0;
+        overrides["DISPLAY"] = xwayland_get_display();
     }
 
-    /* The following is a "hack" for disowning the child processes,
-     * otherwise they will simply stay as zombie processes */
-    pid_t pid = fork();
-    if (!pid)
+#endif
+
+    std::vector<std::string> env;
+    for (char **entry = environ; *entry; entry++)
     {
-        restore_nofile_limit();
-        pid = fork();
-        if (!pid)
+        std::string_view var = *entry;
+        if (!overrides.count(std::string(var.substr(0, var.find('=')))))
         {
-            close(pipe_fd[READ_END]);
-            close(pipe_fd[WRITE_END]);
+            env.emplace_back(var);
+        }
+    }
 
-            setenv("_JAVA_AWT_WM_NONREPARENTING", "1", 1);
-            setenv("WAYLAND_DISPLAY", wayland_display.c_str(), 1);
-#if WF_HAS_XWAYLAND
-            if (!xwayland_get_display().empty())
-            {
-                setenv("DISPLAY", xwayland_get_display().c_str(), 1);
-            }
+    for (auto& [name, value] : overrides)
+    {
+        env.push_back(name + "=" + value);
+    }
 
-#endif
-            if (discard_command_output)
-            {
-                int dev_null = open("/dev/null", O_WRONLY);
-                dup2(dev_null, 1);
-                dup2(dev_null, 2);
-                close(dev_null);
-            }
+    return env;
+}
 
-            _exit(execl("/bin/sh", "/bin/sh", "-c", command.c_str(), NULL));
-        } else
-        {
-            close(pipe_fd[READ_END]);
-            int ret = write(pipe_fd[WRITE_END], (void*)(&pid), sizeof(pid));
-            close(pipe_fd[WRITE_END]);
-            _exit(ret != sizeof(pid) ? 1 : 0);
-        }
-    } else
+pid_t wf::compositor_core_impl_t::spawn_without_launcher(const std::string& command,
+    const std::vector<std::string>& env)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    if (discard_command_output)
     {
-        close(pipe_fd[WRITE_END]);
+        posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_adddup2(&actions, 1, 2);
+    }
+
+    std::vector<char*> envp;
+    for (auto& entry : env)
+    {
+        envp.push_back(const_cast<char*>(entry.c_str()));
+    }
 
-        int status;
-        waitpid(pid, &status, 0);
+    envp.push_back(nullptr);
+    const char *argv[] = {"/bin/sh", "-c", command.c_str(), nullptr};
 
-        // Return 0 if the child process didn't run or didn't exit normally, or returns a non-zero return
-        // value.
-        pid_t child_pid{};
-        if (WIFEXITED(status) && (WEXITSTATUS(status) == 0))
+    /* Unlike the launcher, which is forked before the limit is raised, the child inherits the raised
+     * RLIMIT_NOFILE. Changing the compositor's own limit here would race with the other threads. */
+    pid_t pid = 0;
+    int ret = posix_spawn(&pid, "/bin/sh", &actions, nullptr, const_cast<char**>(argv), envp.data());
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (ret != 0)
+    {
+        LOGE("wf::compositor_core_impl_t::run(\"", command, "\"): posix_spawn failed: ", strerror(ret));
+        return 0;
+    }
+
+    /* The child is ours, so it has to be reaped. waitpid(-1) would also reap processes which were started
+     * by wlroots and which it waits for itself, so poll the PIDs we know about instead. */
+    unreaped_children.push_back(pid);
+    if (!reap_timer.is_connected())
+    {
+        reap_timer.set_timeout(1000, [=] ()
         {
-            int ret = read(pipe_fd[READ_END], &child_pid, sizeof(child_pid));
-            if (ret != sizeof(child_pid))
+            auto it = std::remove_if(unreaped_children.begin(), unreaped_children.end(), [] (pid_t child)
             {
-                // This is consider to be an error (even though theoretically a partial read would require an
-                // attempt to continue).
-                child_pid = 0;
-                if (ret == -1)
-                {
-                    LOGE("wf::compositor_core_impl_t::run(\"", command,
-                        "\"): failed to read PID from pipe end: ", strerror(errno));
-                } else
-                {
-                    LOGE("wf::compositor_core_impl_t::run(\"", command,
-                        "\"): short read of PID from pipe end, got ", std::to_string(ret), " bytes");
-                }
-            }
-        }
+                return waitpid(child, nullptr, WNOHANG) != 0;
+            });
+            unreaped_children.erase(it, unreaped_children.end());
+            return !unreaped_children.empty();
+        });
+    }
 
-        close(pipe_fd[READ_END]);
+    return pid;
+}
 
-        return child_pid;
+/**
+ * Upon successful execution, returns the PID of the child process.
+ * Returns 0 in case of failure.
+ */
+pid_t wf::compositor_core_impl_t::run(std::string command)
+{
+    auto env = get_command_environment();
+    if (launcher)
+    {
+        if (auto pid = launcher->spawn(command, env, discard_command_output))
+        {
+            return *pid;
+        }
+
+        LOGE("The launcher process is not responding, spawning commands directly from now on.");
+        launcher.reset();
     }
+
+    return spawn_without_launcher(command, env);
 }
 
 std::string wf::compositor_core_impl_t::get_xwayland_display()
@@ -0,0 +1,147 @@
+#include <wayfire/frame-animation.hpp>
+
+#include <algorithm>
+
+struct wf::animation::frame_duration_t::state_t
+{
+    std::shared_ptr<config::option_t<animation_description_t>> length;
+    smoothing::smooth_function smooth;
+    int64_t start_ns = 0;
+    bool is_running  = false;
+    bool reversed    = false;
+
+    int64_t length_ns() const
+    {
+        return length ? std::max(0, length->get_value().length_ms) * (int64_t)1'000'000 : 0;
+    }
+
+    /** The progress in [0, 1] at @time_ns, without easing and direction. */
+    double linear_progress(int64_t time_ns) const
+    {
+        const int64_t total = length_ns();
+        if (total == 0)
+        {
+            return 1.0;
+        }
+
+        return std::clamp((double)(time_ns - start_ns) / total, 0.0, 1.0);
+    }
+
+    double progress(int64_t time_ns) const
+    {
+        smoothing::smooth_function easing = smooth;
+        if (length && length->get_value().easing)
+        {
+            easing = length->get_value().easing;
+        }
+
+        const double linear = linear_progress(time_ns);
+        return easing(reversed ? 1.0 - linear : linear);
+    }
+};
+
+wf::animation::frame_duration_t::frame_duration_t(
+    std::shared_ptr<config::option_t<animation_description_t>> length, smoothing::smooth_function smooth)
+{
+    priv = std::make_shared<state_t>();
+    priv->length = length;
+    priv->smooth = smooth;
+}
+
+void wf::animation::frame_duration_t::start()
+{
+    priv->start_ns   = get_frame_time_ns();
+    priv->is_running = true;
+}
+
+double wf::animation::frame_duration_t::progress() const
+{
+    return progress_at(get_frame_time_ns());
+}
+
+double wf::animation::frame_duration_t::progress_at(int64_t time_ns) const
+{
+    return priv->progress(time_ns);
+}
+
+bool wf::animation::frame_duration_t::running()
+{
+    if (priv->is_running && (priv->linear_progress(get_frame_time_ns()) >= 1.0))
+    {
+        priv->is_running = false;
+    }
+
+    return priv->is_running;
+}
+
+void wf::animation::frame_duration_t::reverse()
+{
+    if (running())
+    {
+        // Continue from the mirrored point, so that the remaining time is what has elapsed so far
+        const int64_t now = get_frame_time_ns();
+        priv->start_ns = now - (priv->length_ns() - (now - priv->start_ns));
+    }
+
+    priv->reversed = !priv->reversed;
+}
+
+int wf::animation::frame_duration_t::get_direction()
+{
+    return !priv->reversed;
+}
+
+wf::animation::frame_transition_t::frame_transition_t(const frame_duration_t& duration,
+    double start, double end) : start(start), end(end), duration(duration.priv)
+{}
+
+void wf::animation::frame_transition_t::restart_with_end(double new_end)
+{
+    start = *this;
+    end   = new_end;
+}
+
+void wf::animation::frame_transition_t::restart_same_end()
+{
+    start = *this;
+}
+
+void wf::animation::frame_transition_t::set(double start, double end)
+{
+    this->start = start;
+    this->end   = end;
+}
+
+void wf::animation::frame_transition_t::flip()
+{
+    std::swap(start, end);
+}
+
+wf::animation::frame_transition_t::operator double() const
+{
+    const double alpha = duration->progress(get_frame_time_ns());
+    return (1 - alpha) * start + alpha * end;
+}
+
+wf::animation::simple_frame_animation_t::simple_frame_animation_t(
+    std::shared_ptr<config::option_t<animation_description_t>> length, smoothing::smooth_function smooth) :
+    frame_duration_t(length, smooth), frame_transition_t(static_cast<frame_duration_t&>(*this))
+{}
+
+void wf::animation::simple_frame_animation_t::animate(double start, double end)
+{
+    set(start, end);
+    frame_duration_t::start();
+}
+
+void wf::animation::simple_frame_animation_t::animate(double end)
+{
+    restart_with_end(end);
+    frame_duration_t::start();
+}
+
+void wf::animation::simple_frame_animation_t::animate()
+{
+    restart_same_end();
+    frame_duration_t::start();
+}
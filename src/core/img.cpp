@@ -4,6 +4,7 @@
 #include "wayfire/img.hpp"
 #include "wayfire/opengl.hpp"
 #include "wayfire/core.hpp"
+#include "wayfire/task-pool.hpp"
 
 #include <config.h>
 
@@ -14,6 +15,7 @@
 #endif
 
 #include <stdint.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <string.h>
 #include <cstdio>
@@ -24,13 +26,47 @@
 
 namespace image_io
 {
-using Loader = std::function<bool (const char*, GLuint)>;
+using Decoder = std::function<bool (const char*, decoded_image_t&)>;
 using Writer = std::function<void (const char*name, uint8_t*pixels, unsigned long,
     unsigned long, bool)>;
 namespace
 {
-std::unordered_map<std::string, Loader> loaders;
+std::unordered_map<std::string, Decoder> decoders;
 std::unordered_map<std::string, Writer> writers;
+
+/**
+ * The cache does not keep images alive by itself: an entry is only valid while a future or the decoded image
+ * is still referenced elsewhere, for example by a texture_future_t which has not uploaded it yet.
+ */
+struct cache_entry_t
+{
+    timespec mtime;
+    off_t size;
+    std::weak_ptr<image_future_t> future;
+    std::weak_ptr<const decoded_image_t> image;
+    /** The size of the decoded image, or 0 while it is being decoded or if decoding failed. */
+    uint64_t bytes = 0;
+};
+
+std::unordered_map<std::string, cache_entry_t> image_cache;
+image_cache_stats_t cache_stats;
+
+/** Drop the entries whose future and image are no longer referenced, their memory is already freed. */
+void evict_unreferenced()
+{
+    for (auto it = image_cache.begin(); it != image_cache.end();)
+    {
+        if (it->second.future.expired() && it->second.image.expired())
+        {
+            cache_stats.cached_bytes -= it->second.bytes;
+            cache_stats.evictions++;
+            it = image_cache.erase(it);
+        } else
+        {
+            ++it;
+        }
+    }
+}
 }
 
 bool load_data_as_cubemap(unsigned char *data, int width, int height, int channels)
@@ -123,13 +159,14 @@ bool load_data_as_cubemap(unsigned char *data, int width, int height, int channe
 #ifdef BUILD_WITH_IMAGEIO
 /* All backend functions are taken from the internet.
  * If you want to be credited, contact me */
-bool texture_from_png(const char *filename, GLuint target)
+bool decode_png(const char *filename, decoded_image_t& image)
 {
     FILE *fp = fopen(filename, "rb");
-    int width, height;
-    png_byte color_type;
-    png_byte bit_depth;
-    png_bytep *row_pointers;
+    if (!fp)
+    {
+        LOGE("failed to read PNG file ", filename);
+        return false;
+    }
 
     png_structp png =
         png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
@@ -142,12 +179,16 @@ bool texture_from_png(const char *filename, GLuint target)
     png_infop infos = png_create_info_struct(png);
     if (!infos)
     {
+        png_destroy_read_struct(&png, NULL, NULL);
         fclose(fp);
         return false;
     }
 
+    /* libpng reports errors with longjmp(), which skips the destructors of objects created after setjmp() */
+    std::vector<png_bytep> row_pointers;
     if (setjmp(png_jmpbuf(png)))
     {
+        png_destroy_read_struct(&png, &infos, NULL);
         fclose(fp);
         return false;
     }
@@ -155,10 +196,10 @@ bool texture_from_png(const char *filename, GLuint target)
     png_init_io(png, fp);
     png_read_info(png, infos);
 
-    width  = png_get_image_width(png, infos);
-    height = png_get_image_height(png, infos);
-    color_type = png_get_color_type(png, infos);
-    bit_depth  = png_get_bit_depth(png, infos);
+    int width  = png_get_image_width(png, infos);
+    int height = png_get_image_height(png, infos);
+    png_byte color_type = png_get_color_type(png, infos);
+    png_byte bit_depth  = png_get_bit_depth(png, infos);
 
     if (bit_depth == 16)
     {
@@ -197,37 +238,20 @@ bool texture_from_png(const char *filename, GLuint target)
 
     png_read_update_info(png, infos);
 
-    row_pointers = new png_bytep[height];
-    png_byte *data = new png_byte[height * png_get_rowbytes(png, infos)];
+    const size_t rowbytes = png_get_rowbytes(png, infos);
+    image.width    = width;
+    image.height   = height;
+    image.channels = png_get_channels(png, infos);
+    image.pixels.resize(height * rowbytes);
 
+    row_pointers.resize(height);
     for (int i = 0; i < height; i++)
     {
-        row_pointers[i] = data + i * png_get_rowbytes(png, infos);
-    }
-
-    png_read_image(png, row_pointers);
-
-    if (target == GL_TEXTURE_CUBE_MAP)
-    {
-        if (!load_data_as_cubemap(data, width, height,
-            png_get_channels(png, infos)))
-        {
-            png_destroy_read_struct(&png, &infos, NULL);
-            delete[] row_pointers;
-            delete[] data;
-            fclose(fp);
-            return false;
-        }
-    } else if (target == GL_TEXTURE_2D)
-    {
-        GL_CALL(glTexImage2D(target, 0, GL_RGBA, width, height, 0,
-            GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)data));
+        row_pointers[i] = image.pixels.data() + i * rowbytes;
     }
 
+    png_read_image(png, row_pointers.data());
     png_destroy_read_struct(&png, &infos, NULL);
-    delete[] row_pointers;
-    delete[] data;
-
     fclose(fp);
 
     return true;
@@ -297,18 +321,13 @@ void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert
     png_free(png, rows);
 }
 
-bool texture_from_jpeg(const char *FileName, GLuint target)
+bool decode_jpeg(const char *FileName, decoded_image_t& image)
 {
-    unsigned long data_size;
     unsigned char *rowptr[1];
-    unsigned char *jdata;
     struct jpeg_decompress_struct infot;
     struct jpeg_error_mgr err;
 
     std::FILE *file = fopen(FileName, "rb");
-    infot.err = jpeg_std_error(&err);
-    jpeg_create_decompress(&infot);
-
     if (!file)
     {
         LOGE("failed to read JPEG file ", FileName);
@@ -316,48 +335,35 @@ bool texture_from_jpeg(const char *FileName, GLuint target)
         return false;
     }
 
+    infot.err = jpeg_std_error(&err);
+    jpeg_create_decompress(&infot);
+
     jpeg_stdio_src(&infot, file);
     jpeg_read_header(&infot, TRUE);
+    infot.out_color_space = JCS_RGB;
     jpeg_start_decompress(&infot);
 
-    data_size = infot.output_width * infot.output_height * 3;
-
-    jdata = new unsigned char [data_size];
+    image.width    = infot.output_width;
+    image.height   = infot.output_height;
+    image.channels = 3;
+    image.pixels.resize(3 * infot.output_width * infot.output_height);
     while (infot.output_scanline < infot.output_height)
     {
-        rowptr[0] = (unsigned char*)jdata + 3 * infot.output_width *
+        rowptr[0] = image.pixels.data() + 3 * infot.output_width *
             infot.output_scanline;
         jpeg_read_scanlines(&infot, rowptr, 1);
     }
 
     jpeg_finish_decompress(&infot);
-
-    GLint width  = infot.output_width;
-    GLint height = infot.output_height;
-
-    if (target == GL_TEXTURE_CUBE_MAP)
-    {
-        if (!load_data_as_cubemap(jdata, width, height, 3))
-        {
-            fclose(file);
-            delete[] jdata;
-            return false;
-        }
-    } else if (target == GL_TEXTURE_2D)
-    {
-        GL_CALL(glTexImage2D(target, 0, GL_RGB, width, height, 0,
-            GL_RGB, GL_UNSIGNED_BYTE, jdata));
-    }
-
+    jpeg_destroy_decompress(&infot);
     fclose(file);
-    delete[] jdata;
 
     return true;
 }
 
 #endif
 
-bool load_from_file(std::string name, GLuint target)
+std::shared_ptr<const decoded_image_t> decode_file(const std::string& name)
 {
     if (access(name.c_str(), F_OK) == -1)
     {
@@ -366,16 +372,16 @@ bool load_from_file(std::string name, GLuint target)
             LOGE(__func__, "() cannot access ", name);
         }
 
-        return false;
+        return nullptr;
     }
 
     int len = name.length();
     if ((len < 4) || (name[len - 4] != '.'))
     {
         LOGE(
-            "load_from_file() called with file without extension or with invalid extension!");
+            "decode_file() called with file without extension or with invalid extension!");
 
-        return false;
+        return nullptr;
     }
 
     auto ext = name.substr(len - 3, 3);
@@ -384,18 +390,254 @@ bool load_from_file(std::string name, GLuint target)
         ext[i] = std::tolower(ext[i]);
     }
 
-    auto it = loaders.find(ext);
-    if (it == loaders.end())
+    auto it = decoders.find(ext);
+    if (it == decoders.end())
     {
-        LOGE("load_from_file() called with unsupported extension ", ext);
+        LOGE("decode_file() called with unsupported extension ", ext);
 
-        return false;
+        return nullptr;
+    }
+
+    auto image = std::make_shared<decoded_image_t>();
+    if (!it->second(name.c_str(), *image))
+    {
+        return nullptr;
+    }
+
+    return image;
+}
+
+bool upload(const decoded_image_t& image, GLuint target)
+{
+    /* RGB rows are tightly packed, so they are not necessarily aligned to 4 bytes */
+    GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    bool result = true;
+    if (target == GL_TEXTURE_CUBE_MAP)
+    {
+        result = load_data_as_cubemap(image.pixels.data(), image.width, image.height, image.channels);
+    } else if (target == GL_TEXTURE_2D)
+    {
+        auto format = (image.channels == 4 ? GL_RGBA : GL_RGB);
+        GL_CALL(glTexImage2D(target, 0, format, image.width, image.height, 0,
+            format, GL_UNSIGNED_BYTE, image.pixels.data()));
+    }
+
+    GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+    return result;
+}
+
+bool load_from_file(std::string name, GLuint target)
+{
+    auto image = decode_file(name);
+    return image && upload(*image, target);
+}
+
+bool image_future_t::is_ready() const
+{
+    return ready;
+}
+
+std::shared_ptr<const decoded_image_t> image_future_t::get() const
+{
+    return image;
+}
+
+void image_future_t::then(std::function<void()> callback)
+{
+    if (ready)
+    {
+        callback();
     } else
     {
-        return it->second(name.c_str(), target);
+        callbacks.push_back(std::move(callback));
     }
 }
 
+void image_future_t::set_result(std::shared_ptr<const decoded_image_t> image)
+{
+    /* A callback may drop the last reference to us */
+    auto self = shared_from_this();
+    this->image = std::move(image);
+    this->ready = true;
+    auto to_call = std::move(callbacks);
+    callbacks.clear();
+    for (auto& cb : to_call)
+    {
+        cb();
+    }
+}
+
+std::shared_ptr<image_future_t> decode_file_async(const std::string& name)
+{
+    auto future = std::make_shared<image_future_t>();
+
+    struct stat st;
+    if (stat(name.c_str(), &st) != 0)
+    {
+        if (!name.empty())
+        {
+            LOGE(__func__, "() cannot access ", name);
+        }
+
+        future->set_result(nullptr);
+        return future;
+    }
+
+    evict_unreferenced();
+    auto it = image_cache.find(name);
+    if (it != image_cache.end())
+    {
+        auto& entry = it->second;
+        if ((entry.mtime.tv_sec == st.st_mtim.tv_sec) && (entry.mtime.tv_nsec == st.st_mtim.tv_nsec) &&
+            (entry.size == st.st_size))
+        {
+            cache_stats.hits++;
+            if (auto cached = entry.future.lock())
+            {
+                return cached;
+            }
+
+            /* Only the decoded image is still in use, wrap it in a new future */
+            future->set_result(entry.image.lock());
+            entry.future = future;
+            return future;
+        }
+
+        cache_stats.cached_bytes -= entry.bytes;
+        image_cache.erase(it);
+    }
+
+    cache_stats.misses++;
+    image_cache[name] = cache_entry_t{
+        .mtime  = st.st_mtim,
+        .size   = st.st_size,
+        .future = future,
+    };
+
+    auto result  = std::make_shared<std::shared_ptr<const decoded_image_t>>();
+    auto on_done = [=] ()
+    {
+        /* The worker may still hold the decode job, which must not keep the image alive */
+        auto image = std::move(*result);
+        auto it    = image_cache.find(name);
+        if ((it != image_cache.end()) && (it->second.future.lock() == future) && image)
+        {
+            it->second.image = image;
+            it->second.bytes = image->pixels.size();
+            cache_stats.cached_bytes += it->second.bytes;
+        }
+
+        future->set_result(std::move(image));
+    };
+
+    auto& pool = wf::get_core().task_pool;
+    if (pool)
+    {
+        pool->submit([=] { *result = decode_file(name); }, on_done);
+    } else
+    {
+        *result = decode_file(name);
+        on_done();
+    }
+
+    return future;
+}
+
+texture_future_t::texture_future_t(std::string name, GLuint target) : target(target)
+{
+    image = decode_file_async(name);
+    image->then([this, alive = std::weak_ptr<bool>(alive)] ()
+    {
+        if (alive.lock())
+        {
+            upload_image();
+        }
+    });
+}
+
+texture_future_t::~texture_future_t()
+{
+    if (tex)
+    {
+        wf::gles::run_in_context([&]
+        {
+            GL_CALL(glDeleteTextures(1, &tex));
+        });
+    }
+}
+
+void texture_future_t::upload_image()
+{
+    auto decoded = image->get();
+    image.reset();
+
+    if (decoded)
+    {
+        wf::gles::run_in_context([&]
+        {
+            GL_CALL(glGenTextures(1, &tex));
+            GL_CALL(glBindTexture(target, tex));
+            if (upload(*decoded, target))
+            {
+                GL_CALL(glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+                GL_CALL(glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+                GL_CALL(glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+                GL_CALL(glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+                if (target == GL_TEXTURE_CUBE_MAP)
+                {
+                    GL_CALL(glTexParameteri(target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
+                }
+            } else
+            {
+                GL_CALL(glDeleteTextures(1, &tex));
+                tex = 0;
+            }
+
+            GL_CALL(glBindTexture(target, 0));
+        });
+    }
+
+    ready = true;
+    auto to_call = std::move(callbacks);
+    callbacks.clear();
+    for (auto& cb : to_call)
+    {
+        cb();
+    }
+}
+
+bool texture_future_t::is_ready() const
+{
+    return ready;
+}
+
+GLuint texture_future_t::get_texture() const
+{
+    return tex;
+}
+
+void texture_future_t::then(std::function<void()> callback)
+{
+    if (ready)
+    {
+        callback();
+    } else
+    {
+        callbacks.push_back(std::move(callback));
+    }
+}
+
+std::unique_ptr<texture_future_t> load_texture_async(std::string name, GLuint target)
+{
+    return std::make_unique<texture_future_t>(std::move(name), target);
+}
+
+image_cache_stats_t get_cache_stats()
+{
+    evict_unreferenced();
+    return cache_stats;
+}
+
 void write_to_file(std::string name, uint8_t *pixels, int w, int h, std::string type,
     bool invert)
 {
@@ -434,8 +676,8 @@ void init()
 {
     LOGD("init ImageIO");
 #ifdef BUILD_WITH_IMAGEIO
-    loaders["png"] = Loader(texture_from_png);
-    loaders["jpg"] = Loader(texture_from_jpeg);
+    decoders["png"] = Decoder(decode_png);
+    decoders["jpg"] = Decoder(decode_jpeg);
     writers["png"] = Writer(texture_to_png);
 #endif
 }
@@ -0,0 +1,179 @@
+#include "launcher.hpp"
+#include <wayfire/util/log.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+/** How long the compositor waits for the launcher to report the PID of a new process. */
+constexpr time_t REPLY_TIMEOUT_S = 2;
+
+/**
+ * A spawn request is a single packet: one byte which is '1' if the output should be discarded, followed by
+ * the command and the environment entries, each terminated by a NUL byte.
+ */
+std::string encode_request(const std::string& command, const std::vector<std::string>& env,
+    bool discard_output)
+{
+    std::string request(1, discard_output ? '1' : '0');
+    request.append(command.c_str()).push_back('\0');
+    for (auto& entry : env)
+    {
+        request.append(entry.c_str()).push_back('\0');
+    }
+
+    return request;
+}
+
+[[noreturn]] void exec_command(const std::vector<char>& request)
+{
+    const char *command = request.data() + 1;
+    std::vector<char*> envp;
+    for (size_t i = strlen(command) + 2; i < request.size(); i += strlen(request.data() + i) + 1)
+    {
+        envp.push_back(const_cast<char*>(request.data() + i));
+    }
+
+    envp.push_back(nullptr);
+
+    /* Signal dispositions set to SIG_IGN survive exec, so undo the ones the launcher changed */
+    signal(SIGCHLD, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+
+    if (request[0] == '1')
+    {
+        int dev_null = open("/dev/null", O_WRONLY);
+        dup2(dev_null, 1);
+        dup2(dev_null, 2);
+        close(dev_null);
+    }
+
+    const char *argv[] = {"/bin/sh", "-c", command, nullptr};
+    execve("/bin/sh", const_cast<char**>(argv), envp.data());
+    _exit(127);
+}
+
+/** The main loop of the launcher process. Does not return. */
+[[noreturn]] void run_launcher(int fd)
+{
+    /* Children of the launcher are reaped automatically. */
+    signal(SIGCHLD, SIG_IGN);
+    /* Ctrl-C in the terminal is handled by the compositor, which then closes the socket. */
+    signal(SIGINT, SIG_IGN);
+
+    std::vector<char> request;
+    while (true)
+    {
+        ssize_t size = recv(fd, nullptr, 0, MSG_PEEK | MSG_TRUNC);
+        if ((size < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+
+        if (size <= 0)
+        {
+            /* The compositor closed its end of the socket or exited. */
+            _exit(0);
+        }
+
+        request.resize(size);
+        if (recv(fd, request.data(), request.size(), 0) != size)
+        {
+            _exit(1);
+        }
+
+        /* A well-formed request has at least the flag byte and the command's terminator. */
+        pid_t child = -1;
+        if ((size >= 2) && (request.back() == '\0'))
+        {
+            child = fork();
+            if (child == 0)
+            {
+                close(fd);
+                exec_command(request);
+            }
+        }
+
+        pid_t reply = (child < 0) ? 0 : child;
+        if (send(fd, &reply, sizeof(reply), MSG_NOSIGNAL) != sizeof(reply))
+        {
+            _exit(1);
+        }
+    }
+}
+}
+
+std::unique_ptr<wf::launcher_t> wf::launcher_t::create()
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) != 0)
+    {
+        LOGE("Failed to create the launcher socket: ", strerror(errno));
+        return nullptr;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        LOGE("Failed to fork the launcher: ", strerror(errno));
+        close(fds[0]);
+        close(fds[1]);
+        return nullptr;
+    }
+
+    if (pid == 0)
+    {
+        close(fds[0]);
+        run_launcher(fds[1]);
+    }
+
+    close(fds[1]);
+    timeval timeout{.tv_sec = REPLY_TIMEOUT_S, .tv_usec = 0};
+    setsockopt(fds[0], SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    LOGD("Started launcher process with PID ", pid);
+    return std::unique_ptr<launcher_t>(new launcher_t(fds[0], pid));
+}
+
+wf::launcher_t::launcher_t(int fd, pid_t pid) : fd(fd), pid(pid)
+{}
+
+wf::launcher_t::~launcher_t()
+{
+    close(fd);
+    /* The launcher exits on its own when the socket is closed, but it may be stuck if it stopped replying. */
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+}
+
+std::optional<pid_t> wf::launcher_t::spawn(const std::string& command,
+    const std::vector<std::string>& env, bool discard_output)
+{
+    auto request = encode_request(command, env, discard_output);
+    if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != (ssize_t)request.size())
+    {
+        LOGE("Failed to send spawn request to the launcher: ", strerror(errno));
+        return {};
+    }
+
+    pid_t child;
+    ssize_t ret;
+    do {
+        ret = recv(fd, &child, sizeof(child), 0);
+    } while ((ret < 0) && (errno == EINTR));
+
+    if (ret != sizeof(child))
+    {
+        LOGE("Failed to read the PID of \"", command, "\" from the launcher: ",
+            (ret < 0) ? strerror(errno) : "short read");
+        return {};
+    }
+
+    return child;
+}
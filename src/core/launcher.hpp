@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+namespace wf
+{
+/**
+ * A small helper process which spawns commands on behalf of the compositor.
+ *
+ * Forking the compositor itself gets slower the more memory (and GPU buffers) it has mapped, and the
+ * compositor's main loop is blocked for the whole time. The launcher is forked at the very start of main(),
+ * while the process is still small, and afterwards receives spawn requests over a socketpair. Commands
+ * spawned by the launcher are its own children, so the compositor never has to reap them.
+ *
+ * The launcher exits as soon as the compositor closes its end of the socket.
+ */
+class launcher_t
+{
+  public:
+    /**
+     * Fork the launcher process. Must be called before the compositor creates any resources, so that they
+     * are neither duplicated nor inherited by the launcher.
+     *
+     * @return The launcher, or nullptr if it could not be started.
+     */
+    static std::unique_ptr<launcher_t> create();
+
+    ~launcher_t();
+    launcher_t(const launcher_t&) = delete;
+    launcher_t& operator =(const launcher_t&) = delete;
+
+    /**
+     * Run @command with /bin/sh in the given environment.
+     *
+     * @param env The full environment of the new process, as KEY=VALUE entries.
+     * @param discard_output Whether stdout and stderr of the new process should go to /dev/null.
+     *
+     * @return The PID of the new process, 0 if the launcher could not fork, or std::nullopt if the launcher
+     *   cannot be used anymore (it exited, or the request could not be sent).
+     */
+    std::optional<pid_t> spawn(const std::string& command, const std::vector<std::string>& env,
+        bool discard_output);
+
+  private:
+    launcher_t(int fd, pid_t pid);
+
+    /** The compositor's end of the socketpair */
+    int fd;
+    /** The PID of the launcher process */
+    pid_t pid;
+};
+}
@@ -2,6 +2,7 @@
 #include "wayfire/core.hpp"
 #include "wayfire/output-layout.hpp"
 #include "wayfire/view.hpp"
+#include "wayfire/view-registry.hpp"
 #include "wayfire/workspace-set.hpp"
 #include "wayfire/render-manager.hpp"
 #include "wayfire/signal-definitions.hpp"
@@ -395,9 +396,9 @@ void transfer_views(wf::output_t *from, wf::output_t *to)
     // Note that all views in workspace sets will have their output reassigned automatically by the
     // workspace-set impl.
     std::vector<std::shared_ptr<wf::view_interface_t>> non_ws_views;
-    for (auto& view : wf::get_core().get_all_views())
+    for (auto& view : wf::view_registry_t::get().on_output(from))
     {
-        if ((view->get_output() == from) && (!toplevel_cast(view) || !toplevel_cast(view)->get_wset()))
+        if (!toplevel_cast(view) || !toplevel_cast(view)->get_wset())
         {
             // Take a ref, so that the view doesn't get destroyed while we're doing operations on the views
             non_ws_views.push_back(view->shared_from_this());
@@ -1234,34 +1235,7 @@ struct output_layout_output_t
             return;
         }
 
-        uint32_t changed_fields = 0;
-        if (this->current_state.source != state.source)
-        {
-            changed_fields |= wf::OUTPUT_SOURCE_CHANGE;
-        }
-
-        if ((this->current_state.mode.width != state.mode.width) ||
-            (this->current_state.mode.height != state.mode.height) ||
-            (this->current_state.mode.refresh != state.mode.refresh))
-        {
-            changed_fields |= wf::OUTPUT_MODE_CHANGE;
-        }
-
-        if (this->current_state.scale != state.scale)
-        {
-            changed_fields |= wf::OUTPUT_SCALE_CHANGE;
-        }
-
-        if (this->current_state.transform != state.transform)
-        {
-            changed_fields |= wf::OUTPUT_TRANSFORM_CHANGE;
-        }
-
-        if (!(this->current_state.position == state.position))
-        {
-            changed_fields |= wf::OUTPUT_POSITION_CHANGE;
-        }
-
+        uint32_t changed_fields = get_changed_fields(state);
         this->current_state = state;
 
         /* Even if output will remain mirrored, we can tear it down and set
@@ -1306,6 +1280,155 @@ struct output_layout_output_t
             setup_mirror();
         }
     }
+
+    /**
+     * Fill @pending with everything needed to go from the current hardware state to @state, so that it can
+     * be committed together with other outputs.
+     *
+     * @return false if the change cannot be expressed in a single commit (DPMS, HDR, or a bit depth which
+     *   needs format fallbacks), in which case apply_state() has to be used.
+     */
+    bool build_atomic_state(const output_state_t& state, wlr_output_state& pending)
+    {
+        /* Nested outputs follow the size of the parent window, which apply_mode() already handles */
+        if (is_nested_compositor || (state.source == OUTPUT_IMAGE_SOURCE_DPMS) ||
+            (current_state.source == OUTPUT_IMAGE_SOURCE_DPMS) ||
+            (state.source == OUTPUT_IMAGE_SOURCE_INVALID))
+        {
+            return false;
+        }
+
+        if (state.source == OUTPUT_IMAGE_SOURCE_NONE)
+        {
+            if (handle->enabled)
+            {
+                wlr_output_state_set_enabled(&pending, false);
+            }
+
+            return true;
+        }
+
+        if (this->current_hdr_enabled.value_or(false) != state.hdr)
+        {
+            return false;
+        }
+
+        if (!handle->enabled)
+        {
+            wlr_output_state_set_enabled(&pending, true);
+        }
+
+        if (!handle->current_mode || (handle->current_mode->width != state.mode.width) ||
+            (handle->current_mode->height != state.mode.height) ||
+            (handle->current_mode->refresh != state.mode.refresh))
+        {
+            refresh_custom_modes();
+            auto built_in = find_matching_mode(handle, state.mode, state.uses_custom_mode);
+            if (built_in)
+            {
+                wlr_output_state_set_mode(&pending, built_in);
+            } else if ((handle->width != state.mode.width) || (handle->height != state.mode.height) ||
+                       (handle->refresh != state.mode.refresh))
+            {
+                wlr_output_state_set_custom_mode(&pending, state.mode.width, state.mode.height,
+                    state.mode.refresh);
+            }
+        }
+
+        const bool adaptive_sync_enabled = (handle->adaptive_sync_status == WLR_OUTPUT_ADAPTIVE_SYNC_ENABLED);
+        if (adaptive_sync_enabled != state.vrr)
+        {
+            wlr_output_state_set_adaptive_sync_enabled(&pending, state.vrr);
+        }
+
+        if (state.depth != current_bit_depth)
+        {
+            if (formats_for_depth.count(state.depth) == 0)
+            {
+                return false;
+            }
+
+            wlr_output_state_set_render_format(&pending, formats_for_depth[state.depth].front());
+        }
+
+        if (state.source & OUTPUT_IMAGE_SOURCE_SELF)
+        {
+            if (handle->transform != state.transform)
+            {
+                wlr_output_state_set_transform(&pending, state.transform);
+            }
+
+            if (handle->scale != state.scale)
+            {
+                wlr_output_state_set_scale(&pending, state.scale);
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Update the output after a state built with build_atomic_state() has been committed, ignoring
+     * position. In contrast to apply_state(), this does not touch the hardware.
+     */
+    void apply_committed_state(const output_state_t& state)
+    {
+        uint32_t changed_fields = get_changed_fields(state);
+        this->current_state = state;
+        teardown_mirror();
+
+        if (state.source == OUTPUT_IMAGE_SOURCE_NONE)
+        {
+            destroy_wayfire_output();
+            return;
+        }
+
+        current_bit_depth = state.depth;
+        if (state.source & OUTPUT_IMAGE_SOURCE_SELF)
+        {
+            ensure_wayfire_output(get_effective_size());
+            emit_configuration_changed(changed_fields);
+            output->render->damage_whole();
+        } else /* state.source == OUTPUT_IMAGE_SOURCE_MIRROR */
+        {
+            destroy_wayfire_output();
+            setup_mirror();
+        }
+    }
+
+  private:
+    uint32_t get_changed_fields(const output_state_t& state)
+    {
+        uint32_t changed_fields = 0;
+        if (this->current_state.source != state.source)
+        {
+            changed_fields |= wf::OUTPUT_SOURCE_CHANGE;
+        }
+
+        if ((this->current_state.mode.width != state.mode.width) ||
+            (this->current_state.mode.height != state.mode.height) ||
+            (this->current_state.mode.refresh != state.mode.refresh))
+        {
+            changed_fields |= wf::OUTPUT_MODE_CHANGE;
+        }
+
+        if (this->current_state.scale != state.scale)
+        {
+            changed_fields |= wf::OUTPUT_SCALE_CHANGE;
+        }
+
+        if (this->current_state.transform != state.transform)
+        {
+            changed_fields |= wf::OUTPUT_TRANSFORM_CHANGE;
+        }
+
+        if (!(this->current_state.position == state.position))
+        {
+            changed_fields |= wf::OUTPUT_POSITION_CHANGE;
+        }
+
+        return changed_fields;
+    }
 };
 
 class output_layout_t::impl
@@ -1751,6 +1874,185 @@ class output_layout_t::impl
         return ok;
     }
 
+    /**
+     * Render a black frame into a buffer from the swapchain which @swapchains allocated for the output,
+     * so that enabling the output or changing its mode can be committed together with the other outputs.
+     * States which do not change the mode keep the output's current buffer.
+     */
+    static bool attach_black_frame(wlr_output_swapchain_manager *swapchains, wlr_backend_output_state& state)
+    {
+        auto swapchain = wlr_output_swapchain_manager_get_swapchain(swapchains, state.output);
+        wlr_buffer *buffer = swapchain ? wlr_swapchain_acquire(swapchain) : nullptr;
+        if (!buffer)
+        {
+            return false;
+        }
+
+        wlr_render_pass *pass = wlr_renderer_begin_buffer_pass(get_core().renderer, buffer, NULL);
+        if (!pass)
+        {
+            wlr_buffer_unlock(buffer);
+            return false;
+        }
+
+        wlr_render_rect_options opts{};
+        opts.box   = {0, 0, buffer->width, buffer->height};
+        opts.color = {.r = 0, .g = 0, .b = 0, .a = 1};
+        wlr_render_pass_add_rect(pass, &opts);
+        const bool rendered = wlr_render_pass_submit(pass);
+
+        wlr_output_state_set_buffer(&state.base, buffer);
+        wlr_buffer_unlock(buffer);
+        return rendered;
+    }
+
+    /**
+     * Apply the given configuration with a single backend commit for all outputs, so that docking and
+     * undocking result in one modeset, one round of view transfers and one configuration-changed event.
+     *
+     * @return false if the configuration cannot be applied atomically, in which case nothing has been
+     *   changed and the outputs have to be configured one by one.
+     */
+    bool apply_configuration_atomically(const output_configuration_t& config)
+    {
+        if (is_shutting_down())
+        {
+            return false;
+        }
+
+        /* Turning off all outputs needs the noop output, see apply_configuration() */
+        auto surviving = std::find_if(config.begin(), config.end(), [] (const auto& entry)
+        {
+            return entry.second.source & OUTPUT_IMAGE_SOURCE_SELF;
+        });
+        if (surviving == config.end())
+        {
+            return false;
+        }
+
+        std::vector<wlr_backend_output_state> states;
+        states.reserve(config.size());
+        auto release_states = [&] ()
+        {
+            for (auto& state : states)
+            {
+                wlr_output_state_finish(&state.base);
+            }
+        };
+
+        for (auto& [handle, state] : config)
+        {
+            states.push_back({.output = handle});
+            wlr_output_state_init(&states.back().base);
+            if (!this->outputs[handle]->build_atomic_state(state, states.back().base))
+            {
+                release_states();
+                return false;
+            }
+
+            if (states.back().base.committed == 0)
+            {
+                /* Nothing to change in hardware, for example only the position changed */
+                wlr_output_state_finish(&states.back().base);
+                states.pop_back();
+            }
+        }
+
+        if (!states.empty())
+        {
+            wlr_output_swapchain_manager swapchains;
+            wlr_output_swapchain_manager_init(&swapchains, get_core().backend);
+            bool ok = wlr_output_swapchain_manager_prepare(&swapchains, states.data(), states.size());
+            for (size_t i = 0; ok && (i < states.size()); i++)
+            {
+                /* Only a modeset or a new render format needs a new buffer, changing the scale or VRR
+                 * does not */
+                auto& state = states[i];
+                const uint32_t modeset_fields = WLR_OUTPUT_STATE_ENABLED | WLR_OUTPUT_STATE_MODE |
+                    WLR_OUTPUT_STATE_RENDER_FORMAT;
+                const bool enabled = (state.base.committed & WLR_OUTPUT_STATE_ENABLED) ?
+                    state.base.enabled : state.output->enabled;
+                if (enabled && (state.base.committed & modeset_fields))
+                {
+                    ok = attach_black_frame(&swapchains, state);
+                }
+            }
+
+            ok = ok && wlr_backend_commit(get_core().backend, states.data(), states.size());
+            if (ok)
+            {
+                wlr_output_swapchain_manager_apply(&swapchains);
+            }
+
+            wlr_output_swapchain_manager_finish(&swapchains);
+            release_states();
+            if (!ok)
+            {
+                LOGC(OUTPUT, "Atomic commit of the configuration failed, configuring outputs one by one");
+                return false;
+            }
+        }
+
+        LOGC(OUTPUT, "Committed configuration of ", states.size(), " outputs atomically");
+
+        /* Enable outputs first, so that the views of outputs which are turned off can be moved directly
+         * to their final output. */
+        for (bool automatic : {false, true})
+        {
+            for (auto& [handle, state] : config)
+            {
+                if (!(state.source & OUTPUT_IMAGE_SOURCE_SELF) ||
+                    (state.position.is_automatic_position() != automatic))
+                {
+                    continue;
+                }
+
+                if (automatic)
+                {
+                    wlr_output_layout_add_auto(output_layout, handle);
+                } else
+                {
+                    wlr_output_layout_add(output_layout, handle,
+                        state.position.get_x(), state.position.get_y());
+                }
+
+                this->outputs[handle]->apply_committed_state(state);
+            }
+        }
+
+        /* Otherwise, destroy_wayfire_output() might move focus to another output which is going away */
+        auto active = get_core().seat->get_active_output();
+        auto active_it = active ? config.find(active->handle) : config.end();
+        if ((active_it != config.end()) && !(active_it->second.source & OUTPUT_IMAGE_SOURCE_SELF))
+        {
+            get_core().seat->focus_output(this->outputs[surviving->first]->output.get());
+        }
+
+        for (auto& [handle, state] : config)
+        {
+            if (!(state.source & OUTPUT_IMAGE_SOURCE_SELF))
+            {
+                /* Same as in apply_configuration(): clients get wl_surface.leave while the output is still
+                 * in the layout */
+                this->outputs[handle]->apply_committed_state(state);
+                wlr_output_layout_remove(output_layout, handle);
+            }
+        }
+
+        emit_configuration_changed_for_dynamic_outputs(config);
+        timer_remove_noop.set_timeout(1000, [=] ()
+        {
+            remove_noop_output();
+        });
+
+        idle_update_configuration.run_once([=] ()
+        {
+            send_wlr_configuration();
+        });
+
+        return true;
+    }
+
     /** Apply the given configuration. Config MUST be a valid configuration */
     void apply_configuration(const output_configuration_t& config)
     {
@@ -1792,6 +2094,11 @@ class output_layout_t::impl
             LOGC(OUTPUT, "\t  depth: ", entry.second.depth);
         }
 
+        if (apply_configuration_atomically(config))
+        {
+            return;
+        }
+
         /* The order in which we enable and disable outputs is important.
          * Firstly, on some systems where there aren't enough CRTCs, we can
          * only enable a subset of all outputs at once. This means we should
@@ -1,22 +1,43 @@
 #include <sstream>
 #include <algorithm>
+#include <iterator>
+#include <chrono>
 #include <memory>
 #include <filesystem>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "config.h"
 #include "plugin-loader.hpp"
+#include "core-impl.hpp"
 #include "../core/wm.hpp"
 #include "wayfire/plugin.hpp"
+#include "wayfire/task-pool.hpp"
+#include <wayfire/bindings-repository.hpp>
 #include <wayfire/util/log.hpp>
 
+static int64_t microseconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
 wf::plugin_manager_t::plugin_manager_t()
-{}
+{
+    on_lazy_plugin_requested = [=] (wf::lazy_plugin_requested_signal *ev)
+    {
+        ev->initialized |= initialize_lazy_plugin(ev->name);
+    };
+}
 
 void wf::plugin_manager_t::start()
 {
     this->plugins_opt.load_option("core/plugins");
+    this->lazy_plugins_opt.load_option("core/lazy_plugins");
     this->enable_so_unloading.load_option("workarounds/enable_so_unloading");
+    this->parallel_plugin_loading.load_option("workarounds/parallel_plugin_loading");
+    wf::get_core().connect(&on_lazy_plugin_requested);
 
     reload_dynamic_plugins();
     load_static_plugins();
@@ -37,6 +58,17 @@ void wf::plugin_manager_t::deinit_plugins(bool unloadable)
             continue;
         }
 
+        if (!plugin.initialized)
+        {
+            // Lazy plugins which were never used have nothing to deinitialize.
+            if (unloadable)
+            {
+                destroy_plugin(plugin);
+            }
+
+            continue;
+        }
+
         if (plugin.instance->is_unloadable() == unloadable)
         {
             destroy_plugin(plugin);
@@ -56,7 +88,12 @@ wf::plugin_manager_t::~plugin_manager_t()
 void wf::plugin_manager_t::destroy_plugin(wf::loaded_plugin_t& p)
 {
     LOGD("Unloading plugin ", p.so_path);
-    p.instance->fini();
+    remove_lazy_bindings(p);
+    if (p.initialized)
+    {
+        p.instance->fini();
+    }
+
     p.instance.reset();
 
     /* dlopen()/dlclose() do reference counting, so we should close the plugin
@@ -152,25 +189,72 @@ std::pair<void*, void*> wf::get_new_instance_handle(const std::string& path, boo
     return {handle, new_instance_func_ptr};
 }
 
-std::optional<wf::loaded_plugin_t> wf::plugin_manager_t::load_plugin_from_file(std::string path)
+/** Read a file once, so that it is in the page cache when it is opened later. */
+static void prefetch_file(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    char buffer[64 * 1024];
+    while (read(fd, buffer, sizeof(buffer)) > 0)
+    {}
+
+    close(fd);
+}
+
+std::vector<wf::plugin_manager_t::opened_plugin_t> wf::plugin_manager_t::open_plugin_files(
+    const std::vector<std::string>& paths)
+{
+    // dlopen() runs the static initializers of the plugin, which may not expect to run on another thread,
+    // and takes the loader lock, so it is always done on the main thread. Reading the files from disk is
+    // the slow part on a cold start, and that is done in parallel beforehand.
+    if (parallel_plugin_loading)
+    {
+        wf::get_core().task_pool->parallel_for(0, paths.size(), 1, [&] (size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                prefetch_file(paths[i]);
+            }
+        });
+    }
+
+    std::vector<opened_plugin_t> opened(paths.size());
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        opened[i].path = paths[i];
+        std::tie(opened[i].handle, opened[i].new_instance_func) =
+            wf::get_new_instance_handle(paths[i], enable_so_unloading);
+        opened[i].load_time_us = microseconds_since(start);
+    }
+
+    return opened;
+}
+
+std::optional<wf::loaded_plugin_t> wf::plugin_manager_t::create_plugin_instance(opened_plugin_t& opened)
 {
-    auto [handle, new_instance_func_ptr] = wf::get_new_instance_handle(path, enable_so_unloading);
-    if (new_instance_func_ptr)
+    if (opened.new_instance_func)
     {
-        auto new_instance_func = union_cast<void*, wayfire_plugin_load_func>(new_instance_func_ptr);
+        auto new_instance_func = union_cast<void*, wayfire_plugin_load_func>(opened.new_instance_func);
 
         loaded_plugin_t lp;
         try {
+            auto start = std::chrono::steady_clock::now();
             lp.instance  = std::unique_ptr<wf::plugin_interface_t>(new_instance_func());
-            lp.so_handle = handle;
-            lp.so_path   = path;
+            lp.so_handle = opened.handle;
+            lp.so_path   = opened.path;
+            lp.load_time_us = opened.load_time_us + microseconds_since(start);
             return lp;
         } catch (...)
         {
-            LOGE("Failed to load plugin \"", path, "\". ");
+            LOGE("Failed to load plugin \"", opened.path, "\". ");
             if (enable_so_unloading)
             {
-                dlclose(handle);
+                dlclose(opened.handle);
             }
         }
     }
@@ -178,6 +262,173 @@ std::optional<wf::loaded_plugin_t> wf::plugin_manager_t::load_plugin_from_file(s
     return {};
 }
 
+bool wf::plugin_manager_t::init_plugin(loaded_plugin_t& plugin)
+{
+    auto start = std::chrono::steady_clock::now();
+    try {
+        plugin.initialized = true;
+        plugin.instance->init();
+    } catch (...)
+    {
+        // this will call fini(), the destructor and optionally unload the .so
+        destroy_plugin(plugin);
+        LOGE("Failed to init plugin \"", plugin.so_path, "\". ");
+        return false;
+    }
+
+    plugin.init_time_us = microseconds_since(start);
+    LOGD("Initialized plugin ", plugin.so_path, " in ", plugin.init_time_us, "us (loaded in ",
+        plugin.load_time_us, "us)");
+    return true;
+}
+
+/** The callbacks of the placeholder bindings, which must not be called again when forwarding their event. */
+template<class Callback>
+static std::vector<void*> placeholder_callbacks(const std::vector<std::unique_ptr<Callback>>& placeholders)
+{
+    std::vector<void*> result;
+    for (auto& cb : placeholders)
+    {
+        result.push_back(cb.get());
+    }
+
+    return result;
+}
+
+void wf::plugin_manager_t::setup_lazy_bindings(const std::string& name, loaded_plugin_t& plugin)
+{
+    plugin.lazy_bindings = std::make_unique<lazy_plugin_bindings_t>();
+    auto section = wf::get_core().config->get_section(name);
+    if (!section)
+    {
+        return;
+    }
+
+    auto& bindings = wf::get_core().bindings;
+    auto& lazy     = *plugin.lazy_bindings;
+    for (auto& option : section->get_registered_options())
+    {
+        if (auto activator = std::dynamic_pointer_cast<config::option_t<activatorbinding_t>>(option))
+        {
+            lazy.activators.push_back(std::make_unique<activator_callback>(
+                [this, name, activator, &lazy] (const wf::activator_data_t& data)
+            {
+                return initialize_lazy_plugin(name) && wf::get_core().bindings->call_activator_bindings(
+                    activator, data, placeholder_callbacks(lazy.activators));
+            }));
+            bindings->add_activator(activator, lazy.activators.back().get());
+        } else if (auto key = std::dynamic_pointer_cast<config::option_t<keybinding_t>>(option))
+        {
+            lazy.keys.push_back(std::make_unique<key_callback>(
+                [this, name, key, &lazy] (const wf::keybinding_t& pressed)
+            {
+                return initialize_lazy_plugin(name) && wf::get_core().bindings->call_key_bindings(
+                    key, pressed, placeholder_callbacks(lazy.keys));
+            }));
+            bindings->add_key(key, lazy.keys.back().get());
+
+            // Key options may also be used for axis bindings
+            lazy.axes.push_back(std::make_unique<axis_callback>(
+                [this, name, key, &lazy] (wlr_pointer_axis_event *ev)
+            {
+                return initialize_lazy_plugin(name) && wf::get_core().bindings->call_axis_bindings(
+                    key, ev, placeholder_callbacks(lazy.axes));
+            }));
+            bindings->add_axis(key, lazy.axes.back().get());
+        } else if (auto button = std::dynamic_pointer_cast<config::option_t<buttonbinding_t>>(option))
+        {
+            lazy.buttons.push_back(std::make_unique<button_callback>(
+                [this, name, button, &lazy] (const wf::buttonbinding_t& pressed)
+            {
+                return initialize_lazy_plugin(name) && wf::get_core().bindings->call_button_bindings(
+                    button, pressed, placeholder_callbacks(lazy.buttons));
+            }));
+            bindings->add_button(button, lazy.buttons.back().get());
+        }
+    }
+
+    LOGD("Deferring init of plugin ", name, " until first use, ", lazy.activators.size() +
+        lazy.keys.size() + lazy.buttons.size(), " bindings");
+}
+
+void wf::plugin_manager_t::remove_lazy_bindings(loaded_plugin_t& plugin)
+{
+    if (!plugin.lazy_bindings)
+    {
+        return;
+    }
+
+    // The callbacks themselves are kept alive, as one of them may currently be running.
+    auto& lazy = *plugin.lazy_bindings;
+    for (auto& cb : lazy.activators)
+    {
+        wf::get_core().bindings->rem_binding(cb.get());
+    }
+
+    for (auto& cb : lazy.keys)
+    {
+        wf::get_core().bindings->rem_binding(cb.get());
+    }
+
+    for (auto& cb : lazy.buttons)
+    {
+        wf::get_core().bindings->rem_binding(cb.get());
+    }
+
+    for (auto& cb : lazy.axes)
+    {
+        wf::get_core().bindings->rem_binding(cb.get());
+    }
+}
+
+bool wf::plugin_manager_t::initialize_lazy_plugin(const std::string& name)
+{
+    for (auto& [path, plugin] : loaded_plugins)
+    {
+        if (!plugin.instance || plugin.initialized || (get_plugin_name_from_path(path) != name))
+        {
+            continue;
+        }
+
+        LOGI("Initializing plugin ", name, " on first use");
+        remove_lazy_bindings(plugin);
+        return init_plugin(plugin);
+    }
+
+    return false;
+}
+
+std::vector<wf::plugin_load_stats_t> wf::plugin_manager_t::get_load_stats() const
+{
+    std::stringstream lazy_stream{lazy_plugins_opt.value()};
+    std::set<std::string> lazy_names{std::istream_iterator<std::string>{lazy_stream}, {}};
+
+    std::vector<plugin_load_stats_t> stats;
+    for (auto& path : plugin_order)
+    {
+        auto it = loaded_plugins.find(path);
+        if (it == loaded_plugins.end())
+        {
+            continue;
+        }
+
+        plugin_load_stats_t entry;
+        entry.name = get_plugin_name_from_path(path);
+        entry.load_time_us = it->second.load_time_us;
+        entry.init_time_us = it->second.init_time_us;
+        entry.lazy = lazy_names.count(entry.name);
+        entry.initialized = it->second.initialized;
+        stats.push_back(entry);
+    }
+
+    return stats;
+}
+
+std::vector<wf::plugin_load_stats_t> wf::get_plugin_load_stats()
+{
+    return wf::get_core_impl().plugin_mgr->get_load_stats();
+}
+
 void wf::plugin_manager_t::reload_dynamic_plugins()
 {
     is_loading = true;
@@ -231,10 +482,14 @@ void wf::plugin_manager_t::reload_dynamic_plugins()
         }
 
         if ((std::find(next_plugins.begin(), next_plugins.end(), it->first) == next_plugins.end()) &&
-            it->second.instance->is_unloadable())
+            (!it->second.instance || it->second.instance->is_unloadable()))
         {
             LOGD("unload plugin ", it->first.c_str());
-            destroy_plugin(it->second);
+            if (it->second.instance)
+            {
+                destroy_plugin(it->second);
+            }
+
             it = loaded_plugins.erase(it);
         } else
         {
@@ -242,41 +497,63 @@ void wf::plugin_manager_t::reload_dynamic_plugins()
         }
     }
 
-    /* load new plugins */
-    std::vector<std::pair<std::string, wf::loaded_plugin_t>> pending_initialize;
+    plugin_order = next_plugins;
 
+    /* load new plugins */
+    std::vector<std::string> new_plugins;
     for (auto plugin : next_plugins)
     {
-        if (loaded_plugins.count(plugin))
+        if (!loaded_plugins.count(plugin))
         {
-            continue;
+            new_plugins.push_back(plugin);
         }
+    }
 
-        std::optional<wf::loaded_plugin_t> ptr = load_plugin_from_file(plugin);
+    auto load_start = std::chrono::steady_clock::now();
+    auto opened     = open_plugin_files(new_plugins);
+    std::vector<std::pair<std::string, wf::loaded_plugin_t>> pending_initialize;
+    for (auto& plugin : opened)
+    {
+        std::optional<wf::loaded_plugin_t> ptr = create_plugin_instance(plugin);
         if (ptr)
         {
-            pending_initialize.emplace_back(plugin, std::move(*ptr));
+            pending_initialize.emplace_back(plugin.path, std::move(*ptr));
         }
     }
 
+    const int64_t load_time_us = microseconds_since(load_start);
+
     std::stable_sort(pending_initialize.begin(), pending_initialize.end(), [] (const auto& a, const auto& b)
     {
         return a.second.instance->get_order_hint() < b.second.instance->get_order_hint();
     });
 
+    std::stringstream lazy_stream{lazy_plugins_opt.value()};
+    std::set<std::string> lazy_names{std::istream_iterator<std::string>{lazy_stream}, {}};
+
+    auto init_start = std::chrono::steady_clock::now();
     for (auto& [plugin, ptr] : pending_initialize)
     {
-        try {
-            ptr.instance->init();
-            loaded_plugins[plugin] = std::move(ptr);
-        } catch (...)
+        auto name = get_plugin_name_from_path(plugin);
+        if (lazy_names.count(name))
         {
-            // this will call fini(), the destructor and optionally unload the .so
-            destroy_plugin(ptr);
-            LOGE("Failed to init plugin \"", plugin_name, "\". ");
+            auto& lazy_plugin = loaded_plugins[plugin] = std::move(ptr);
+            setup_lazy_bindings(name, lazy_plugin);
+            continue;
+        }
+
+        if (init_plugin(ptr))
+        {
+            loaded_plugins[plugin] = std::move(ptr);
         }
     }
 
+    if (!pending_initialize.empty())
+    {
+        LOGI("Loaded ", pending_initialize.size(), " plugins in ", load_time_us / 1000, "ms, initialized in ",
+            microseconds_since(init_start) / 1000, "ms");
+    }
+
     is_loading = false;
 }
 
@@ -288,6 +565,7 @@ static wf::loaded_plugin_t create_plugin(std::string name)
     lp.so_handle = nullptr;
     lp.so_path   = name;
     lp.instance->init();
+    lp.initialized = true;
     return lp;
 }
 
@@ -336,6 +614,17 @@ std::vector<std::string> wf::get_plugin_paths()
     return plugin_prefixes;
 }
 
+std::string wf::get_plugin_name_from_path(const std::string& path)
+{
+    std::string name = std::filesystem::path(path).stem();
+    if (name.rfind("lib", 0) == 0)
+    {
+        name = name.substr(3);
+    }
+
+    return name;
+}
+
 std::optional<std::string> wf::get_plugin_path_for_name(
     std::vector<std::string> plugin_paths, std::string plugin_name)
 {
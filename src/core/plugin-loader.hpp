@@ -1,13 +1,28 @@
 #pragma once
 
+#include <set>
 #include <vector>
 #include <unordered_map>
 #include "wayfire/plugin.hpp"
 #include "wayfire/util.hpp"
+#include "wayfire/bindings.hpp"
+#include "wayfire/signal-definitions.hpp"
 #include <wayfire/option-wrapper.hpp>
 
 namespace wf
 {
+/**
+ * Placeholder bindings for a plugin in core/lazy_plugins. When one of them is activated, the plugin is
+ * initialized and the event is passed on to the bindings which the plugin registered.
+ */
+struct lazy_plugin_bindings_t
+{
+    std::vector<std::unique_ptr<wf::activator_callback>> activators;
+    std::vector<std::unique_ptr<wf::key_callback>> keys;
+    std::vector<std::unique_ptr<wf::button_callback>> buttons;
+    std::vector<std::unique_ptr<wf::axis_callback>> axes;
+};
+
 struct loaded_plugin_t
 {
     // A pointer to the plugin
@@ -18,6 +33,15 @@ struct loaded_plugin_t
 
     // A path to the .so file of the plugin.
     std::string so_path;
+
+    // Whether init() has been called. Lazily initialized plugins are loaded, but not initialized until
+    // they are used for the first time.
+    bool initialized = false;
+    std::unique_ptr<lazy_plugin_bindings_t> lazy_bindings;
+
+    // Time spent opening the .so file and looking up its symbols, and time spent in init().
+    int64_t load_time_us = 0;
+    int64_t init_time_us = 0;
 };
 
 struct plugin_manager_t
@@ -34,17 +58,45 @@ struct plugin_manager_t
         return is_loading;
     }
 
+    /** Load and init times of all dynamic plugins, in the order they are listed in core/plugins. */
+    std::vector<plugin_load_stats_t> get_load_stats() const;
+
+    /**
+     * Initialize a plugin listed in core/lazy_plugins, if it has not been initialized yet.
+     *
+     * @return Whether the plugin was initialized by this call.
+     */
+    bool initialize_lazy_plugin(const std::string& name);
+
   private:
     wf::option_wrapper_t<std::string> plugins_opt;
+    wf::option_wrapper_t<std::string> lazy_plugins_opt;
     wf::option_wrapper_t<bool> enable_so_unloading;
+    wf::option_wrapper_t<bool> parallel_plugin_loading;
     std::unordered_map<std::string, loaded_plugin_t> loaded_plugins;
+    std::vector<std::string> plugin_order;
 
     void deinit_plugins(bool unloadable);
 
-    std::optional<loaded_plugin_t> load_plugin_from_file(std::string path);
+    /** The result of opening a plugin's .so file. */
+    struct opened_plugin_t
+    {
+        std::string path;
+        void *handle = nullptr;
+        void *new_instance_func = nullptr;
+        int64_t load_time_us    = 0;
+    };
+
+    std::vector<opened_plugin_t> open_plugin_files(const std::vector<std::string>& paths);
+    std::optional<loaded_plugin_t> create_plugin_instance(opened_plugin_t& opened);
+    bool init_plugin(loaded_plugin_t& plugin);
+    void setup_lazy_bindings(const std::string& name, loaded_plugin_t& plugin);
+    void remove_lazy_bindings(loaded_plugin_t& plugin);
     void load_static_plugins();
     void destroy_plugin(loaded_plugin_t& plugin);
 
+    wf::signal::connection_t<wf::lazy_plugin_requested_signal> on_lazy_plugin_requested;
+
     bool is_loading = false;
 };
 
@@ -87,4 +139,7 @@ std::vector<std::string> get_plugin_paths();
  */
 std::optional<std::string> get_plugin_path_for_name(
     std::vector<std::string> plugin_paths, std::string plugin_name);
+
+/** Get the name of a plugin from the path to its .so file, i.e. /path/to/libname.so -> name. */
+std::string get_plugin_name_from_path(const std::string& path);
 }
@@ -3,6 +3,7 @@
 #include <wayfire/util/log.hpp>
 #include <wayfire/config-backend.hpp>
 #include <wayfire/plugin.hpp>
+#include <wayfire/signal-definitions.hpp>
 #include <libudev.h>
 #include <filesystem>
 #include <wayfire/plugin.hpp>
@@ -152,6 +153,74 @@ std::vector<std::string> wf::config_backend_t::get_xml_dirs() const
     return xmldirs;
 }
 
+wf::config_backend_t::config_snapshot_t wf::config_backend_t::take_config_snapshot(
+    const config::config_manager_t& config)
+{
+    config_snapshot_t snapshot;
+    for (auto& section : config.get_all_sections())
+    {
+        auto& values = snapshot[section->get_name()];
+        for (auto& option : section->get_registered_options())
+        {
+            values.emplace(option->get_name(), option->get_value_str());
+        }
+    }
+
+    return snapshot;
+}
+
+bool wf::config_backend_t::diff_config_snapshot(const config_snapshot_t& before,
+    const config::config_manager_t& config, reload_config_signal& ev)
+{
+    ev.changed_sections = std::set<std::string>{};
+    ev.changed_options.clear();
+
+    size_t kept_sections = 0;
+    for (auto& section : config.get_all_sections())
+    {
+        auto it = before.find(section->get_name());
+        if (it == before.end())
+        {
+            ev.changed_sections->insert(section->get_name());
+            continue;
+        }
+
+        ++kept_sections;
+
+        const auto& old_values = it->second;
+        auto options = section->get_registered_options();
+        bool changed = (options.size() != old_values.size());
+        for (auto& option : options)
+        {
+            auto old_value = old_values.find(option->get_name());
+            if ((old_value == old_values.end()) || (old_value->second != option->get_value_str()))
+            {
+                ev.changed_options.insert(option);
+                changed = true;
+            }
+        }
+
+        if (changed)
+        {
+            ev.changed_sections->insert(section->get_name());
+        }
+    }
+
+    // Some sections were removed
+    if (kept_sections != before.size())
+    {
+        for (auto& [name, _] : before)
+        {
+            if (!config.get_section(name))
+            {
+                ev.changed_sections->insert(name);
+            }
+        }
+    }
+
+    return !ev.changed_sections->empty();
+}
+
 bool wf::config_backend_t::reload_config_metadata(config::config_manager_t& config)
 {
     return false;
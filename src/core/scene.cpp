@@ -234,6 +234,11 @@ class default_render_instance_t : public render_instance_t
         // from being scanned out.
         return direct_scanout::SKIP;
     }
+
+    void collect_plane_candidates(wf::output_t *output, plane_collector_t& collector) override
+    {
+        // Nothing is drawn, so nothing is occluded.
+    }
 };
 
 void node_t::gen_render_instances(std::vector<render_instance_uptr> & instances,
@@ -503,6 +508,17 @@ class output_render_instance_t : public default_render_instance_t
         auto offset = wf::origin(output->get_layout_geometry());
         compute_visibility_from_list(children, output, visible, offset);
     }
+
+    void collect_plane_candidates(wf::output_t *output, plane_collector_t& collector) override
+    {
+        if (!self->get_output() || ((output != self->get_output()) && self->limit_region))
+        {
+            return;
+        }
+
+        auto offset = wf::origin(self->get_output()->get_layout_geometry());
+        collect_plane_candidates_from_list(children, output, collector, offset);
+    }
 };
 
 void output_node_t::gen_render_instances(
@@ -53,8 +53,33 @@ struct wf::bindings_repository_t::impl
 
     hotspot_manager_t hotspot_mgr;
 
+    /** Whether the value of any activator binding may have changed in the given reload. */
+    bool activators_changed(wf::reload_config_signal *ev) const
+    {
+        // Plugins which parse extension bindings may have been (un)loaded.
+        if (ev->section_changed("core"))
+        {
+            return true;
+        }
+
+        for (auto& binding : activators)
+        {
+            if (ev->option_changed(binding->activated_by))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     wf::signal::connection_t<wf::reload_config_signal> on_config_reload = [=] (wf::reload_config_signal *ev)
     {
+        if (!activators_changed(ev))
+        {
+            return;
+        }
+
         recreate_hotspots();
         reparse_extensions();
     };
@@ -240,6 +240,54 @@ bool wf::bindings_repository_t::handle_extension_generic(
     return handled;
 }
 
+template<class Option, class Callback, class Argument>
+static bool call_bindings_for_option(const wf::binding_container_t<Option, Callback>& bindings,
+    const wf::option_sptr_t<Option>& option, const std::vector<void*>& skip, const Argument& argument)
+{
+    // Callbacks may add or remove bindings, so collect them first.
+    std::vector<Callback*> callbacks;
+    for (auto& binding : bindings)
+    {
+        if ((binding->activated_by == option) &&
+            (std::find(skip.begin(), skip.end(), (void*)binding->callback) == skip.end()))
+        {
+            callbacks.push_back(binding->callback);
+        }
+    }
+
+    bool handled = false;
+    for (auto callback : callbacks)
+    {
+        handled |= (*callback)(argument);
+    }
+
+    return handled;
+}
+
+bool wf::bindings_repository_t::call_key_bindings(const option_sptr_t<keybinding_t>& key,
+    const wf::keybinding_t& pressed, const std::vector<void*>& skip)
+{
+    return call_bindings_for_option(priv->keys, key, skip, pressed);
+}
+
+bool wf::bindings_repository_t::call_axis_bindings(const option_sptr_t<keybinding_t>& axis,
+    wlr_pointer_axis_event *ev, const std::vector<void*>& skip)
+{
+    return call_bindings_for_option(priv->axes, axis, skip, ev);
+}
+
+bool wf::bindings_repository_t::call_button_bindings(const option_sptr_t<buttonbinding_t>& button,
+    const wf::buttonbinding_t& pressed, const std::vector<void*>& skip)
+{
+    return call_bindings_for_option(priv->buttons, button, skip, pressed);
+}
+
+bool wf::bindings_repository_t::call_activator_bindings(const option_sptr_t<activatorbinding_t>& activator,
+    const wf::activator_data_t& data, const std::vector<void*>& skip)
+{
+    return call_bindings_for_option(priv->activators, activator, skip, data);
+}
+
 void wf::bindings_repository_t::rem_binding(void *callback)
 {
     const auto& erase = [callback] (auto& container)
@@ -21,8 +21,13 @@ wf::cursor_t::cursor_t(wf::seat_t *seat)
     init_xcursor();
     init_cursor_shape_manager();
 
-    config_reloaded = [=] (auto)
+    config_reloaded = [=] (wf::reload_config_signal *ev)
     {
+        if (!ev->section_changed("input"))
+        {
+            return;
+        }
+
         init_xcursor();
     };
 
@@ -18,8 +18,13 @@
 
 void wf::keyboard_t::setup_listeners()
 {
-    on_config_reload = [=] (auto)
+    on_config_reload = [=] (wf::reload_config_signal *ev)
     {
+        if (!ev->section_or_instances_changed("input") && !ev->section_or_instances_changed("input-device"))
+        {
+            return;
+        }
+
         reload_input_options();
     };
     wf::get_core().connect(&on_config_reload);
@@ -10,6 +10,7 @@
 #include <wayfire/util/log.hpp>
 #include <wayfire/core.hpp>
 #include <wayfire/output-layout.hpp>
+#include <wayfire/output.hpp>
 
 wf::pointer_t::pointer_t(nonstd::observer_ptr<wf::input_manager_t> input,
     nonstd::observer_ptr<seat_t> seat)
@@ -33,10 +34,26 @@ wf::pointer_t::pointer_t(nonstd::observer_ptr<wf::input_manager_t> input,
     };
 
     wf::get_core().scene()->connect(&on_root_node_updated);
+
+    flush_motion_hook = [=] ()
+    {
+        flush_pending_motion();
+    };
+
+    on_output_pre_remove = [=] (wf::output_pre_remove_signal *ev)
+    {
+        if (ev->output == pending_motion_output)
+        {
+            flush_pending_motion();
+        }
+    };
+    wf::get_core().output_layout->connect(&on_output_pre_remove);
 }
 
 wf::pointer_t::~pointer_t()
-{}
+{
+    cancel_pending_motion();
+}
 
 bool wf::pointer_t::has_pressed_buttons() const
 {
@@ -70,6 +87,9 @@ bool wf::pointer_t::focus_enabled() const
 
 void wf::pointer_t::update_cursor_position(int64_t time_msec)
 {
+    // Any deferred motion is covered by this update.
+    cancel_pending_motion();
+
     wf::pointf_t gc   = seat->priv->cursor->get_cursor_position();
     const auto& scene = wf::get_core().scene();
     auto isec    = scene->find_node_at(gc);
@@ -280,6 +300,8 @@ wf::input_grab_kind_t wf::pointer_t::get_current_grab_kind() const
 void wf::pointer_t::handle_pointer_button(wlr_pointer_button_event *ev,
     input_event_processing_mode_t mode)
 {
+    // Make sure the button goes to the node under the cursor.
+    flush_pending_motion();
     seat->priv->break_mod_bindings();
     bool handled_in_binding = (mode != input_event_processing_mode_t::FULL);
 
@@ -391,7 +413,7 @@ void wf::pointer_t::handle_pointer_motion(wlr_pointer_motion_event *ev,
 {
     /* XXX: maybe warp directly? */
     wlr_cursor_move(seat->priv->cursor->cursor, &ev->pointer->base, ev->delta_x, ev->delta_y);
-    update_cursor_position(ev->time_msec);
+    handle_cursor_motion(ev->time_msec);
 }
 
 void wf::pointer_t::handle_pointer_motion_absolute(
@@ -411,12 +433,86 @@ void wf::pointer_t::handle_pointer_motion_absolute(
 
     // TODO: indirection via wf_cursor
     wlr_cursor_warp_closest(seat->priv->cursor->cursor, NULL, cx, cy);
-    update_cursor_position(ev->time_msec);
+    handle_cursor_motion(ev->time_msec);
+}
+
+void wf::pointer_t::handle_cursor_motion(uint32_t time_msec)
+{
+    motion_stats.motion_events++;
+    if (!coalesce_motion)
+    {
+        motion_stats.position_updates++;
+        update_cursor_position(time_msec);
+        return;
+    }
+
+    // Clients get every motion event with its original timestamp. Plugins with an explicit grab only need
+    // the latest position once per frame. Relative motion has already been sent by the focused surface's
+    // pre-event handler, independently of this.
+    if (get_current_grab_kind() != input_grab_kind_t::EXPLICIT)
+    {
+        motion_stats.forwarded_events++;
+        send_motion(time_msec);
+    }
+
+    pending_motion_time = time_msec;
+    if (motion_pending)
+    {
+        return;
+    }
+
+    auto gc     = seat->priv->cursor->get_cursor_position();
+    auto output = wf::get_core().output_layout->find_closest_output(gc);
+    if (!output)
+    {
+        motion_stats.position_updates++;
+        update_cursor_position(time_msec);
+        return;
+    }
+
+    motion_pending = true;
+    pending_motion_output = output;
+    output->render->add_effect(&flush_motion_hook, OUTPUT_EFFECT_PRE);
+    output->render->schedule_redraw();
+
+    // Two frames at 30Hz, in case the output is disabled or does not repaint for another reason.
+    motion_flush_timer.set_timeout(66, [=] ()
+    {
+        flush_pending_motion();
+    });
+}
+
+void wf::pointer_t::flush_pending_motion()
+{
+    if (motion_pending)
+    {
+        motion_stats.position_updates++;
+        update_cursor_position(pending_motion_time);
+    }
+}
+
+void wf::pointer_t::cancel_pending_motion()
+{
+    if (!motion_pending)
+    {
+        return;
+    }
+
+    motion_pending = false;
+    motion_flush_timer.disconnect();
+    pending_motion_output->render->rem_effect(&flush_motion_hook);
+    pending_motion_output = nullptr;
+}
+
+wf::pointer_motion_stats_t wf::pointer_t::get_motion_stats() const
+{
+    return motion_stats;
 }
 
 void wf::pointer_t::handle_pointer_axis(wlr_pointer_axis_event *ev,
     input_event_processing_mode_t mode)
 {
+    flush_pending_motion();
     bool handled_in_binding = wf::get_core().bindings->handle_axis(
         seat->priv->get_modifiers(), ev);
     seat->priv->break_mod_bindings();
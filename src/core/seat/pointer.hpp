@@ -9,6 +9,9 @@
 #include "wayfire/scene-input.hpp"
 #include "wayfire/signal-definitions.hpp"
 #include "wayfire/signal-provider.hpp"
+#include <wayfire/output-layout.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/seat.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
 
 namespace wf
@@ -82,6 +85,21 @@ class pointer_t
      */
     void update_cursor_position(int64_t time_msec);
 
+    /**
+     * Handle a motion of the cursor which has already been applied to the wlr_cursor.
+     *
+     * When input/coalesce_pointer_motion is enabled, the focused client still receives the motion right away,
+     * but finding the node under the cursor and delivering motion to explicit grabs is deferred until the
+     * next frame of the output under the cursor. All motion events within a frame are handled by a single
+     * position update.
+     *
+     * @param time_msec The time when the motion event occurred
+     */
+    void handle_cursor_motion(uint32_t time_msec);
+
+    /** Get the number of motion events and the number of position updates they caused. */
+    pointer_motion_stats_t get_motion_stats() const;
+
     /**
      * Transfer focus and pressed buttons to the given grab.
      */
@@ -151,6 +169,24 @@ class pointer_t
      * Send synthetic button release events to the old cursor focus.
      */
     void send_leave_to_focus(wf::scene::node_ptr old_focus);
+
+    /* Pointer motion coalescing */
+    wf::option_wrapper_t<bool> coalesce_motion{"input/coalesce_pointer_motion"};
+    pointer_motion_stats_t motion_stats;
+
+    /** Whether there is motion whose position update was deferred to the next frame. */
+    bool motion_pending = false;
+    uint32_t pending_motion_time = 0;
+    wf::output_t *pending_motion_output = nullptr;
+    wf::effect_hook_t flush_motion_hook;
+    /** Flushes deferred motion if the output does not present a frame in time, e.g. when it is disabled. */
+    wf::wl_timer<false> motion_flush_timer;
+
+    wf::signal::connection_t<wf::output_pre_remove_signal> on_output_pre_remove;
+
+    /** Run the deferred position update, if any. */
+    void flush_pending_motion();
+    void cancel_pending_motion();
 };
 }
 
@@ -253,6 +253,11 @@ void wf::seat_t::notify_activity()
     wf::get_core().emit(&data);
 }
 
+wf::pointer_motion_stats_t wf::seat_t::get_pointer_motion_stats() const
+{
+    return priv->lpointer ? priv->lpointer->get_motion_stats() : pointer_motion_stats_t{};
+}
+
 std::vector<uint32_t> wf::seat_t::get_pressed_keys()
 {
     std::vector<uint32_t> pressed_keys{priv->pressed_keys.begin(), priv->pressed_keys.end()};
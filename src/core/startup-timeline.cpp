@@ -0,0 +1,109 @@
+#include "startup-timeline.hpp"
+#include "core-impl.hpp"
+#include <algorithm>
+#include <wayfire/util/log.hpp>
+
+/** How long to wait for unfinished phases after the first commit before reporting the timeline anyway. */
+static constexpr int REPORT_TIMEOUT_MS = 10000;
+
+void wf::startup_timeline_t::set_origin(clock::time_point origin)
+{
+    this->origin = origin;
+}
+
+int64_t wf::startup_timeline_t::now_us() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - origin).count();
+}
+
+void wf::startup_timeline_t::begin_phase(const std::string& name)
+{
+    auto it = std::find_if(phases.begin(), phases.end(), [&] (const auto& phase) { return phase.name == name; });
+    if (it != phases.end())
+    {
+        LOGE("Startup phase ", name, " started twice!");
+        return;
+    }
+
+    phases.push_back({name, now_us(), -1});
+}
+
+void wf::startup_timeline_t::end_phase(const std::string& name)
+{
+    auto it = std::find_if(phases.begin(), phases.end(), [&] (const auto& phase) { return phase.name == name; });
+    if ((it == phases.end()) || (it->duration_us >= 0))
+    {
+        return;
+    }
+
+    it->duration_us = now_us() - it->start_us;
+    report_if_finished();
+}
+
+void wf::startup_timeline_t::mark_first_commit()
+{
+    if (first_commit)
+    {
+        return;
+    }
+
+    first_commit    = true;
+    first_commit_us = now_us();
+    phases.push_back({"first-commit", first_commit_us, 0});
+    report_if_finished();
+    if (!reported)
+    {
+        report_timeout.set_timeout(REPORT_TIMEOUT_MS, [=] () { report(); });
+    }
+}
+
+bool wf::startup_timeline_t::has_first_commit() const
+{
+    return first_commit;
+}
+
+const std::vector<wf::startup_phase_t>& wf::startup_timeline_t::get_phases() const
+{
+    return phases;
+}
+
+void wf::startup_timeline_t::report_if_finished()
+{
+    const bool all_finished = std::all_of(phases.begin(), phases.end(),
+        [] (const auto& phase) { return phase.duration_us >= 0; });
+    if (reported || !first_commit || !all_finished)
+    {
+        return;
+    }
+
+    report();
+}
+
+void wf::startup_timeline_t::report()
+{
+    reported = true;
+    report_timeout.disconnect();
+    LOGI("Startup timeline (first frame after ", first_commit_us / 1000.0, " ms):");
+    for (auto& phase : phases)
+    {
+        if (phase.duration_us >= 0)
+        {
+            LOGI("    ", phase.name, ": started at ", phase.start_us / 1000.0, " ms, took ",
+                phase.duration_us / 1000.0, " ms");
+        } else
+        {
+            LOGI("    ", phase.name, ": started at ", phase.start_us / 1000.0, " ms, not finished after ",
+                (now_us() - phase.start_us) / 1000.0, " ms");
+        }
+    }
+}
+
+void wf::startup_timeline_t::fini()
+{
+    report_timeout.disconnect();
+}
+
+std::vector<wf::startup_phase_t> wf::get_startup_timeline()
+{
+    return wf::get_core_impl().startup_timeline.get_phases();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "wayfire/core.hpp"
+#include "wayfire/util.hpp"
+
+namespace wf
+{
+/**
+ * Records how long the individual steps of compositor startup take, from process start to the first
+ * committed frame. The timeline is printed to the log once the first frame has been committed and all
+ * phases have finished, or a while after the first commit if some phase never finishes.
+ */
+class startup_timeline_t
+{
+  public:
+    using clock = std::chrono::steady_clock;
+
+    /** Set the point from which phases are measured. Defaults to the creation of the timeline. */
+    void set_origin(clock::time_point origin);
+
+    /** Start a new phase. Phases with the same name are not allowed. */
+    void begin_phase(const std::string& name);
+
+    /** Finish the phase with the given name. Unknown or already finished phases are ignored. */
+    void end_phase(const std::string& name);
+
+    /** Record the first output commit. Only the first call has an effect. */
+    void mark_first_commit();
+
+    /** Whether an output has committed a frame yet. */
+    bool has_first_commit() const;
+
+    const std::vector<startup_phase_t>& get_phases() const;
+
+    /** Stop waiting for unfinished phases. Must be called before the event loop is destroyed. */
+    void fini();
+
+  private:
+    clock::time_point origin = clock::now();
+    std::vector<startup_phase_t> phases;
+    bool first_commit = false;
+    int64_t first_commit_us = 0;
+    bool reported = false;
+    // Reports the timeline if some phase (for example Xwayland) is still running long after the first commit.
+    wf::wl_timer<false> report_timeout;
+
+    int64_t now_us() const;
+    void report_if_finished();
+    void report();
+};
+}
@@ -0,0 +1,329 @@
+#include "wayfire/task-pool.hpp"
+#include <wayfire/util/log.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+namespace
+{
+thread_local bool current_thread_is_worker = false;
+
+struct pool_job_t
+{
+    wf::task_pool_t::job_t job;
+    wf::task_pool_t::job_t on_done;
+};
+
+/** The shared state of a single parallel_for() invocation. */
+struct range_state_t
+{
+    const wf::task_pool_t::range_job_t *job;
+    size_t begin;
+    size_t end;
+    size_t chunk;
+    size_t num_chunks;
+
+    std::atomic<size_t> next_chunk{0};
+    std::atomic<size_t> done_chunks{0};
+
+    std::mutex mutex;
+    std::condition_variable finished;
+
+    /** Process chunks until there are none left. */
+    void run_chunks()
+    {
+        size_t processed = 0;
+        for (size_t i = next_chunk++; i < num_chunks; i = next_chunk++)
+        {
+            const size_t chunk_begin = begin + i * chunk;
+            (*job)(chunk_begin, std::min(end, chunk_begin + chunk));
+            ++processed;
+        }
+
+        if ((processed > 0) && (done_chunks += processed) == num_chunks)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.notify_all();
+        }
+    }
+};
+}
+
+struct wf::task_pool_t::impl
+{
+    struct worker_t
+    {
+        std::thread thread;
+        std::mutex mutex;
+        std::deque<pool_job_t> jobs;
+    };
+
+    std::vector<std::unique_ptr<worker_t>> workers;
+    std::atomic<size_t> next_worker{0};
+
+    /* Sleeping workers wait on this until there are queued jobs. */
+    std::mutex sleep_mutex;
+    std::condition_variable wake_up;
+    std::atomic<int> queued_jobs{0};
+    bool stopping = false;
+
+    /* Completion callbacks waiting to be run on the main thread. */
+    std::mutex done_mutex;
+    std::vector<job_t> done_callbacks;
+    int event_fd = -1;
+    wl_event_source *event_source = nullptr;
+
+    void push(pool_job_t job)
+    {
+        auto& worker = *workers[next_worker++ % workers.size()];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.jobs.push_back(std::move(job));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            ++queued_jobs;
+        }
+
+        wake_up.notify_one();
+    }
+
+    /**
+     * Take the newest job from the worker's own queue, or steal the oldest job from another worker.
+     */
+    bool pop(size_t self, pool_job_t& out)
+    {
+        for (size_t k = 0; k < workers.size(); k++)
+        {
+            auto& worker = *workers[(self + k) % workers.size()];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.jobs.empty())
+            {
+                continue;
+            }
+
+            if (k == 0)
+            {
+                out = std::move(worker.jobs.back());
+                worker.jobs.pop_back();
+            } else
+            {
+                out = std::move(worker.jobs.front());
+                worker.jobs.pop_front();
+            }
+
+            --queued_jobs;
+            return true;
+        }
+
+        return false;
+    }
+
+    void worker_main(size_t self)
+    {
+        current_thread_is_worker = true;
+        while (true)
+        {
+            pool_job_t job;
+            if (pop(self, job))
+            {
+                job.job();
+                if (job.on_done)
+                {
+                    complete(std::move(job.on_done));
+                }
+
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            wake_up.wait(lock, [&] { return stopping || (queued_jobs > 0); });
+            if (stopping)
+            {
+                return;
+            }
+        }
+    }
+
+    void complete(job_t callback)
+    {
+        {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            done_callbacks.push_back(std::move(callback));
+        }
+
+        uint64_t one = 1;
+        if (write(event_fd, &one, sizeof(one)) != sizeof(one))
+        {
+            LOGE("Failed to signal task completion: ", strerror(errno));
+        }
+    }
+
+    static int handle_completions(int fd, uint32_t mask, void *data)
+    {
+        auto self = (impl*)data;
+
+        uint64_t count;
+        if (read(fd, &count, sizeof(count)) != sizeof(count))
+        {
+            return 0;
+        }
+
+        std::vector<job_t> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(self->done_mutex);
+            std::swap(callbacks, self->done_callbacks);
+        }
+
+        for (auto& cb : callbacks)
+        {
+            cb();
+        }
+
+        return 0;
+    }
+};
+
+wf::task_pool_t::task_pool_t(wl_event_loop *loop, int num_workers)
+{
+    priv = std::make_unique<impl>();
+    if (num_workers <= 0)
+    {
+        return;
+    }
+
+    priv->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (priv->event_fd < 0)
+    {
+        LOGE("Failed to create eventfd for the task pool, running jobs inline: ", strerror(errno));
+        return;
+    }
+
+    priv->event_source = wl_event_loop_add_fd(loop, priv->event_fd, WL_EVENT_READABLE,
+        impl::handle_completions, priv.get());
+
+    for (int i = 0; i < num_workers; i++)
+    {
+        priv->workers.push_back(std::make_unique<impl::worker_t>());
+    }
+
+    for (int i = 0; i < num_workers; i++)
+    {
+        priv->workers[i]->thread = std::thread([this, i] { priv->worker_main(i); });
+        pthread_setname_np(priv->workers[i]->thread.native_handle(),
+            ("wf-worker-" + std::to_string(i)).c_str());
+    }
+
+    LOGI("Started task pool with ", num_workers, " worker threads");
+}
+
+wf::task_pool_t::~task_pool_t()
+{
+    {
+        std::lock_guard<std::mutex> lock(priv->sleep_mutex);
+        priv->stopping = true;
+    }
+
+    /* Jobs which have not started yet are discarded, running jobs are waited for below. */
+    for (auto& worker : priv->workers)
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        priv->queued_jobs -= worker->jobs.size();
+        worker->jobs.clear();
+    }
+
+    priv->wake_up.notify_all();
+    for (auto& worker : priv->workers)
+    {
+        worker->thread.join();
+    }
+
+    if (priv->event_source)
+    {
+        wl_event_source_remove(priv->event_source);
+    }
+
+    if (priv->event_fd >= 0)
+    {
+        close(priv->event_fd);
+    }
+}
+
+void wf::task_pool_t::submit(job_t job, job_t on_done)
+{
+    if (priv->workers.empty())
+    {
+        job();
+        if (on_done)
+        {
+            on_done();
+        }
+
+        return;
+    }
+
+    priv->push({std::move(job), std::move(on_done)});
+}
+
+void wf::task_pool_t::parallel_for(size_t begin, size_t end, size_t min_chunk, const range_job_t& job)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    const size_t length = end - begin;
+    min_chunk = std::max<size_t>(min_chunk, 1);
+    if (priv->workers.empty() || current_thread_is_worker || (length <= min_chunk))
+    {
+        job(begin, end);
+        return;
+    }
+
+    // Use a few chunks per thread so that threads which get preempted do not hold back the others.
+    const size_t threads = priv->workers.size() + 1;
+    const size_t chunk   = std::max(min_chunk, (length + 4 * threads - 1) / (4 * threads));
+
+    auto state = std::make_shared<range_state_t>();
+    state->job   = &job;
+    state->begin = begin;
+    state->end   = end;
+    state->chunk = chunk;
+    state->num_chunks = (length + chunk - 1) / chunk;
+
+    const size_t helpers = std::min(priv->workers.size(), state->num_chunks - 1);
+    for (size_t i = 0; i < helpers; i++)
+    {
+        // Helpers which start after all chunks are taken return immediately, so @job is never used after
+        // this function has returned.
+        priv->push({[state] { state->run_chunks(); }, {}});
+    }
+
+    state->run_chunks();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&] { return state->done_chunks == state->num_chunks; });
+}
+
+int wf::task_pool_t::get_num_workers() const
+{
+    return priv->workers.size();
+}
+
+bool wf::task_pool_t::is_worker_thread()
+{
+    return current_thread_is_worker;
+}
@@ -1,10 +1,15 @@
 #include "core/core-impl.hpp"
 #include "wayfire/opengl.hpp"
 #include <wayfire/vulkan.hpp>
+#include <algorithm>
 #include <fstream>
+#include <filesystem>
+#include <wayfire/task-pool.hpp>
 #include <wayfire/util/log.hpp>
 #include <drm_fourcc.h>
 #include <cstring>
+#include <iomanip>
+#include <sstream>
 #include <glm/gtc/matrix_transform.hpp>
 
 extern "C"
@@ -34,6 +39,53 @@ static uint32_t find_memory_type(VkPhysicalDevice physical_device, uint32_t type
     return UINT32_MAX;
 }
 
+/**
+ * Create a buffer backed by its own host-visible and host-coherent memory.
+ */
+static bool create_host_visible_buffer(VkDevice device, VkPhysicalDevice physical_device, VkDeviceSize size,
+    VkBufferUsageFlags usage, VkBuffer& buffer, VkDeviceMemory& memory)
+{
+    VkBufferCreateInfo buffer_info{};
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size  = size;
+    buffer_info.usage = usage;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(device, &buffer_info, nullptr, &buffer) != VK_SUCCESS)
+    {
+        LOGE("Failed to create GPU buffer");
+        return false;
+    }
+
+    VkMemoryRequirements mem_requirements;
+    vkGetBufferMemoryRequirements(device, buffer, &mem_requirements);
+
+    uint32_t memory_type = find_memory_type(physical_device,
+        mem_requirements.memoryTypeBits,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    if (memory_type == UINT32_MAX)
+    {
+        LOGE("Failed to find suitable memory type for GPU buffer");
+        vkDestroyBuffer(device, buffer, nullptr);
+        return false;
+    }
+
+    VkMemoryAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize  = mem_requirements.size;
+    alloc_info.memoryTypeIndex = memory_type;
+
+    if (vkAllocateMemory(device, &alloc_info, nullptr, &memory) != VK_SUCCESS)
+    {
+        LOGE("Failed to allocate memory for GPU buffer");
+        vkDestroyBuffer(device, buffer, nullptr);
+        return false;
+    }
+
+    vkBindBufferMemory(device, buffer, memory, 0);
+    return true;
+}
+
 // --- gpu_buffer_t implementation ---
 gpu_buffer_t::gpu_buffer_t(std::shared_ptr<context_t> ctx, VkBuffer buffer, VkDeviceMemory memory,
     VkDeviceSize size) :
@@ -123,10 +175,70 @@ command_buffer_t::command_buffer_t(std::shared_ptr<context_t> ctx, wf::render_pa
     this->wlr_pass     = pass.get_wlr_pass();
 }
 
+/**
+ * The blocks of the per-frame allocator used by a single command buffer. Allocations are made linearly from
+ * the last block, and all blocks are returned to the context at once when the command buffer is reset.
+ */
+struct frame_arena_t
+{
+    std::vector<context_t::frame_block_t> blocks;
+    // Offset of the first free byte in the last block.
+    VkDeviceSize offset = 0;
+    // Total bytes allocated, including alignment padding.
+    VkDeviceSize used = 0;
+
+    frame_allocation_t allocate(context_t& context, VkDeviceSize size, VkDeviceSize alignment)
+    {
+        if (context.min_frame_alignment == 0)
+        {
+            VkPhysicalDeviceProperties props;
+            vkGetPhysicalDeviceProperties(context.physical_device, &props);
+            context.min_frame_alignment = std::max<VkDeviceSize>(
+                props.limits.minUniformBufferOffsetAlignment, 4);
+        }
+
+        const VkDeviceSize used_before = used;
+        alignment = std::max(alignment, context.min_frame_alignment);
+        VkDeviceSize aligned_offset = (offset + alignment - 1) / alignment * alignment;
+        if (blocks.empty() || (aligned_offset + size > blocks.back().size))
+        {
+            auto block = context.acquire_frame_block(size);
+            if (block.buffer == VK_NULL_HANDLE)
+            {
+                return {};
+            }
+
+            used += blocks.empty() ? 0 : blocks.back().size - offset;
+            blocks.push_back(block);
+            offset = 0;
+            aligned_offset = 0;
+        }
+
+        used  += aligned_offset + size - offset;
+        offset = aligned_offset + size;
+        context.frame_stats.allocations++;
+        context.frame_stats.in_flight_bytes += used - used_before;
+
+        auto& block = blocks.back();
+        return frame_allocation_t{
+            .buffer = block.buffer,
+            .offset = aligned_offset,
+            .size   = size,
+            .data   = block.mapping + aligned_offset,
+        };
+    }
+};
+
 command_buffer_t::~command_buffer_t()
 {
     bound_pipelines.clear();
     bound_buffers.clear();
+    if (arena)
+    {
+        context->release_frame_blocks(arena->blocks, arena->used);
+        arena.reset();
+    }
+
     reset_signal data;
     emit(&data);
 }
@@ -158,6 +270,27 @@ void command_buffer_t::bind_texture(const std::shared_ptr<wf::texture_t>& textur
     bound_textures.push_back(texture);
 }
 
+frame_allocation_t command_buffer_t::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    if (!arena)
+    {
+        arena = std::make_unique<frame_arena_t>();
+    }
+
+    return arena->allocate(*context, size, alignment);
+}
+
+frame_allocation_t command_buffer_t::upload(const void *data, VkDeviceSize size, VkDeviceSize alignment)
+{
+    auto allocation = allocate(size, alignment);
+    if (allocation.data)
+    {
+        std::memcpy(allocation.data, data, size);
+    }
+
+    return allocation;
+}
+
 std::pair<VkPipelineLayout, VkPipeline> command_buffer_t::bind_pipeline(
     std::shared_ptr<graphics_pipeline_t> pipeline,
     const wf::render_target_t& target, const pipeline_specialization_t& specialization)
@@ -209,10 +342,170 @@ context_t::context_t(wlr_renderer *renderer) : renderer(renderer)
 
     // Get the graphics queue
     vkGetDeviceQueue(device, queue_family, 0, &queue);
+    create_pipeline_cache();
+}
+
+context_t::context_t(VkPhysicalDevice physical_device, VkDevice device, VkQueue queue) :
+    device(device), physical_device(physical_device), queue(queue)
+{
+    create_pipeline_cache();
 }
 
 context_t::~context_t()
-{}
+{
+    for (auto& block : idle_frame_blocks)
+    {
+        destroy_frame_block(block);
+    }
+
+    save_pipeline_cache_timer.disconnect();
+    if (pipeline_cache != VK_NULL_HANDLE)
+    {
+        save_pipeline_cache();
+        vkDestroyPipelineCache(device, pipeline_cache, nullptr);
+    }
+}
+
+static std::string get_pipeline_cache_dir()
+{
+    if (const char *cache_home = getenv("XDG_CACHE_HOME"); cache_home && *cache_home)
+    {
+        return std::string(cache_home) + "/wayfire";
+    }
+
+    if (const char *home = getenv("HOME"); home && *home)
+    {
+        return std::string(home) + "/.cache/wayfire";
+    }
+
+    return "";
+}
+
+/**
+ * Check that the cache data was created by the same device, as described by the header in the Vulkan spec.
+ * Drivers are required to reject incompatible data themselves, but not all of them do so gracefully.
+ */
+static bool is_pipeline_cache_compatible(const std::vector<char>& data, const VkPhysicalDeviceProperties& props)
+{
+    VkPipelineCacheHeaderVersionOne header;
+    if (data.size() < sizeof(header))
+    {
+        return false;
+    }
+
+    std::memcpy(&header, data.data(), sizeof(header));
+    return (header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE) &&
+           (header.vendorID == props.vendorID) && (header.deviceID == props.deviceID) &&
+           (std::memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) == 0);
+}
+
+void context_t::create_pipeline_cache()
+{
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physical_device, &props);
+
+    std::vector<char> data;
+    auto cache_dir = get_pipeline_cache_dir();
+    if (!cache_dir.empty())
+    {
+        std::ostringstream name;
+        name << cache_dir << "/vk-pipeline-cache-" << std::hex << props.vendorID << "-" << props.deviceID <<
+            "-" << props.driverVersion << "-";
+        for (auto byte : props.pipelineCacheUUID)
+        {
+            name << std::setw(2) << std::setfill('0') << (int)byte;
+        }
+
+        pipeline_cache_path = name.str() + ".bin";
+        std::ifstream file(pipeline_cache_path, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (!data.empty() && !is_pipeline_cache_compatible(data, props))
+        {
+            LOGW("Ignoring incompatible Vulkan pipeline cache ", pipeline_cache_path);
+            data.clear();
+        }
+    }
+
+    VkPipelineCacheCreateInfo cache_info{};
+    cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cache_info.initialDataSize = data.size();
+    cache_info.pInitialData    = data.empty() ? nullptr : data.data();
+    if (vkCreatePipelineCache(device, &cache_info, nullptr, &pipeline_cache) != VK_SUCCESS)
+    {
+        // Retry without the initial data, in case the driver did not like it.
+        cache_info.initialDataSize = 0;
+        cache_info.pInitialData    = nullptr;
+        data.clear();
+        if (vkCreatePipelineCache(device, &cache_info, nullptr, &pipeline_cache) != VK_SUCCESS)
+        {
+            LOGE("Failed to create Vulkan pipeline cache");
+            pipeline_cache = VK_NULL_HANDLE;
+        }
+    }
+
+    loaded_pipeline_cache_size = data.size();
+    LOGD("Loaded ", data.size(), " bytes of Vulkan pipeline cache from ", pipeline_cache_path);
+}
+
+void context_t::pipeline_cache_updated()
+{
+    // Contexts without a renderer are not necessarily used from the compositor's event loop.
+    if (!renderer || pipeline_cache_path.empty())
+    {
+        return;
+    }
+
+    // Pipelines are typically created in bursts, for example when the first frames are rendered.
+    static constexpr int SAVE_PIPELINE_CACHE_DELAY_MS = 5000;
+    save_pipeline_cache_timer.disconnect();
+    save_pipeline_cache_timer.set_timeout(SAVE_PIPELINE_CACHE_DELAY_MS, [=] ()
+    {
+        save_pipeline_cache();
+    });
+}
+
+bool context_t::save_pipeline_cache()
+{
+    if ((pipeline_cache == VK_NULL_HANDLE) || pipeline_cache_path.empty())
+    {
+        return false;
+    }
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(device, pipeline_cache, &size, nullptr) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(device, pipeline_cache, &size, data.data()) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    // Write to a temporary file first, so that a crash does not leave a truncated cache behind.
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(pipeline_cache_path).parent_path(), ec);
+    const auto tmp_path = pipeline_cache_path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), size);
+        if (!file)
+        {
+            LOGE("Failed to write Vulkan pipeline cache to ", tmp_path);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmp_path, pipeline_cache_path, ec);
+    if (ec)
+    {
+        LOGE("Failed to write Vulkan pipeline cache to ", pipeline_cache_path, ": ", ec.message());
+        return false;
+    }
+
+    return true;
+}
 
 VkShaderModule context_t::load_shader_module(std::string_view path)
 {
@@ -262,50 +555,89 @@ VkShaderModule context_t::load_shader_module(const uint32_t *data, size_t size)
 
 std::shared_ptr<gpu_buffer_t> context_t::create_buffer(VkDeviceSize size, VkBufferUsageFlags usage)
 {
-    VkBufferCreateInfo buffer_info{};
-    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    buffer_info.size  = size;
-    buffer_info.usage = usage;
-    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
     VkBuffer buffer;
-    if (vkCreateBuffer(device, &buffer_info, nullptr, &buffer) != VK_SUCCESS)
+    VkDeviceMemory memory;
+    if (!create_host_visible_buffer(device, physical_device, size, usage, buffer, memory))
     {
-        LOGE("Failed to create GPU buffer");
         return nullptr;
     }
 
-    VkMemoryRequirements mem_requirements;
-    vkGetBufferMemoryRequirements(device, buffer, &mem_requirements);
+    // Use the private constructor via shared_ptr with a custom make (can't use make_shared with private ctor)
+    return std::shared_ptr<gpu_buffer_t>(
+        new gpu_buffer_t(shared_from_this(), buffer, memory, size));
+}
 
-    uint32_t memory_type = find_memory_type(physical_device,
-        mem_requirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    if (memory_type == UINT32_MAX)
+// Size of the blocks used by the per-frame allocator. Larger requests get a block of their own.
+static constexpr VkDeviceSize FRAME_BLOCK_SIZE = 256 * 1024;
+// Number of idle blocks kept around for reuse, enough for a few frames in flight on multiple outputs.
+static constexpr size_t MAX_IDLE_FRAME_BLOCKS = 8;
+
+context_t::frame_block_t context_t::acquire_frame_block(VkDeviceSize min_size)
+{
+    auto it = std::find_if(idle_frame_blocks.begin(), idle_frame_blocks.end(),
+        [&] (const frame_block_t& block) { return block.size >= min_size; });
+    if (it != idle_frame_blocks.end())
     {
-        LOGE("Failed to find suitable memory type for GPU buffer");
-        vkDestroyBuffer(device, buffer, nullptr);
-        return nullptr;
+        auto block = *it;
+        idle_frame_blocks.erase(it);
+        return block;
     }
 
-    VkMemoryAllocateInfo alloc_info{};
-    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    alloc_info.allocationSize  = mem_requirements.size;
-    alloc_info.memoryTypeIndex = memory_type;
+    frame_block_t block;
+    block.size = std::max(min_size, FRAME_BLOCK_SIZE);
+    const VkBufferUsageFlags usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    if (!create_host_visible_buffer(device, physical_device, block.size, usage, block.buffer, block.memory))
+    {
+        return {};
+    }
 
-    VkDeviceMemory memory;
-    if (vkAllocateMemory(device, &alloc_info, nullptr, &memory) != VK_SUCCESS)
+    void *mapping = nullptr;
+    if (vkMapMemory(device, block.memory, 0, VK_WHOLE_SIZE, 0, &mapping) != VK_SUCCESS)
     {
-        LOGE("Failed to allocate memory for GPU buffer");
-        vkDestroyBuffer(device, buffer, nullptr);
-        return nullptr;
+        LOGE("Failed to map per-frame allocator block");
+        destroy_frame_block(block);
+        return {};
     }
 
-    vkBindBufferMemory(device, buffer, memory, 0);
+    block.mapping = static_cast<std::byte*>(mapping);
+    frame_stats.num_blocks++;
+    frame_stats.block_bytes += block.size;
+    frame_stats.block_allocations++;
+    return block;
+}
 
-    // Use the private constructor via shared_ptr with a custom make (can't use make_shared with private ctor)
-    return std::shared_ptr<gpu_buffer_t>(
-        new gpu_buffer_t(shared_from_this(), buffer, memory, size));
+void context_t::release_frame_blocks(std::vector<frame_block_t>& blocks, VkDeviceSize used_bytes)
+{
+    frame_stats.peak_frame_bytes = std::max<uint64_t>(frame_stats.peak_frame_bytes, used_bytes);
+    frame_stats.in_flight_bytes -= std::min<uint64_t>(frame_stats.in_flight_bytes, used_bytes);
+    for (auto& block : blocks)
+    {
+        // Dedicated blocks for oversized requests are rare, so do not keep them around.
+        if ((block.size > FRAME_BLOCK_SIZE) || (idle_frame_blocks.size() >= MAX_IDLE_FRAME_BLOCKS))
+        {
+            frame_stats.num_blocks--;
+            frame_stats.block_bytes -= block.size;
+            destroy_frame_block(block);
+        } else
+        {
+            idle_frame_blocks.push_back(block);
+        }
+    }
+
+    blocks.clear();
+}
+
+void context_t::destroy_frame_block(const frame_block_t& block)
+{
+    // Freeing the memory implicitly unmaps it.
+    vkDestroyBuffer(device, block.buffer, nullptr);
+    vkFreeMemory(device, block.memory, nullptr);
+}
+
+frame_allocator_stats_t context_t::get_frame_allocator_stats() const
+{
+    return frame_stats;
 }
 
 void pipeline_specialization_t::add_specialization_for_texture(const std::shared_ptr<wf::texture_t>& texture,
@@ -319,6 +651,26 @@ void pipeline_specialization_t::add_specialization_for_texture(const std::shared
     specialized_textures.push_back(texture);
 }
 
+std::vector<pipeline_specialization_t> pipeline_specialization_t::get_common_texture_specializations(
+    const uint32_t constant_id, const uint32_t offset)
+{
+    std::vector<pipeline_specialization_t> result;
+    for (uint32_t transfer_function : {WLR_COLOR_TRANSFER_FUNCTION_SRGB,
+        WLR_COLOR_TRANSFER_FUNCTION_EXT_LINEAR, WLR_COLOR_TRANSFER_FUNCTION_GAMMA22})
+    {
+        for (uint32_t transform = WL_OUTPUT_TRANSFORM_NORMAL; transform <= WL_OUTPUT_TRANSFORM_FLIPPED_270;
+             transform++)
+        {
+            pipeline_specialization_t specialization;
+            specialization.add_specialization(constant_id, offset, transfer_function);
+            specialization.add_specialization(constant_id + 1, offset + sizeof(uint32_t), transform);
+            result.push_back(specialization);
+        }
+    }
+
+    return result;
+}
+
 void pipeline_specialization_t::_add_specialization(
     uint32_t constant_id, uint32_t offset, const void *data, size_t size)
 {
@@ -361,6 +713,19 @@ graphics_pipeline_t::graphics_pipeline_t(std::shared_ptr<context_t> ctx, const p
 
 graphics_pipeline_t::~graphics_pipeline_t()
 {
+    // Wait for pipelines compiled in the background, since the workers use the shader modules.
+    for (auto& [key, future] : pending_pipelines)
+    {
+        try {
+            auto [layout, pipeline] = future.get();
+            vkDestroyPipelineLayout(context->get_device(), layout, nullptr);
+            vkDestroyPipeline(context->get_device(), pipeline, nullptr);
+        } catch (const std::future_error&)
+        {
+            // The job was discarded because the task pool was destroyed first.
+        }
+    }
+
     // Destroy all pipelines and render passes
     for (auto& [pass, pf] : pipelines)
     {
@@ -378,7 +743,7 @@ graphics_pipeline_t::~graphics_pipeline_t()
     }
 }
 
-std::pair<VkPipelineLayout, VkPipeline> graphics_pipeline_t::pipeline_for(const command_buffer_t& cmd_buf,
+std::vector<VkDescriptorSetLayout> graphics_pipeline_t::get_texture_layouts(const command_buffer_t& cmd_buf,
     const pipeline_specialization_t& specialization)
 {
     std::vector<VkDescriptorSetLayout> specialization_filters;
@@ -390,13 +755,134 @@ std::pair<VkPipelineLayout, VkPipeline> graphics_pipeline_t::pipeline_for(const
         specialization_filters.push_back(dsl);
     }
 
-    pipeline_key_t key{cmd_buf.current_pass, specialization.get_data(), specialization_filters};
+    return specialization_filters;
+}
+
+graphics_pipeline_t::pipeline_pair_t graphics_pipeline_t::get_or_create_pipeline(const pipeline_key_t& key,
+    const std::vector<VkSpecializationMapEntry>& entries)
+{
     auto it = pipelines.find(key);
     if (it != pipelines.end())
     {
         return it->second;
     }
 
+    auto pending = pending_pipelines.find(key);
+    if (pending != pending_pipelines.end())
+    {
+        // The pipeline is still being compiled, which is faster to wait for than to compile it again.
+        auto future = pending->second;
+        pending_pipelines.erase(pending);
+        try {
+            auto result = future.get();
+            if (result.second != VK_NULL_HANDLE)
+            {
+                pipelines[key] = result;
+                return result;
+            }
+        } catch (const std::future_error&)
+        {
+            // The job was discarded because the task pool was destroyed, compile the pipeline here.
+        }
+    }
+
+    auto result = create_pipeline(std::get<0>(key), std::get<1>(key), entries, std::get<2>(key));
+    if (result.second != VK_NULL_HANDLE)
+    {
+        // Store the pipeline keyed by (render pass, specialization data)
+        pipelines[key] = result;
+        context->pipeline_cache_updated();
+    }
+
+    return result;
+}
+
+std::pair<VkPipelineLayout, VkPipeline> graphics_pipeline_t::pipeline_for(const command_buffer_t& cmd_buf,
+    const pipeline_specialization_t& specialization)
+{
+    pipeline_key_t key{cmd_buf.current_pass, specialization.get_data(),
+        get_texture_layouts(cmd_buf, specialization)};
+    auto result = get_or_create_pipeline(key, specialization.get_entries());
+
+    // Start compiling the other specializations which will likely be needed with this render pass.
+    warm_up(cmd_buf.current_pass, std::get<2>(key), *wf::get_core().task_pool);
+    return result;
+}
+
+std::pair<VkPipelineLayout, VkPipeline> graphics_pipeline_t::pipeline_for_render_pass(VkRenderPass render_pass,
+    const pipeline_specialization_t& specialization)
+{
+    if (!specialization.specialized_textures.empty())
+    {
+        LOGE("Texture specializations require a render pass managed by wlroots");
+        return {VK_NULL_HANDLE, VK_NULL_HANDLE};
+    }
+
+    return get_or_create_pipeline({render_pass, specialization.get_data(), {}}, specialization.get_entries());
+}
+
+void graphics_pipeline_t::add_expected_specialization(const pipeline_specialization_t& specialization)
+{
+    if (!specialization.specialized_textures.empty())
+    {
+        LOGE("Expected specializations cannot contain texture specializations");
+        return;
+    }
+
+    expected_specializations.push_back(specialization);
+    warmed_up_passes.clear();
+}
+
+void graphics_pipeline_t::warm_up_render_pass(VkRenderPass render_pass, wf::task_pool_t& pool)
+{
+    for (const auto& layout : params.descriptor_set_layouts)
+    {
+        if (std::holds_alternative<pipeline_params_t::texture_descriptor_set_t>(layout))
+        {
+            LOGE("Pipelines with texture descriptor sets can only be warmed up with a wlroots render pass");
+            return;
+        }
+    }
+
+    warm_up(render_pass, {}, pool);
+}
+
+void graphics_pipeline_t::warm_up(VkRenderPass render_pass,
+    const std::vector<VkDescriptorSetLayout>& texture_layouts, wf::task_pool_t& pool)
+{
+    if (expected_specializations.empty() || !warmed_up_passes.insert(render_pass).second)
+    {
+        return;
+    }
+
+    for (const auto& specialization : expected_specializations)
+    {
+        pipeline_key_t key{render_pass, specialization.get_data(), texture_layouts};
+        if (pipelines.count(key) || pending_pipelines.count(key))
+        {
+            continue;
+        }
+
+        auto promise = std::make_shared<std::promise<pipeline_pair_t>>();
+        pending_pipelines[key] = promise->get_future().share();
+        pool.submit([this, promise, key, entries = specialization.get_entries()] ()
+        {
+            promise->set_value(
+                create_pipeline(std::get<0>(key), std::get<1>(key), entries, std::get<2>(key)));
+        }, [context = std::weak_ptr<context_t>(context)] ()
+        {
+            if (auto ctx = context.lock())
+            {
+                ctx->pipeline_cache_updated();
+            }
+        });
+    }
+}
+
+graphics_pipeline_t::pipeline_pair_t graphics_pipeline_t::create_pipeline(VkRenderPass render_pass,
+    const std::vector<std::byte>& data, const std::vector<VkSpecializationMapEntry>& entries,
+    const std::vector<VkDescriptorSetLayout>& specialization_filters) const
+{
     // Create pipeline layout from descriptor set layouts and push constants
     VkPipelineLayout layout = VK_NULL_HANDLE;
     std::vector<VkDescriptorSetLayout> specialized_layouts;
@@ -430,13 +916,13 @@ std::pair<VkPipelineLayout, VkPipeline> graphics_pipeline_t::pipeline_for(const
 
     // Build VkSpecializationInfo if we have specialization constants
     VkSpecializationInfo spec_info{};
-    const bool has_specialization = !specialization.get_entries().empty();
+    const bool has_specialization = !entries.empty();
     if (has_specialization)
     {
-        spec_info.mapEntryCount = specialization.get_entries().size();
-        spec_info.pMapEntries   = specialization.get_entries().data();
-        spec_info.dataSize = specialization.get_data().size();
-        spec_info.pData    = specialization.get_data().data();
+        spec_info.mapEntryCount = entries.size();
+        spec_info.pMapEntries   = entries.data();
+        spec_info.dataSize = data.size();
+        spec_info.pData    = data.data();
     }
 
     // --- Pipeline creation ---
@@ -528,21 +1014,19 @@ std::pair<VkPipelineLayout, VkPipeline> graphics_pipeline_t::pipeline_for(const
     pipeline_info.pMultisampleState   = &multisampling;
     pipeline_info.pColorBlendState    = &color_blending;
     pipeline_info.layout     = layout;
-    pipeline_info.renderPass = cmd_buf.current_pass;
+    pipeline_info.renderPass = render_pass;
     pipeline_info.subpass    = 0;
     pipeline_info.pDynamicState = &dynamic_state_info;
 
     VkPipeline pipeline;
-    if (vkCreateGraphicsPipelines(
-        context->get_device(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline) != VK_SUCCESS)
+    if (vkCreateGraphicsPipelines(context->get_device(), context->get_pipeline_cache(), 1, &pipeline_info,
+        nullptr, &pipeline) != VK_SUCCESS)
     {
-        LOGE("Failed to create graphics pipeline for pass: ", cmd_buf.current_pass);
+        LOGE("Failed to create graphics pipeline for pass: ", render_pass);
         vkDestroyPipelineLayout(context->get_device(), layout, nullptr);
         return {VK_NULL_HANDLE, VK_NULL_HANDLE};
     }
 
-    // Store the pipeline keyed by (render pass, specialization data)
-    pipelines[key] = {layout, pipeline};
     return {layout, pipeline};
 }
 
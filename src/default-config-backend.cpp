@@ -10,6 +10,8 @@
 #include <cstring>
 #include <sys/inotify.h>
 #include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <unistd.h>
 
 #define INOT_BUF_SIZE (sizeof(inotify_event) + NAME_MAX + 1)
@@ -38,6 +40,17 @@ class dynamic_ini_config_t : public wf::config_backend_t
     wf::wl_timer<false> reload_timer;
     wf::option_wrapper_t<int> config_reload_delay;
 
+    /** The contents of the config file when it was last loaded. */
+    std::string last_config_text;
+
+    static std::string read_config_text()
+    {
+        std::ifstream stream{config_file};
+        std::ostringstream text;
+        text << stream.rdbuf();
+        return text.str();
+    }
+
   public:
     /**
      * Schedules a configuration reload after a delay.
@@ -65,6 +78,7 @@ class dynamic_ini_config_t : public wf::config_backend_t
         LOGI("Using config file: ", config_file.c_str());
         setenv(CONFIG_FILE_ENV, config_file.c_str(), 1);
 
+        last_config_text = read_config_text();
         config = wf::config::build_configuration(
             get_xml_dirs(), SYSCONFDIR "/wayfire/defaults.ini", config_file);
 
@@ -88,6 +102,7 @@ class dynamic_ini_config_t : public wf::config_backend_t
 
     bool reload_config(config::config_manager_t& config) override
     {
+        last_config_text = read_config_text();
         return wf::config::load_configuration_options_from_file(config, config_file);
     }
 
@@ -145,12 +160,31 @@ class dynamic_ini_config_t : public wf::config_backend_t
     /**
      * Performs the actual configuration reload and emits the signal.
      * This is called by the wl_timer after the delay.
+     *
+     * The signal lists the sections and options which changed, so that listeners can skip work for the
+     * rest. Nothing is done if the file contents or the resulting option values did not change.
      */
     void do_reload_config()
     {
+        if (read_config_text() == last_config_text)
+        {
+            LOGD("Configuration file contents did not change, skipping reload.");
+            return;
+        }
+
         LOGD("Reloading configuration file now!");
+        auto before = take_config_snapshot(*cfg_manager);
         this->reload_config(*cfg_manager);
+
         wf::reload_config_signal ev;
+        if (!diff_config_snapshot(before, *cfg_manager, ev))
+        {
+            LOGD("No options changed in the configuration file.");
+            return;
+        }
+
+        LOGD("Configuration reloaded, ", ev.changed_options.size(), " options in ",
+            ev.changed_sections->size(), " sections changed.");
         wf::get_core().emit(&ev);
         check_auto_reload_option(); // Re-check auto-reload option after config has been reloaded
     }
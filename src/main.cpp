@@ -1,3 +1,4 @@
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -279,6 +280,7 @@ void parse_extended_debugging(const std::vector<std::string>& categories)
 //
 int main(int argc, char *argv[])
 {
+    const auto process_start = std::chrono::steady_clock::now();
     wf::log::log_level_t log_level = wf::log::LOG_LEVEL_INFO;
     struct option opts[] = {
         {
@@ -389,6 +391,9 @@ int main(int argc, char *argv[])
     parse_extended_debugging(extended_debug_categories);
     wlr_log_init(WLR_DEBUG, wlr_log_handler);
 
+    /* Fork the launcher while the process is still small, before any other resources are created. */
+    auto launcher = wf::launcher_t::create();
+
 #ifdef PRINT_TRACE
     /* In case of crash, print the stacktrace for debugging.
      * However, if ASAN is enabled, we'll get better stacktrace from there. */
@@ -415,12 +420,17 @@ int main(int argc, char *argv[])
 
     core.argc = argc;
     core.argv = argv;
+    core.startup_timeline.set_origin(process_start);
+    core.launcher = std::move(launcher);
 
     /** TODO: move this to core_impl constructor */
     core.display = display;
     core.ev_loop = wl_display_get_event_loop(core.display);
+    core.startup_timeline.begin_phase("backend");
     core.backend = wlr_backend_autocreate(core.ev_loop, &core.session);
+    core.startup_timeline.end_phase("backend");
 
+    core.startup_timeline.begin_phase("renderer");
     int drm_fd = -1;
     char *drm_device = getenv("WLR_RENDER_DRM_DEVICE");
     if (drm_device)
@@ -467,6 +477,8 @@ int main(int argc, char *argv[])
         assert(core.egl);
     }
 
+    core.startup_timeline.end_phase("renderer");
+
     if (!allow_root && !drop_permissions())
     {
         wl_display_destroy_clients(core.display);
@@ -475,6 +487,7 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    core.startup_timeline.begin_phase("config");
     auto backend = load_backend(config_backend);
     if (!backend)
     {
@@ -487,6 +500,7 @@ int main(int argc, char *argv[])
     LOGD("Using configuration backend: ", config_backend);
     core.config_backend = std::unique_ptr<wf::config_backend_t>(backend);
     core.config_backend->init(display, *core.config, config_file);
+    core.startup_timeline.end_phase("config");
     core.init();
 
     auto socket = choose_socket(core.display);
@@ -499,6 +513,7 @@ int main(int argc, char *argv[])
 
     core.wayland_display = socket.value();
     LOGI("Using socket name ", core.wayland_display);
+    core.startup_timeline.begin_phase("backend-start");
     if (!wlr_backend_start(core.backend))
     {
         LOGE("Failed to initialize backend, exiting");
@@ -508,6 +523,8 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    core.startup_timeline.end_phase("backend-start");
+
     setenv("WAYLAND_DISPLAY", core.wayland_display.c_str(), 1);
     core.post_init();
 
@@ -86,6 +86,11 @@ void wf::output_impl_t::set_workspace_set(std::shared_ptr<workspace_set_t> wset)
     wf::get_core().seat->refocus();
 }
 
+wf::promotion_stats_t wf::output_impl_t::get_promotion_stats() const
+{
+    return promotion_manager->get_stats();
+}
+
 std::string wf::output_t::to_string() const
 {
     return handle->name;
@@ -0,0 +1,59 @@
+#include "plane-assignment.hpp"
+#include <wayfire/region.hpp>
+
+std::vector<bool> wf::assign_planes(const std::vector<plane_layer_t>& top_to_bottom,
+    plane_test_backend_t& backend, int max_attempts)
+{
+    const size_t n = top_to_bottom.size();
+    std::vector<bool> promoted(n, true);
+
+    for (int attempt = 0; attempt < max_attempts; attempt++)
+    {
+        // Output layers are ordered from bottom to top.
+        std::vector<plane_layer_t> layers;
+        std::vector<size_t> layer_candidate;
+        for (size_t i = n; i-- > 0;)
+        {
+            if (promoted[i])
+            {
+                layers.push_back(top_to_bottom[i]);
+                layers.back().accepted = false;
+                layer_candidate.push_back(i);
+            }
+        }
+
+        if (layers.empty() || !backend.test_layers(layers))
+        {
+            break;
+        }
+
+        std::vector<bool> accepted(n, false);
+        bool all_accepted = true;
+        for (size_t j = 0; j < layers.size(); j++)
+        {
+            accepted[layer_candidate[j]] = layers[j].accepted;
+            all_accepted &= layers[j].accepted;
+        }
+
+        if (all_accepted)
+        {
+            return promoted;
+        }
+
+        // Walk from the top and collect everything which ends up on the primary plane. A layer below
+        // composited content would cover it, so it has to be composited too.
+        wf::region_t composited;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (promoted[i] && accepted[i] && (composited & top_to_bottom[i].dst_box).empty())
+            {
+                continue;
+            }
+
+            promoted[i] = false;
+            composited |= top_to_bottom[i].dst_box;
+        }
+    }
+
+    return std::vector<bool>(n, false);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+extern "C" {
+#include <wlr/util/box.h>
+struct wlr_buffer;
+}
+
+namespace wf
+{
+/** A buffer which may be displayed on an output layer, with positions in output buffer coordinates. */
+struct plane_layer_t
+{
+    wlr_buffer *buffer = nullptr;
+    wlr_fbox src_box   = {0, 0, 0, 0};
+    wlr_box dst_box    = {0, 0, 0, 0};
+    /** Set by the backend after a test: whether the layer can be displayed on a plane. */
+    bool accepted = false;
+};
+
+/**
+ * Tests a configuration of output layers against the hardware. Implemented with wlr_output_layer in the
+ * render manager, and by fake backends in tests.
+ */
+class plane_test_backend_t
+{
+  public:
+    /**
+     * Test whether the given layers (ordered from bottom to top, above the composited primary plane) can be
+     * displayed, and set plane_layer_t::accepted for each of them.
+     *
+     * @return false if the whole output state was rejected.
+     */
+    virtual bool test_layers(std::vector<plane_layer_t>& layers) = 0;
+    virtual ~plane_test_backend_t() = default;
+};
+
+/**
+ * Decide which of the candidates can be displayed on output layers.
+ *
+ * Candidates which are rejected by the backend are composited on the primary plane, which lies below all
+ * output layers. Therefore, any candidate below a rejected one which overlaps it has to be composited as
+ * well, and the reduced configuration is tested again, up to @max_attempts times.
+ *
+ * @param top_to_bottom The candidates, ordered from the top of the scenegraph to the bottom.
+ *
+ * @return For each candidate, whether it is on an output layer. If no configuration could be verified, no
+ *   candidate is promoted.
+ */
+std::vector<bool> assign_planes(const std::vector<plane_layer_t>& top_to_bottom,
+    plane_test_backend_t& backend, int max_attempts = 3);
+}
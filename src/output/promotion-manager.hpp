@@ -23,29 +23,123 @@ class promotion_manager_t
     promotion_manager_t(wf::output_t *output)
     {
         this->output = output;
-        wf::get_core().scene()->connect(&on_root_node_updated);
+        output->node_for_layer(scene::layer::WORKSPACE)->connect(&on_workspace_layer_updated);
         output->connect(&on_view_fullscreen);
+        output->connect(&on_view_mapped);
         output->connect(&on_view_unmap);
+        output->connect(&on_view_geometry_changed);
+        output->connect(&on_view_change_workspace);
+        output->connect(&on_workspace_changed);
+        output->connect(&on_wset_changed);
+    }
+
+    const promotion_stats_t& get_stats() const
+    {
+        return stats;
     }
 
   private:
     wf::output_t *output;
+    promotion_stats_t stats;
+
+    /**
+     * The topmost mapped view of the current workspace set which is visible on the current workspace, as of
+     * the last time the stack was searched. Only the events below can change it.
+     */
+    wayfire_toplevel_view top_view;
+
+    /* Restacking, adding, removing, enabling and disabling nodes below the workspace layer of the output.
+     * Updates elsewhere in the scenegraph, or geometry and damage updates of the views (e.g. from
+     * animations), do not change the stacking order. */
+    wf::signal::connection_t<wf::scene::node_update_signal> on_workspace_layer_updated =
+        [=] (wf::scene::node_update_signal *ev)
+    {
+        stats.events++;
+        if (ev->flags & (scene::update_flag::CHILDREN_LIST | scene::update_flag::ENABLED))
+        {
+            find_top_view();
+        }
+    };
 
-    wf::signal::connection_t<wf::scene::root_node_update_signal> on_root_node_updated = [=] (auto)
+    signal::connection_t<view_mapped_signal> on_view_mapped = [=] (view_mapped_signal *ev)
     {
-        update_promotion_state();
+        stats.events++;
+        find_top_view();
     };
 
     signal::connection_t<view_unmapped_signal> on_view_unmap = [=] (view_unmapped_signal *ev)
     {
-        update_promotion_state();
+        stats.events++;
+        if (ev->view == top_view)
+        {
+            find_top_view();
+        }
     };
 
-    wf::signal::connection_t<wf::view_fullscreen_signal> on_view_fullscreen = [=] (auto)
+    wf::signal::connection_t<wf::view_fullscreen_signal> on_view_fullscreen =
+        [=] (wf::view_fullscreen_signal *ev)
     {
-        update_promotion_state();
+        stats.events++;
+        if (ev->view == top_view)
+        {
+            update_promotion_state();
+        }
+    };
+
+    /* A view may have moved onto the current workspace above the top view, or the top view may have left
+     * the current workspace. Views below the top view cannot become the top view by moving. */
+    wf::signal::connection_t<wf::view_geometry_changed_signal> on_view_geometry_changed =
+        [=] (wf::view_geometry_changed_signal *ev)
+    {
+        stats.events++;
+        if ((ev->view == top_view) || (is_visible(ev->view) && is_above_top_view(ev->view)))
+        {
+            find_top_view();
+        }
+    };
+
+    wf::signal::connection_t<wf::view_change_workspace_signal> on_view_change_workspace = [=] (auto)
+    {
+        stats.events++;
+        find_top_view();
+    };
+
+    wf::signal::connection_t<wf::workspace_changed_signal> on_workspace_changed = [=] (auto)
+    {
+        stats.events++;
+        find_top_view();
+    };
+
+    wf::signal::connection_t<wf::workspace_set_changed_signal> on_wset_changed = [=] (auto)
+    {
+        stats.events++;
+        find_top_view();
     };
 
+    bool is_visible(wayfire_toplevel_view view)
+    {
+        return view && view->is_mapped() &&
+               output->wset()->view_visible_on(view, output->wset()->get_current_workspace());
+    }
+
+    bool is_above_top_view(wayfire_toplevel_view view)
+    {
+        if (!top_view)
+        {
+            return true;
+        }
+
+        for (auto& stacked : output->wset()->get_views(WSET_SORT_STACKING))
+        {
+            if ((stacked == view) || (stacked == top_view))
+            {
+                return stacked == view;
+            }
+        }
+
+        return false;
+    }
+
     wayfire_toplevel_view find_top_visible_view(wf::scene::node_ptr root)
     {
         if (auto view = wf::node_to_view(root))
@@ -75,10 +169,17 @@ class promotion_manager_t
         return nullptr;
     }
 
+    void find_top_view()
+    {
+        stats.searches++;
+        top_view = find_top_visible_view(output->wset()->get_node());
+        update_promotion_state();
+    }
+
     void update_promotion_state()
     {
-        wayfire_toplevel_view candidate = find_top_visible_view(output->wset()->get_node());
-        if (candidate && candidate->toplevel()->current().fullscreen)
+        stats.evaluations++;
+        if (top_view && top_view->toplevel()->current().fullscreen)
         {
             start_promotion();
         } else
@@ -99,6 +200,7 @@ class promotion_manager_t
         }
 
         promotion_active = true;
+        stats.promotions++;
         scene::set_node_enabled(output->node_for_layer(scene::layer::TOP), false);
 
         wf::fullscreen_layer_focused_signal ev;
@@ -11,13 +11,16 @@
 #include "wayfire/scene.hpp"
 #include "wayfire/signal-definitions.hpp"
 #include "wayfire/view.hpp"
+#include "wayfire/frame-animation.hpp"
 #include "wayfire/output.hpp"
 #include "wayfire/util.hpp"
 #include "../main.hpp"
+#include "../core/core-impl.hpp"
 #include "wayfire/workspace-set.hpp" // IWYU pragma: keep
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <map>
 #include <deque>
 #include <optional>
 #include <wayfire/nonstd/reverse.hpp>
@@ -27,6 +30,8 @@
 #include <wlr/types/wlr_gamma_control_v1.h>
 #include <wayfire/output-layout.hpp>
 #include "adaptive-repaint-scheduler.hpp"
+#include "plane-assignment.hpp"
+#include <wlr/types/wlr_output_layer.h>
 #include <ctime>
 
 namespace wf
@@ -355,6 +360,7 @@ struct swapchain_damage_manager_t
             return false;
         }
 
+        wf::get_core_impl().startup_timeline.mark_first_commit();
         frame_damage.clear();
         return true;
     }
@@ -468,6 +474,56 @@ struct effect_hook_manager_t
     }
 };
 
+/**
+ * Steps all animations of an output in a single pass at the start of each frame.
+ */
+struct animation_timeline_t
+{
+    wf::safe_list_t<animation_hook_t*> animations;
+
+    void add_animation(animation_hook_t *hook)
+    {
+        animations.remove_all(hook);
+        animations.push_back(hook);
+    }
+
+    void rem_animation(animation_hook_t *hook)
+    {
+        animations.remove_all(hook);
+    }
+
+    void step(int64_t presentation_ns)
+    {
+        animations.for_each([&] (animation_hook_t *hook)
+        {
+            if (!(*hook)(presentation_ns))
+            {
+                animations.remove_all(hook);
+            }
+        });
+    }
+
+    bool has_animations() const
+    {
+        return animations.size() > 0;
+    }
+};
+
+static const char *fused_post_vertex_source =
+    R"(
+#version 100
+
+attribute highp vec2 position;
+attribute highp vec2 uvPosition;
+
+varying highp vec2 uvpos;
+
+void main() {
+    gl_Position = vec4(position.xy, 0.0, 1.0);
+    uvpos = uvPosition;
+}
+)";
+
 /**
  * A class to manage and run postprocessing effects
  */
@@ -475,6 +531,13 @@ struct postprocessing_manager_t
 {
     using post_container_t = wf::safe_list_t<post_hook_t*>;
     post_container_t post_effects;
+    std::map<post_hook_t*, uint32_t> post_flags;
+
+    /* Pointwise effects, fused into a single pass after all post hooks */
+    std::vector<pointwise_post_effect_t*> pointwise_effects;
+    OpenGL::program_t fused_program;
+    bool fused_program_dirty = true;
+
     wf::auxilliary_buffer_t post_buffers[2];
     /* Buffer to which other operations render to */
     static constexpr uint32_t default_out_buffer = 0;
@@ -486,6 +549,14 @@ struct postprocessing_manager_t
         this->output = output;
     }
 
+    ~postprocessing_manager_t()
+    {
+        wf::gles::run_in_context_if_gles([&]
+        {
+            fused_program.free_resources();
+        });
+    }
+
     wf::render_buffer_t final_target;
     void set_current_buffer(wlr_buffer *buffer)
     {
@@ -495,56 +566,206 @@ struct postprocessing_manager_t
         };
     }
 
+    /* The number of passes: one per post hook and one for all pointwise effects */
+    size_t count_stages() const
+    {
+        return post_effects.size() + (pointwise_effects.empty() ? 0 : 1);
+    }
+
+    bool has_effects() const
+    {
+        return count_stages() > 0;
+    }
+
+    /* Whether all effects are pointwise, so that only the damaged region has to be processed */
+    bool is_damage_preserving() const
+    {
+        return std::all_of(post_flags.begin(), post_flags.end(), [] (const auto& hook)
+        {
+            return hook.second & POST_HOOK_POINTWISE;
+        });
+    }
+
     void allocate(int width, int height)
     {
-        if (post_effects.size() == 0)
+        const size_t stages = count_stages();
+        if (stages == 0)
         {
             return;
         }
 
         output_width  = width;
         output_height = height;
-        for (auto& buffer : post_buffers)
+        for (size_t i = 0; i < 2; i++)
         {
-            buffer.allocate({width, height});
+            // The second buffer is needed only to ping-pong between multiple passes
+            if ((i > 0) && (stages < 2))
+            {
+                post_buffers[i].free();
+                continue;
+            }
+
+            post_buffers[i].set_owner("postprocessing " + output->to_string());
+            post_buffers[i].allocate({width, height});
         }
     }
 
-    void add_post(post_hook_t *hook)
+    void add_post(post_hook_t *hook, uint32_t flags)
     {
         post_effects.push_back(hook);
+        post_flags[hook] = flags;
         output->render->damage_whole_idle();
     }
 
     void rem_post(post_hook_t *hook)
     {
         post_effects.remove_all(hook);
+        post_flags.erase(hook);
+        output->render->damage_whole_idle();
+    }
+
+    void add_pointwise_post(pointwise_post_effect_t *effect)
+    {
+        if (!wf::get_core().is_gles2())
+        {
+            LOGE("Pointwise effect ", effect->name, " requires the GLES renderer");
+            return;
+        }
+
+        pointwise_effects.push_back(effect);
+        fused_program_dirty = true;
         output->render->damage_whole_idle();
     }
 
+    void rem_pointwise_post(pointwise_post_effect_t *effect)
+    {
+        auto it = std::remove(pointwise_effects.begin(), pointwise_effects.end(), effect);
+        if (it != pointwise_effects.end())
+        {
+            pointwise_effects.erase(it, pointwise_effects.end());
+            fused_program_dirty = true;
+            output->render->damage_whole_idle();
+        }
+    }
+
     /* Run all postprocessing effects, rendering to alternating buffers and
      * finally to the screen.
      *
      * NB: 2 buffers just aren't enough. We render to the zero buffer, and then
      * we alternately render to the second and the third. The reason: We track
-     * damage. So, we need to keep the whole buffer each frame. */
-    void run_post_effects()
+     * damage. So, we need to keep the whole buffer each frame.
+     *
+     * @param damage The damaged region of the output buffer. If all effects are pointwise, only this region
+     *   of the buffers is up to date and needs to be processed. */
+    void run_post_effects(const wf::region_t& damage)
     {
-        int cur_idx = 0;
+        const size_t stages = count_stages();
+        size_t stage = 0;
+        int cur_idx  = 0;
+        auto next_destination = [&] () -> wf::render_buffer_t
+        {
+            ++stage;
+            return stage >= stages ? final_target : post_buffers[1 - cur_idx].get_renderbuffer();
+        };
+
         post_effects.for_each([&] (auto post) -> void
         {
-            int next_idx = 1 - cur_idx;
-            wf::render_buffer_t dst_buffer = (post == post_effects.back() ?
-                final_target : post_buffers[next_idx].get_renderbuffer());
+            wf::render_buffer_t dst_buffer = next_destination();
             (*post)(post_buffers[cur_idx], dst_buffer);
-            cur_idx = next_idx;
+            cur_idx = 1 - cur_idx;
+        });
+
+        if (!pointwise_effects.empty())
+        {
+            run_fused_pass(post_buffers[cur_idx], next_destination(), damage);
+        }
+    }
+
+    void rebuild_fused_program()
+    {
+        std::string fragment_source =
+            "#version 100\n"
+            "varying highp vec2 uvpos;\n"
+            "uniform sampler2D smp;\n";
+
+        std::string calls;
+        for (auto effect : pointwise_effects)
+        {
+            fragment_source += effect->source + "\n";
+            calls += "    color = " + effect->name + "(color);\n";
+        }
+
+        fragment_source +=
+            "void main()\n"
+            "{\n"
+            "    highp vec4 color = texture2D(smp, uvpos);\n" +
+            calls +
+            "    gl_FragColor = color;\n"
+            "}\n";
+
+        fused_program.free_resources();
+        fused_program.set_simple(OpenGL::compile_program(fused_post_vertex_source, fragment_source));
+        fused_program_dirty = false;
+    }
+
+    /* Apply all pointwise effects in a single pass, on the damaged region only */
+    void run_fused_pass(wf::auxilliary_buffer_t& source, const wf::render_buffer_t& destination,
+        const wf::region_t& damage)
+    {
+        static const float vertex_data[] = {
+            -1.0f, -1.0f,
+            1.0f, -1.0f,
+            1.0f, 1.0f,
+            -1.0f, 1.0f
+        };
+
+        static const float coord_data[] = {
+            0.0f, 0.0f,
+            1.0f, 0.0f,
+            1.0f, 1.0f,
+            0.0f, 1.0f
+        };
+
+        wf::gles::run_in_context([&]
+        {
+            if (fused_program_dirty)
+            {
+                rebuild_fused_program();
+            }
+
+            wf::gles::bind_render_buffer(destination);
+            fused_program.use(wf::TEXTURE_TYPE_RGBA);
+            GL_CALL(glActiveTexture(GL_TEXTURE0));
+            GL_CALL(glBindTexture(GL_TEXTURE_2D, wf::gles_texture_t::from_aux(source).tex_id));
+
+            fused_program.attrib_pointer("position", 2, 0, vertex_data);
+            fused_program.attrib_pointer("uvPosition", 2, 0, coord_data);
+            for (auto effect : pointwise_effects)
+            {
+                if (effect->set_uniforms)
+                {
+                    effect->set_uniforms(fused_program);
+                }
+            }
+
+            GL_CALL(glDisable(GL_BLEND));
+            for (const auto& box : damage)
+            {
+                wf::gles::scissor_render_buffer(destination, wlr_box_from_pixman_box(box));
+                GL_CALL(glDrawArrays(GL_TRIANGLE_FAN, 0, 4));
+            }
+
+            GL_CALL(glDisable(GL_SCISSOR_TEST));
+            GL_CALL(glEnable(GL_BLEND));
+            GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+            fused_program.deactivate();
         });
     }
 
     wf::render_target_t get_target_framebuffer() const
     {
         wf::render_target_t fb{
-            post_effects.size() > 0 ? post_buffers[default_out_buffer].get_renderbuffer() : final_target
+            has_effects() ? post_buffers[default_out_buffer].get_renderbuffer() : final_target
         };
 
         fb.geometry     = output->get_relative_geometry();
@@ -556,7 +777,7 @@ struct postprocessing_manager_t
 
     bool can_scanout() const
     {
-        return post_effects.size() == 0;
+        return !has_effects();
     }
 };
 
@@ -678,6 +899,246 @@ class depth_buffer_manager_t
     }
 };
 
+/**
+ * Puts surfaces on output layers (hardware overlay planes), so that they do not have to be composited.
+ *
+ * Every frame, candidates are collected from the scenegraph and tested together with the next primary
+ * buffer. Whatever the hardware rejects is composited as usual.
+ */
+class output_plane_manager_t : public plane_test_backend_t
+{
+  public:
+    output_plane_manager_t(wf::output_t *output)
+    {
+        this->output = output;
+
+        // wlr_output_finish() frees the remaining output layers, so they must not outlive the output.
+        on_output_destroy.set_callback([=] (void*)
+        {
+            for (auto& layer : layers)
+            {
+                wlr_output_layer_destroy(layer);
+            }
+
+            layers.clear();
+            layer_states.clear();
+            pending.clear();
+            layers_committed = false;
+        });
+        on_output_destroy.connect(&output->handle->events.destroy);
+    }
+
+    /**
+     * Decide which surfaces are put on output layers in the next frame.
+     *
+     * @param enabled Whether output layers may be used for this frame at all.
+     * @param target The render target of the output, used to compute buffer coordinates.
+     * @param primary The buffer which is going to be committed on the primary plane.
+     *
+     * @return The damage (in buffer coordinates) caused by surfaces switching between being composited and
+     *   being on an output layer.
+     */
+    wf::region_t assign(const std::vector<scene::render_instance_uptr>& instances, bool enabled,
+        const wf::render_target_t& target, wlr_buffer *primary)
+    {
+        static wf::option_wrapper_t<int> max_overlay_planes{"workarounds/max_overlay_planes"};
+
+        size_t max_planes = 0;
+        if (backoff_frames > 0)
+        {
+            --backoff_frames;
+        } else if (enabled)
+        {
+            max_planes = std::max(0, (int)max_overlay_planes);
+        }
+
+        if ((max_planes == 0) && promoted_boxes.empty() && !layers_committed)
+        {
+            // Nothing was promoted, so the promotion flags of the instances are all unset.
+            return {};
+        }
+
+        // Collecting candidates also resets the promotion flags of all surfaces we do not promote.
+        scene::plane_collector_t collector{target.geometry, max_planes};
+        for (auto& instance : instances)
+        {
+            instance->collect_plane_candidates(output, collector);
+        }
+
+        const auto& candidates = collector.get_candidates();
+        std::vector<plane_layer_t> top_to_bottom;
+        for (auto& candidate : candidates)
+        {
+            top_to_bottom.push_back({
+                .buffer  = candidate.buffer,
+                .src_box = candidate.src_box,
+                .dst_box = target.framebuffer_box_from_geometry_box(candidate.geometry),
+            });
+        }
+
+        std::vector<bool> promoted(top_to_bottom.size(), false);
+        if (!top_to_bottom.empty() && !same_layout(top_to_bottom, rejected_layout))
+        {
+            this->primary = primary;
+            promoted = assign_planes(top_to_bottom, *this);
+            this->primary = nullptr;
+
+            // Testing is expensive, so a layout which was rejected entirely is not tested again until the
+            // candidates change.
+            rejected_layout.clear();
+            if (std::find(promoted.begin(), promoted.end(), true) == promoted.end())
+            {
+                rejected_layout = top_to_bottom;
+            }
+        }
+
+        std::vector<wlr_box> new_boxes;
+        pending.clear();
+        for (size_t i = top_to_bottom.size(); i-- > 0;)
+        {
+            *candidates[i].promoted = promoted[i];
+            if (promoted[i])
+            {
+                pending.push_back(top_to_bottom[i]);
+                new_boxes.push_back(top_to_bottom[i].dst_box);
+            }
+        }
+
+        // Surfaces which moved between a plane and the primary buffer have to be (un)drawn in the
+        // primary buffer.
+        wf::region_t damage;
+        for (auto& box : promoted_boxes)
+        {
+            if (std::find(new_boxes.begin(), new_boxes.end(), box) == new_boxes.end())
+            {
+                damage |= box;
+            }
+        }
+
+        for (auto& box : new_boxes)
+        {
+            if (std::find(promoted_boxes.begin(), promoted_boxes.end(), box) == promoted_boxes.end())
+            {
+                damage |= box;
+            }
+        }
+
+        promoted_boxes = std::move(new_boxes);
+        return damage;
+    }
+
+    /** Whether any output layer is in use, or has to be disabled with the next commit. */
+    bool is_active() const
+    {
+        return !pending.empty() || layers_committed;
+    }
+
+    /** Add the output layers decided by assign() to the output state for the next frame. */
+    void apply(wlr_output_state *state)
+    {
+        if (is_active())
+        {
+            fill_layer_states(pending);
+            wlr_output_state_set_layers(state, layer_states.data(), layer_states.size());
+        }
+    }
+
+    /**
+     * Handle the result of committing the state from apply().
+     * If a commit with output layers fails, output layers are disabled for a while.
+     */
+    void commit_done(bool success)
+    {
+        if (success)
+        {
+            layers_committed = !pending.empty();
+            return;
+        }
+
+        if (!pending.empty())
+        {
+            LOGE("Output commit with ", pending.size(), " output layers failed on ", output->to_string(),
+                ", compositing everything for the next frames.");
+            backoff_frames = BACKOFF_FRAMES;
+        }
+    }
+
+    bool test_layers(std::vector<plane_layer_t>& to_test) override
+    {
+        fill_layer_states(to_test);
+
+        wlr_output_state state;
+        wlr_output_state_init(&state);
+        if (primary)
+        {
+            wlr_output_state_set_buffer(&state, primary);
+        }
+
+        wlr_output_state_set_layers(&state, layer_states.data(), layer_states.size());
+        const bool result = wlr_output_test_state(output->handle, &state);
+        wlr_output_state_finish(&state);
+
+        for (size_t i = 0; i < to_test.size(); i++)
+        {
+            to_test[i].accepted = result && layer_states[i].accepted;
+        }
+
+        return result;
+    }
+
+  private:
+    static constexpr int BACKOFF_FRAMES = 60;
+
+    wf::output_t *output;
+    std::vector<wlr_output_layer*> layers;
+    std::vector<wlr_output_layer_state> layer_states;
+
+    // The layers for the next commit, bottom to top.
+    std::vector<plane_layer_t> pending;
+    // The buffer boxes of the promoted surfaces in the current frame.
+    std::vector<wlr_box> promoted_boxes;
+    // Whether the last commit enabled any output layer.
+    bool layers_committed = false;
+    int backoff_frames    = 0;
+    wlr_buffer *primary   = nullptr;
+    // The last candidates for which no layer was accepted, top to bottom.
+    std::vector<plane_layer_t> rejected_layout;
+
+    wf::wl_listener_wrapper on_output_destroy;
+
+    static bool same_layout(const std::vector<plane_layer_t>& a, const std::vector<plane_layer_t>& b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+            [] (const plane_layer_t& x, const plane_layer_t& y)
+        {
+            return (x.buffer == y.buffer) && (x.dst_box == y.dst_box) &&
+                   (x.src_box.x == y.src_box.x) && (x.src_box.y == y.src_box.y) &&
+                   (x.src_box.width == y.src_box.width) && (x.src_box.height == y.src_box.height);
+        });
+    }
+
+    /** Fill layer_states with the given layers, bottom to top. Unused layers are disabled. */
+    void fill_layer_states(const std::vector<plane_layer_t>& bottom_to_top)
+    {
+        while (layers.size() < bottom_to_top.size())
+        {
+            layers.push_back(wlr_output_layer_create(output->handle));
+        }
+
+        layer_states.assign(layers.size(), wlr_output_layer_state{});
+        for (size_t i = 0; i < layers.size(); i++)
+        {
+            layer_states[i].layer = layers[i];
+            if (i < bottom_to_top.size())
+            {
+                layer_states[i].buffer  = bottom_to_top[i].buffer;
+                layer_states[i].src_box = bottom_to_top[i].src_box;
+                layer_states[i].dst_box = bottom_to_top[i].dst_box;
+            }
+        }
+    }
+};
+
 static int64_t get_monotonic_time_ns()
 {
     timespec now;
@@ -685,6 +1146,14 @@ static int64_t get_monotonic_time_ns()
     return now.tv_sec * 1'000'000'000ll + now.tv_nsec;
 }
 
+/** The predicted presentation time of the frame which is currently being built, on any output. */
+static std::optional<int64_t> current_frame_time_ns;
+
+int64_t wf::animation::get_frame_time_ns()
+{
+    return current_frame_time_ns.value_or(get_monotonic_time_ns());
+}
+
 static int64_t timespec_to_ns(const timespec& timestamp)
 {
     return timestamp.tv_sec * 1'000'000'000ll + timestamp.tv_nsec;
@@ -751,8 +1220,13 @@ class wf::render_manager::impl
     wf::region_t swap_damage;
     std::unique_ptr<swapchain_damage_manager_t> damage_manager;
     std::unique_ptr<effect_hook_manager_t> effects;
+    animation_timeline_t animations;
+    /* The predicted presentation time of the frame being built, valid during paint(). */
+    std::optional<int64_t> frame_presentation_ns;
+    int64_t last_frame_presentation_ns = 0;
     std::unique_ptr<postprocessing_manager_t> postprocessing;
     std::unique_ptr<depth_buffer_manager_t> depth_buffer_manager;
+    std::unique_ptr<output_plane_manager_t> plane_manager;
     adaptive_repaint_scheduler_t repaint_scheduler;
     std::deque<pending_render_timer_t> pending_render_timers;
     render_timer_support_t render_timer_support = render_timer_support_t::UNKNOWN;
@@ -887,6 +1361,7 @@ class wf::render_manager::impl
         effects = std::make_unique<effect_hook_manager_t>();
         postprocessing = std::make_unique<postprocessing_manager_t>(o);
         depth_buffer_manager = std::make_unique<depth_buffer_manager_t>();
+        plane_manager = std::make_unique<output_plane_manager_t>(o);
         if (output->handle->renderer)
         {
             on_renderer_destroy.set_callback([&] (void*)
@@ -1351,7 +1826,8 @@ class wf::render_manager::impl
             postprocessing->can_scanout() && wlr_output_is_direct_scanout_allowed(output->handle) &&
             (icc_color_transform == nullptr);
 
-        if (!can_scanout || !env_allow_scanout)
+        // Output layers have to be disabled by a composited frame first.
+        if (!can_scanout || !env_allow_scanout || plane_manager->is_active())
         {
             return {};
         }
@@ -1366,6 +1842,41 @@ class wf::render_manager::impl
         return {};
     }
 
+    bool has_software_cursors()
+    {
+        wlr_output_cursor *cursor;
+        wl_list_for_each(cursor, &output->handle->cursors, link)
+        {
+            if (cursor->enabled && cursor->visible && (output->handle->hardware_cursor != cursor))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Put suitable surfaces on output layers for the next frame. They are skipped when compositing.
+     * Output layers are used under the same conditions as direct scanout, as they also bypass effects and
+     * color conversion.
+     */
+    void assign_output_layers(wlr_buffer *primary)
+    {
+        const bool can_use_layers = !output_inhibit_counter && effects->can_scanout() &&
+            postprocessing->can_scanout() && (icc_color_transform == nullptr) && env_allow_scanout &&
+            !has_software_cursors();
+
+        auto target = postprocessing->get_target_framebuffer().translated(
+            wf::origin(output->get_layout_geometry()));
+        auto damage = plane_manager->assign(damage_manager->instance_manager->get_instances(),
+            can_use_layers, target, primary);
+        if (!damage.empty())
+        {
+            damage_manager->damage_buffer(damage, false);
+        }
+    }
+
     /**
      * Return the swap damage if called from overlay or postprocessing
      * effect callbacks or empty region otherwise.
@@ -1445,9 +1956,23 @@ class wf::render_manager::impl
      * Repaints the whole output, includes all effects and hooks
      */
     void paint(const repaint_schedule_t& schedule)
+    {
+        paint_frame(schedule);
+        frame_presentation_ns.reset();
+        current_frame_time_ns.reset();
+
+        // Running animations need another frame even if they did not damage anything in this one.
+        if (animations.has_animations())
+        {
+            damage_manager->schedule_repaint();
+        }
+    }
+
+    void paint_frame(const repaint_schedule_t& schedule)
     {
         const int64_t paint_started_ns = get_monotonic_time_ns();
-        /* Part 1: frame setup: query damage, etc. */
+        /* Part 1: frame setup: step animations, query damage, etc. */
+        step_animations(schedule.target_presentation_ns.value_or(paint_started_ns));
         effects->run_effects(OUTPUT_EFFECT_PRE);
         effects->run_effects(OUTPUT_EFFECT_DAMAGE);
 
@@ -1481,6 +2006,7 @@ class wf::render_manager::impl
 
         /* Part 2: call the renderer, which sets swap_damage and draws the scenegraph */
         update_bound_output(next_frame->buffer);
+        assign_output_layers(next_frame->buffer);
         render_timer_ptr render_timer;
         int64_t timer_started_ns = 0;
         this->swap_damage = start_output_pass(next_frame);
@@ -1508,12 +2034,12 @@ class wf::render_manager::impl
         effects->run_effects(OUTPUT_EFFECT_PASS_DONE);
 
         /* Part 5: finalize the scene: postprocessing effects */
-        if (postprocessing->post_effects.size())
+        if (postprocessing->has_effects() && !postprocessing->is_damage_preserving())
         {
             swap_damage |= damage_manager->get_buffer_extents();
         }
 
-        postprocessing->run_post_effects();
+        postprocessing->run_post_effects(swap_damage);
 
         // GLES render timers include earlier work queued in the context, so a
         // final marker pass measures completion of scene, postprocessing and cursors.
@@ -1535,8 +2061,10 @@ class wf::render_manager::impl
         }
 
         /* Part 7: finalize frame: swap buffers, send frame_done, etc */
+        plane_manager->apply(&next_frame->state);
         const bool committed = damage_manager->swap_buffers(std::move(next_frame), swap_damage);
         const int64_t committed_ns = get_monotonic_time_ns();
+        plane_manager->commit_done(committed);
 
         unset_bound_output();
         swap_damage.clear();
@@ -1658,6 +2186,23 @@ class wf::render_manager::impl
         return true;
     }
 
+    /**
+     * Advance all animations to the predicted presentation time of the next frame. Animation time never goes
+     * backwards, even if the prediction for this frame is earlier than the previous one.
+     */
+    void step_animations(int64_t target_ns)
+    {
+        last_frame_presentation_ns = std::max(last_frame_presentation_ns, target_ns);
+        frame_presentation_ns = last_frame_presentation_ns;
+        current_frame_time_ns = last_frame_presentation_ns;
+        animations.step(last_frame_presentation_ns);
+    }
+
+    int64_t get_frame_presentation_time_ns()
+    {
+        return frame_presentation_ns.value_or(get_monotonic_time_ns());
+    }
+
     /**
      * Execute post-paint actions.
      */
@@ -1699,6 +2244,57 @@ void scene::compute_visibility_from_list(const std::vector<render_instance_uptr>
     region += offset;
 }
 
+void scene::collect_plane_candidates_from_list(const std::vector<render_instance_uptr>& instances,
+    wf::output_t *output, plane_collector_t& collector, const wf::pointf_t& offset)
+{
+    collector.offset += offset;
+    for (auto& ch : instances)
+    {
+        ch->collect_plane_candidates(output, collector);
+    }
+
+    collector.offset -= offset;
+}
+
+scene::plane_collector_t::plane_collector_t(const wf::geometry_t& output_geometry, size_t max_candidates) :
+    output_geometry(output_geometry), max_candidates(max_candidates)
+{}
+
+void scene::plane_collector_t::add_candidate(bool *promoted, wlr_buffer *buffer, const wlr_fbox& src_box,
+    const wf::geometry_t& geometry)
+{
+    *promoted = false;
+    auto box  = geometry + offset;
+    if (!(box & output_geometry))
+    {
+        return;
+    }
+
+    if (all_occluded || (candidates.size() >= max_candidates) || !(occluded & box).empty() ||
+        (wf::clamp(box, output_geometry) != box))
+    {
+        occlude(geometry);
+        return;
+    }
+
+    candidates.push_back({promoted, buffer, src_box, box});
+}
+
+void scene::plane_collector_t::occlude(const wf::regionf_t& region)
+{
+    occluded |= region + offset;
+}
+
+void scene::plane_collector_t::occlude_all()
+{
+    all_occluded = true;
+}
+
+const std::vector<scene::plane_collector_t::candidate_t>& scene::plane_collector_t::get_candidates() const
+{
+    return candidates;
+}
+
 render_manager::render_manager(output_t *o) :
     pimpl(new impl(o))
 {}
@@ -1734,9 +2330,25 @@ void render_manager::rem_effect(effect_hook_t *hook)
     pimpl->effects->rem_effect(hook);
 }
 
-void render_manager::add_post(post_hook_t *hook)
+void render_manager::add_animation(animation_hook_t *hook)
+{
+    pimpl->animations.add_animation(hook);
+    schedule_redraw();
+}
+
+void render_manager::rem_animation(animation_hook_t *hook)
+{
+    pimpl->animations.rem_animation(hook);
+}
+
+int64_t render_manager::get_frame_presentation_time_ns()
 {
-    pimpl->postprocessing->add_post(hook);
+    return pimpl->get_frame_presentation_time_ns();
+}
+
+void render_manager::add_post(post_hook_t *hook, uint32_t flags)
+{
+    pimpl->postprocessing->add_post(hook, flags);
 }
 
 void render_manager::rem_post(post_hook_t *hook)
@@ -1744,6 +2356,16 @@ void render_manager::rem_post(post_hook_t *hook)
     pimpl->postprocessing->rem_post(hook);
 }
 
+void render_manager::add_pointwise_post(pointwise_post_effect_t *effect)
+{
+    pimpl->postprocessing->add_pointwise_post(effect);
+}
+
+void render_manager::rem_pointwise_post(pointwise_post_effect_t *effect)
+{
+    pimpl->postprocessing->rem_pointwise_post(effect);
+}
+
 wf::regionf_t render_manager::get_scheduled_damage()
 {
     return pimpl->damage_manager->get_scheduled_damage(get_target_framebuffer());
@@ -7,6 +7,8 @@
 #include <wayfire/render-manager.hpp>
 #include <wayfire/signal-definitions.hpp>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <wayfire/nonstd/reverse.hpp>
 #include <wayfire/util/log.hpp>
@@ -24,6 +26,7 @@
 #include "wayfire/scene.hpp"
 #include "wayfire/signal-provider.hpp"
 #include "wayfire/toplevel-view.hpp"
+#include "wayfire/view-registry.hpp"
 
 namespace wf
 {
@@ -109,30 +112,6 @@ struct grid_size_manager_t
     }
 };
 
-static wf::scene::node_t *find_lca(wf::scene::node_t *a, wf::scene::node_t *b)
-{
-    wf::scene::node_t *iter = a;
-    std::set<wf::scene::node_t*> a_ancestors;
-    while (iter)
-    {
-        a_ancestors.insert(iter);
-        iter = iter->parent();
-    }
-
-    iter = b;
-    while (iter)
-    {
-        if (a_ancestors.count(iter))
-        {
-            return iter;
-        }
-
-        iter = iter->parent();
-    }
-
-    return nullptr;
-}
-
 static bool is_attached_to(wf::scene::node_t *a, wf::scene::node_t *root)
 {
     while (a)
@@ -148,21 +127,26 @@ static bool is_attached_to(wf::scene::node_t *a, wf::scene::node_t *root)
     return false;
 }
 
-static bool is_attached_to_scenegraph(wf::scene::node_t *a)
-{
-    return is_attached_to(a, wf::get_core().scene().get());
-}
-
-static size_t find_index_in_parent(wf::scene::node_t *x, wf::scene::node_t *parent)
+/**
+ * Append the views from @views_by_node to @result in the order in which they are stacked below @root,
+ * topmost first. Only subtrees containing one of the views (i.e. nodes in @ancestors) are visited.
+ */
+static void collect_stacking_order(wf::scene::node_t *root,
+    const std::unordered_map<wf::scene::node_t*, wayfire_toplevel_view>& views_by_node,
+    const std::unordered_set<wf::scene::node_t*>& ancestors,
+    std::vector<wayfire_toplevel_view>& result)
 {
-    while (x->parent() != parent)
+    for (auto& child : root->get_children())
     {
-        x = x->parent();
+        auto it = views_by_node.find(child.get());
+        if (it != views_by_node.end())
+        {
+            result.push_back(it->second);
+        } else if (ancestors.count(child.get()))
+        {
+            collect_stacking_order(child.get(), views_by_node, ancestors, result);
+        }
     }
-
-    auto& children = parent->get_children();
-    auto it = std::find_if(children.begin(), children.end(), [&] (auto child) { return child.get() == x; });
-    return it - children.begin();
 }
 
 class workspace_set_root_node_t : public wf::scene::floating_inner_node_t
@@ -297,6 +281,7 @@ struct workspace_set_t::impl
         wnode->set_enabled(false);
         self->connect(&on_grid_changed);
         wf::get_core().output_layout->connect(&on_output_removed);
+        wf::get_core().scene()->connect(&on_root_node_updated);
     }
 
     ~impl()
@@ -306,6 +291,7 @@ struct workspace_set_t::impl
         for (auto view : wset_views)
         {
             view->priv->current_wset.reset();
+            wf::view_registry_t::get().update_view(view);
         }
     }
 
@@ -387,8 +373,10 @@ struct workspace_set_t::impl
 
         LOGC(WSET, "Adding view ", view, " to wset ", index);
         wset_views.push_back(view);
+        stacking_order_dirty = true;
         view->connect(&on_view_destruct);
         view->priv->current_wset = self->weak_from_this();
+        wf::view_registry_t::get().update_view(view);
         view->set_output(this->output);
     }
 
@@ -403,8 +391,10 @@ struct workspace_set_t::impl
 
         LOGC(WSET, "Removing view ", view, " from id=", index);
         wset_views.erase(it);
+        stacking_order_dirty = true;
         view->disconnect(&on_view_destruct);
         view->priv->current_wset.reset();
+        wf::view_registry_t::get().update_view(view);
     }
 
     std::vector<wayfire_toplevel_view> get_views(uint32_t flags = 0,
@@ -420,7 +410,8 @@ struct workspace_set_t::impl
             workspace = get_current_workspace();
         }
 
-        auto views = wset_views;
+        /* The stacking order already contains only views attached to the scenegraph */
+        auto views = (flags & WSET_SORT_STACKING) ? get_stacking_order() : wset_views;
         auto it    = std::remove_if(views.begin(), views.end(), [&] (wayfire_toplevel_view view)
         {
             if ((flags & WSET_MAPPED_ONLY) && !view->is_mapped())
@@ -433,11 +424,6 @@ struct workspace_set_t::impl
                 return true;
             }
 
-            if ((flags & WSET_SORT_STACKING) && !is_attached_to_scenegraph(view->get_root_node().get()))
-            {
-                return true;
-            }
-
             if (workspace && !view_visible_on(view, *workspace))
             {
                 return true;
@@ -447,30 +433,53 @@ struct workspace_set_t::impl
         });
         views.erase(it, views.end());
 
-        if (flags & WSET_SORT_STACKING)
-        {
-            std::sort(views.begin(), views.end(), [] (wayfire_toplevel_view a, wayfire_view b)
-            {
-                wf::scene::node_t *x   = a->get_root_node().get();
-                wf::scene::node_t *y   = b->get_root_node().get();
-                wf::scene::node_t *lca = find_lca(x, y);
-                wf::dassert(lca != nullptr,
-                    "LCA should always exist when the two nodes are in the scenegraph!");
-                wf::dassert((lca != x) && (lca != y), "LCA should not be equal to one of the nodes, this"
-                                                      "means nested views/dialogs have been added to the wset!");
-
-                const size_t idx_x = find_index_in_parent(x, lca);
-                const size_t idx_y = find_index_in_parent(y, lca);
-                return idx_x < idx_y;
-            });
-        }
-
         return views;
     }
 
   private:
     std::vector<wayfire_toplevel_view> wset_views;
 
+    /**
+     * The views of the wset which are attached to the scenegraph, topmost first. Instead of sorting on every
+     * get_views() call, the order is rebuilt in a single scenegraph walk after nodes were added, removed or
+     * restacked anywhere in the scenegraph.
+     */
+    std::vector<wayfire_toplevel_view> stacking_order;
+    bool stacking_order_dirty = true;
+
+    wf::signal::connection_t<wf::scene::root_node_update_signal> on_root_node_updated =
+        [=] (wf::scene::root_node_update_signal *ev)
+    {
+        if (ev->flags & wf::scene::update_flag::CHILDREN_LIST)
+        {
+            stacking_order_dirty = true;
+        }
+    };
+
+    const std::vector<wayfire_toplevel_view>& get_stacking_order()
+    {
+        if (!stacking_order_dirty)
+        {
+            return stacking_order;
+        }
+
+        std::unordered_map<wf::scene::node_t*, wayfire_toplevel_view> views_by_node;
+        std::unordered_set<wf::scene::node_t*> ancestors;
+        for (auto& view : wset_views)
+        {
+            auto node = view->get_root_node().get();
+            views_by_node[node] = view;
+            for (auto parent = node->parent(); parent && ancestors.insert(parent).second;
+                 parent = parent->parent())
+            {}
+        }
+
+        stacking_order.clear();
+        collect_stacking_order(wf::get_core().scene().get(), views_by_node, ancestors, stacking_order);
+        stacking_order_dirty = false;
+        return stacking_order;
+    }
+
     int current_vx = 0;
     int current_vy = 0;
 
@@ -1,10 +1,12 @@
 #include <wayfire/render.hpp>
 #include "core/core-impl.hpp"
+#include "core/buffer-pool.hpp"
 #include "wayfire/dassert.hpp"
 #include "wayfire/nonstd/reverse.hpp"
 #include "wayfire/opengl.hpp"
 #include <wayfire/scene-render.hpp>
 #include <cmath>
+#include <map>
 #include <drm_fourcc.h>
 
 /**
@@ -250,6 +252,182 @@ wf::render_buffer_t::render_buffer_t(wlr_buffer *buffer, wf::dimensions_t size)
     this->size   = size;
 }
 
+namespace
+{
+/**
+ * Keeps track of the memory used by auxilliary buffers, grouped by their owner.
+ */
+struct buffer_memory_tracker_t
+{
+    struct usage_t
+    {
+        uint32_t buffers = 0;
+        uint64_t bytes   = 0;
+    };
+
+    std::map<std::string, usage_t> owners;
+    uint64_t total_bytes   = 0;
+    uint64_t peak_bytes    = 0;
+    uint32_t total_buffers = 0;
+    uint32_t pressure_events = 0;
+
+    // Whether we have already notified about the budget being exceeded.
+    bool over_budget = false;
+
+    // Pressure is signalled on idle, because buffers are usually allocated in the middle of a render pass,
+    // and we do not want owners to free buffers which are about to be used in the same pass.
+    // Intentionally leaked, so that it is not destroyed after the event loop at exit.
+    wf::wl_idle_call *idle_check_budget = new wf::wl_idle_call;
+
+    static buffer_memory_tracker_t& get()
+    {
+        static buffer_memory_tracker_t tracker;
+        return tracker;
+    }
+
+    static const std::string& owner_name(const std::string& owner)
+    {
+        static const std::string unknown = "unknown";
+        return owner.empty() ? unknown : owner;
+    }
+
+    static uint64_t get_pooled_bytes()
+    {
+        auto& pool = wf::get_core_impl().buffer_pool;
+        return pool ? pool->get_pooled_bytes() : 0;
+    }
+
+    static uint64_t get_budget_bytes()
+    {
+        static wf::option_wrapper_t<int> budget_mb{"workarounds/aux_buffer_budget"};
+        return std::max(0, (int)budget_mb) * 1024ull * 1024ull;
+    }
+
+    void add(const std::string& owner, uint64_t bytes)
+    {
+        auto& usage = owners[owner_name(owner)];
+        usage.buffers++;
+        usage.bytes += bytes;
+        total_buffers++;
+        total_bytes += bytes;
+        peak_bytes   = std::max(peak_bytes, total_bytes);
+
+        const uint64_t budget = get_budget_bytes();
+        if (budget && (total_bytes + get_pooled_bytes() > budget) && !over_budget &&
+            !idle_check_budget->is_connected())
+        {
+            idle_check_budget->run_once([this] { check_budget(); });
+        }
+    }
+
+    void remove(const std::string& owner, uint64_t bytes)
+    {
+        auto it = owners.find(owner_name(owner));
+        wf::dassert(it != owners.end(), "Removing an untracked auxilliary buffer!");
+
+        it->second.buffers--;
+        it->second.bytes -= bytes;
+        if (it->second.buffers == 0)
+        {
+            owners.erase(it);
+        }
+
+        total_buffers--;
+        total_bytes -= bytes;
+        if (total_bytes <= get_budget_bytes())
+        {
+            over_budget = false;
+        }
+    }
+
+    void check_budget()
+    {
+        const uint64_t budget = get_budget_bytes();
+        if (!budget || (total_bytes + get_pooled_bytes() <= budget) || over_budget)
+        {
+            return;
+        }
+
+        // Unused pooled buffers are the cheapest memory to give back.
+        if (auto& pool = wf::get_core_impl().buffer_pool)
+        {
+            pool->clear();
+        }
+
+        if (total_bytes <= budget)
+        {
+            return;
+        }
+
+        over_budget = true;
+        pressure_events++;
+        LOGI("Auxilliary buffers use ", total_bytes / (1024 * 1024), " MiB, over the budget of ",
+            budget / (1024 * 1024), " MiB");
+
+        wf::buffer_memory_pressure_signal ev;
+        ev.used_bytes   = total_bytes;
+        ev.budget_bytes = budget;
+        wf::get_core().emit(&ev);
+    }
+};
+}
+
+static uint64_t estimate_buffer_bytes(wf::dimensions_t size, uint32_t drm_format)
+{
+    uint64_t bytes_per_pixel = 4;
+    switch (drm_format)
+    {
+      case DRM_FORMAT_ABGR16161616F:
+      case DRM_FORMAT_XBGR16161616F:
+      case DRM_FORMAT_ABGR16161616:
+      case DRM_FORMAT_XBGR16161616:
+        bytes_per_pixel = 8;
+        break;
+
+      default:
+        break;
+    }
+
+    return bytes_per_pixel * size.width * size.height;
+}
+
+wf::buffer_memory_stats_t wf::get_buffer_memory_stats()
+{
+    auto& tracker = buffer_memory_tracker_t::get();
+
+    buffer_memory_stats_t stats;
+    stats.total_bytes     = tracker.total_bytes;
+    stats.peak_bytes      = tracker.peak_bytes;
+    stats.total_buffers   = tracker.total_buffers;
+    stats.budget_bytes    = buffer_memory_tracker_t::get_budget_bytes();
+    stats.pressure_events = tracker.pressure_events;
+    for (auto& [owner, usage] : tracker.owners)
+    {
+        stats.owners.push_back({owner, usage.buffers, usage.bytes});
+    }
+
+    const auto pool = get_buffer_pool_stats();
+    if (pool.pooled_buffers > 0)
+    {
+        stats.owners.push_back({"buffer-pool", pool.pooled_buffers, pool.pooled_bytes});
+        stats.total_bytes   += pool.pooled_bytes;
+        stats.total_buffers += pool.pooled_buffers;
+    }
+
+    std::sort(stats.owners.begin(), stats.owners.end(), [] (const auto& a, const auto& b)
+    {
+        return a.bytes > b.bytes;
+    });
+
+    return stats;
+}
+
+wf::buffer_pool_stats_t wf::get_buffer_pool_stats()
+{
+    auto& pool = wf::get_core_impl().buffer_pool;
+    return pool ? pool->get_stats() : buffer_pool_stats_t{};
+}
+
 wf::auxilliary_buffer_t::auxilliary_buffer_t(auxilliary_buffer_t&& other)
 {
     *this = std::move(other);
@@ -262,11 +440,38 @@ wf::auxilliary_buffer_t& wf::auxilliary_buffer_t::operator =(auxilliary_buffer_t
         return *this;
     }
 
+    free();
     this->texture = std::exchange(other.texture, nullptr);
     this->buffer  = std::exchange(other.buffer, {});
+    this->owner   = std::move(other.owner);
+    this->accounted_bytes = std::exchange(other.accounted_bytes, 0);
+    this->drm_format = std::exchange(other.drm_format, 0);
+    other.owner.clear();
     return *this;
 }
 
+void wf::auxilliary_buffer_t::set_owner(const std::string& owner)
+{
+    if (this->owner == owner)
+    {
+        return;
+    }
+
+    if (accounted_bytes)
+    {
+        auto& tracker = buffer_memory_tracker_t::get();
+        tracker.remove(this->owner, accounted_bytes);
+        tracker.add(owner, accounted_bytes);
+    }
+
+    this->owner = owner;
+}
+
+const std::string& wf::auxilliary_buffer_t::get_owner() const
+{
+    return owner;
+}
+
 wf::auxilliary_buffer_t::~auxilliary_buffer_t()
 {
     free();
@@ -448,8 +653,17 @@ wf::buffer_reallocation_result_t wf::auxilliary_buffer_t::allocate(wf::dimension
         return buffer_reallocation_result_t::FAILED;
     }
 
-    buffer.buffer = wlr_allocator_create_buffer(wf::get_core_impl().allocator, size.width,
-        size.height, format);
+    auto& pool = wf::get_core_impl().buffer_pool;
+    if (pool)
+    {
+        buffer.buffer = pool->acquire(format->format, size).buffer;
+    }
+
+    if (!buffer.buffer)
+    {
+        buffer.buffer = wlr_allocator_create_buffer(wf::get_core_impl().allocator, size.width,
+            size.height, format);
+    }
 
     if (!buffer.buffer)
     {
@@ -466,7 +680,10 @@ wf::buffer_reallocation_result_t wf::auxilliary_buffer_t::allocate(wf::dimension
         return buffer_reallocation_result_t::FAILED;
     }
 
-    buffer.size = size;
+    buffer.size     = size;
+    drm_format      = format->format;
+    accounted_bytes = estimate_buffer_bytes(size, format->format);
+    buffer_memory_tracker_t::get().add(owner, accounted_bytes);
     return buffer_reallocation_result_t::REALLOCATED;
 }
 
@@ -479,11 +696,26 @@ void wf::auxilliary_buffer_t::free()
 
     texture = NULL;
 
+    if (accounted_bytes)
+    {
+        buffer_memory_tracker_t::get().remove(owner, accounted_bytes);
+    }
+
     if (buffer.get_buffer())
     {
-        wlr_buffer_drop(buffer.get_buffer());
+        auto& pool = wf::get_core_impl().buffer_pool;
+        if (pool)
+        {
+            pool->release(drm_format, buffer.size, {buffer.get_buffer(), accounted_bytes});
+        } else
+        {
+            wlr_buffer_drop(buffer.get_buffer());
+        }
     }
 
+    accounted_bytes = 0;
+    drm_format = 0;
+
     buffer.buffer = NULL;
     buffer.size   = {0, 0};
 }
@@ -0,0 +1,116 @@
+#include "frame-pacing.hpp"
+#include <wayfire/config/compound-option.hpp>
+#include <wayfire/matcher.hpp>
+#include <wayfire/option-wrapper.hpp>
+#include <wayfire/toplevel-view.hpp>
+#include <wayfire/workspace-set.hpp>
+
+namespace
+{
+/* A view is considered a thumbnail if its transformers shrink it below this fraction of its area. */
+constexpr double THUMBNAIL_AREA_FRACTION = 0.5;
+
+/**
+ * The per-app rules from core/frame_pacing_rules, with the view matchers created once per option change.
+ */
+class frame_pacing_rules_t
+{
+  public:
+    frame_pacing_rules_t()
+    {
+        rules_option.set_callback([=] () { load_rules(); });
+        load_rules();
+    }
+
+    int get_rate(wayfire_view view)
+    {
+        for (auto& [matcher, rate] : rules)
+        {
+            if (matcher->matches(view))
+            {
+                return rate;
+            }
+        }
+
+        return 0;
+    }
+
+  private:
+    wf::option_wrapper_t<wf::config::compound_list_t<std::string, int>> rules_option{
+        "core/frame_pacing_rules"
+    };
+    std::vector<std::pair<std::unique_ptr<wf::view_matcher_t>, int>> rules;
+
+    void load_rules()
+    {
+        rules.clear();
+        for (auto& [name, criteria, rate] : rules_option.value())
+        {
+            auto option = std::make_shared<wf::config::option_t<std::string>>(name, criteria);
+            rules.emplace_back(std::make_unique<wf::view_matcher_t>(option), rate);
+        }
+    }
+};
+
+double area(const wf::geometry_t& box)
+{
+    return std::max(0.0, box.width) * std::max(0.0, box.height);
+}
+}
+
+wf::scene::frame_pacing_t wf::compute_frame_pacing(const frame_pacing_config_t& config,
+    const frame_pacing_input_t& input)
+{
+    scene::frame_pacing_t result;
+    result.visible_fraction = input.visible_fraction;
+
+    auto limit = [&] (bool applies, int rate, const char *reason)
+    {
+        if (applies && (rate > 0) && ((result.max_rate == 0) || (rate < result.max_rate)))
+        {
+            result.max_rate = rate;
+            result.reason   = reason;
+        }
+    };
+
+    limit(input.rule_rate > 0, input.rule_rate, "rule");
+    limit(input.thumbnail, config.thumbnail_rate, "thumbnail");
+    limit(input.visible_fraction < config.occluded_fraction, config.occluded_rate, "occluded");
+    limit(input.other_workspace, config.background_rate, "other-workspace");
+    limit(input.minimized, config.background_rate, "minimized");
+    return result;
+}
+
+wf::scene::frame_pacing_t wf::compute_frame_pacing(scene::wlr_surface_node_t *node, double visible_fraction)
+{
+    static wf::option_wrapper_t<double> occluded_fraction{"core/frame_pacing_occluded_fraction"};
+    static wf::option_wrapper_t<int> occluded_rate{"core/frame_pacing_occluded_rate"};
+    static wf::option_wrapper_t<int> background_rate{"core/frame_pacing_background_rate"};
+    static wf::option_wrapper_t<int> thumbnail_rate{"core/frame_pacing_thumbnail_rate"};
+    static frame_pacing_rules_t rules;
+
+    frame_pacing_config_t config;
+    config.occluded_fraction = occluded_fraction;
+    config.occluded_rate     = occluded_rate;
+    config.background_rate   = background_rate;
+    config.thumbnail_rate    = thumbnail_rate;
+
+    frame_pacing_input_t input;
+    input.visible_fraction = visible_fraction;
+    if (auto view = wf::node_to_view(node))
+    {
+        input.rule_rate = rules.get_rate(view);
+        input.thumbnail = area(view->get_bounding_box()) <
+            THUMBNAIL_AREA_FRACTION * area(view->get_surface_root_node()->get_bounding_box());
+
+        if (auto toplevel = wf::toplevel_cast(view))
+        {
+            input.minimized = toplevel->minimized;
+            auto wset = toplevel->get_wset();
+            input.other_workspace = wset && (!wset->get_attached_output() ||
+                !wset->view_visible_on(toplevel, wset->get_current_workspace()));
+        }
+    }
+
+    return compute_frame_pacing(config, input);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <wayfire/unstable/wlr-surface-node.hpp>
+
+namespace wf
+{
+/**
+ * The state of a surface which is relevant for pacing its frame callbacks.
+ */
+struct frame_pacing_input_t
+{
+    /** The largest fraction of the surface visible on any output, between 0 and 1. */
+    double visible_fraction = 1.0;
+    /** The surface belongs to a minimized view. */
+    bool minimized = false;
+    /** The surface belongs to a view which is not on the current workspace of its output. */
+    bool other_workspace = false;
+    /** The surface belongs to a view which is shown scaled down, for example in scale. */
+    bool thumbnail = false;
+    /** The rate from the first matching per-app rule, or 0 if no rule matches. */
+    int rule_rate = 0;
+};
+
+/**
+ * The frame callback rate limits for each surface state. A rate of 0 means that the state does not limit the
+ * frame rate.
+ */
+struct frame_pacing_config_t
+{
+    double occluded_fraction = 0.0;
+    int occluded_rate   = 0;
+    int background_rate = 0;
+    int thumbnail_rate  = 0;
+};
+
+/**
+ * Compute the frame callback rate limit for a surface: the lowest rate of all limits which apply.
+ */
+scene::frame_pacing_t compute_frame_pacing(const frame_pacing_config_t& config,
+    const frame_pacing_input_t& input);
+
+/**
+ * Compute the frame callback rate limit for the given surface node from the core/frame_pacing_* options and
+ * the state of the view the surface belongs to.
+ */
+scene::frame_pacing_t compute_frame_pacing(scene::wlr_surface_node_t *node, double visible_fraction);
+}
@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <cstring>
 #include <cstdlib>
+#include <optional>
+#include <tuple>
 
 #include <wayfire/seat.hpp>
 #include <wayfire/workarea.hpp>
@@ -61,8 +63,13 @@ class wayfire_layer_shell_view : public wf::view_interface_t
 
     static std::shared_ptr<wayfire_layer_shell_view> create(wlr_layer_surface_v1 *lsurface);
     std::unique_ptr<wf::output_workarea_manager_t::anchored_area> anchored_area;
+    /** The workarea passed to the view by the last reflow of its anchored area. */
+    wf::geometry_t reflowed_workarea{0, 0, 0, 0};
     void remove_anchored(bool reflow);
 
+    /** The last box passed to configure(), reset when the view is unmapped. */
+    std::optional<wf::geometry_t> last_configure;
+
     virtual ~wayfire_layer_shell_view() = default;
 
     void map();
@@ -145,6 +152,20 @@ wf::output_workarea_manager_t::anchored_edge anchor_to_edge(uint32_t edges)
     abort();
 }
 
+/**
+ * The arrangement state of the layer-shell views on an output.
+ */
+struct layer_shell_output_data_t : public wf::custom_data_t
+{
+    wf::wl_idle_call idle_arrange;
+
+    /** The view, edge and size of each reserved area at the time of the last reflow. */
+    using anchor_t = std::tuple<wayfire_layer_shell_view*, int, int>;
+    std::vector<anchor_t> reflowed_anchors;
+    wf::geometry_t reflowed_output_geometry{0, 0, 0, 0};
+    bool reflowed = false;
+};
+
 struct wf_layer_shell_manager
 {
   private:
@@ -154,7 +175,7 @@ struct wf_layer_shell_manager
         auto outputs = wf::get_core().output_layout->get_outputs();
         for (auto wo : outputs)
         {
-            arrange_layers(wo);
+            schedule_arrange(wo);
         }
     };
 
@@ -180,7 +201,7 @@ struct wf_layer_shell_manager
     void handle_map(wayfire_layer_shell_view *view)
     {
         layers[view->lsurface->current.layer].push_back(view);
-        arrange_layers(view->get_output());
+        schedule_arrange(view->get_output());
     }
 
     void remove_view_from_layer(wayfire_layer_shell_view *view, uint32_t layer)
@@ -207,7 +228,16 @@ struct wf_layer_shell_manager
     {
         view->remove_anchored(false);
         remove_view_from_layer(view, view->lsurface->current.layer);
-        arrange_layers(view->get_output());
+        if (auto output = view->get_output())
+        {
+            // The view may be destroyed before the next arrange, and a new view could then be allocated at
+            // the same address, so do not keep pointers to it. Its reserved area is gone, so reflow anyway.
+            auto data = output->get_data_safe<layer_shell_output_data_t>();
+            data->reflowed_anchors.clear();
+            data->reflowed = false;
+        }
+
+        schedule_arrange(view->get_output());
     }
 
     layer_t filter_views(wf::output_t *output, int layer)
@@ -256,6 +286,7 @@ struct wf_layer_shell_manager
                 std::make_unique<wf::output_workarea_manager_t::anchored_area>();
             v->anchored_area->reflowed = [this, v] (wf::geometry_t avail_workarea)
             {
+                v->reflowed_workarea = avail_workarea;
                 pin_view(v, avail_workarea);
             };
             /* Notice that the reflowed areas won't be changed until we call
@@ -381,6 +412,23 @@ struct wf_layer_shell_manager
         view->get_output()->workarea->reflow_reserved_areas();
     }
 
+    /**
+     * Arrange the layers of the output once the event loop is idle. Clients like status bars may commit
+     * new state very often, and several views may change at once, so arranging is coalesced.
+     */
+    void schedule_arrange(wf::output_t *output)
+    {
+        if (!output)
+        {
+            return;
+        }
+
+        output->get_data_safe<layer_shell_output_data_t>()->idle_arrange.run_once([=] ()
+        {
+            arrange_layers(output);
+        });
+    }
+
     void arrange_layers(wf::output_t *output)
     {
         const auto layers = {
@@ -390,12 +438,38 @@ struct wf_layer_shell_manager
             ZWLR_LAYER_SHELL_V1_LAYER_BACKGROUND
         };
 
+        auto data = output->get_data_safe<layer_shell_output_data_t>();
+        data->idle_arrange.disconnect();
+
+        std::vector<layer_shell_output_data_t::anchor_t> anchors;
         for (auto& layer : layers)
         {
             arrange_exclusive_zone(output, layer);
+            for (auto v : filter_views(output, layer))
+            {
+                if (v->anchored_area)
+                {
+                    anchors.emplace_back(v, v->anchored_area->edge, v->anchored_area->reserved_size);
+                }
+            }
         }
 
-        output->workarea->reflow_reserved_areas();
+        if (!data->reflowed || (anchors != data->reflowed_anchors) ||
+            (output->get_relative_geometry() != data->reflowed_output_geometry))
+        {
+            output->workarea->reflow_reserved_areas();
+            data->reflowed_anchors = std::move(anchors);
+            data->reflowed_output_geometry = output->get_relative_geometry();
+            data->reflowed = true;
+        } else
+        {
+            // The reserved areas did not change, so neither did the workarea. We only need to place the
+            // views with exclusive zones again, in case their size changed.
+            for (auto& [v, edge, size] : data->reflowed_anchors)
+            {
+                pin_view(v, v->reflowed_workarea);
+            }
+        }
 
         for (auto& layer : layers)
         {
@@ -550,6 +624,7 @@ void wayfire_layer_shell_view::unmap()
     on_surface_commit.disconnect();
     emit_view_unmap();
     priv->set_enabled(false);
+    last_configure.reset();
     wf_layer_shell_manager::get_instance().handle_unmap(this);
 }
 
@@ -581,7 +656,7 @@ void wayfire_layer_shell_view::commit()
         } else
         {
             /* Reflow reserved areas and positions */
-            wf_layer_shell_manager::get_instance().arrange_layers(get_output());
+            wf_layer_shell_manager::get_instance().schedule_arrange(get_output());
         }
 
         if (prev_state.keyboard_interactive != state->keyboard_interactive)
@@ -654,6 +729,14 @@ void wayfire_layer_shell_view::configure(wf::geometry_t box)
         return;
     }
 
+    if (last_configure == box)
+    {
+        // Nothing changed since the last configure, avoid needless damage and configure events.
+        return;
+    }
+
+    last_configure = box;
+
     // TODO: transactions here could make sense, since we want to change x,y,w,h together, but have to wait
     // for the client to resize.
     move(box.x, box.y);
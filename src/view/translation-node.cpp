@@ -133,3 +133,9 @@ void wf::scene::translation_node_instance_t::compute_visibility(wf::output_t *ou
 {
     compute_visibility_from_list(children, output, visible, self->get_offset());
 }
+
+void wf::scene::translation_node_instance_t::collect_plane_candidates(wf::output_t *output,
+    plane_collector_t& collector)
+{
+    collect_plane_candidates_from_list(children, output, collector, self->get_offset());
+}
@@ -94,6 +94,14 @@ core_vulkan_state_t& core_ensure_vk(wf::vulkan_render_state_t& state)
 
     auto data = std::make_unique<core_vulkan_state_t>();
     data->pipeline = std::make_shared<wf::vk::graphics_pipeline_t>(state.get_context(), params);
+
+    // Textures are sampled with different transfer functions and rotations (e.g. rotated outputs or
+    // clients), compile those variants in the background once the first view is rendered.
+    for (const auto& specialization : wf::vk::pipeline_specialization_t::get_common_texture_specializations())
+    {
+        data->pipeline->add_expected_specialization(specialization);
+    }
+
     auto ptr = data.get();
     state.store_data<core_vulkan_state_t>(std::move(data));
     return *ptr;
@@ -618,6 +626,11 @@ uint32_t transformer_base_node_t::optimize_update(uint32_t flags)
 std::shared_ptr<wf::texture_t> transformer_base_node_t::get_updated_contents(const wf::geometry_t& bbox,
     float scale, std::vector<scene::render_instance_uptr>& children, wf::output_t *output)
 {
+    if (inner_content.get_owner().empty())
+    {
+        inner_content.set_owner(stringify());
+    }
+
     if (inner_content.allocate(wf::dimensions(bbox), scale,
         wf::buffer_allocation_hints_t{.hdr_linear = output && output->is_hdr()}) !=
         buffer_reallocation_result_t::SAME)
@@ -0,0 +1,269 @@
+#include <wayfire/view-registry.hpp>
+#include <wayfire/core.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/toplevel-view.hpp>
+#include <wayfire/nonstd/tracking-allocator.hpp>
+
+#include <unordered_map>
+
+namespace
+{
+/**
+ * A set of views with O(1) insertion and removal, which can be iterated as a vector.
+ * Removal moves the last view into the freed slot, so the order of the views is not preserved.
+ */
+class view_bucket_t
+{
+  public:
+    std::vector<wayfire_view> views;
+
+    void insert(wayfire_view view)
+    {
+        if (position.count(view.get()))
+        {
+            return;
+        }
+
+        position[view.get()] = views.size();
+        views.push_back(view);
+    }
+
+    void erase(wayfire_view view)
+    {
+        auto it = position.find(view.get());
+        if (it == position.end())
+        {
+            return;
+        }
+
+        const size_t idx = it->second;
+        position.erase(it);
+        if (idx + 1 != views.size())
+        {
+            views[idx] = views.back();
+            position[views[idx].get()] = idx;
+        }
+
+        views.pop_back();
+    }
+
+  private:
+    std::unordered_map<wf::view_interface_t*, size_t> position;
+};
+
+/** An index of views by a single property. */
+template<class Key>
+class view_index_t
+{
+  public:
+    const std::vector<wayfire_view>& find(const Key& key)
+    {
+        static const std::vector<wayfire_view> no_views;
+        auto it = buckets.find(key);
+        return (it == buckets.end()) ? no_views : it->second.views;
+    }
+
+    void insert(wayfire_view view, const Key& key)
+    {
+        buckets[key].insert(view);
+    }
+
+    void move(wayfire_view view, const Key& from, const Key& to)
+    {
+        erase(view, from);
+        insert(view, to);
+    }
+
+    void erase(wayfire_view view, const Key& key)
+    {
+        auto it = buckets.find(key);
+        if (it != buckets.end())
+        {
+            it->second.erase(view);
+        }
+    }
+
+  private:
+    /* Empty buckets are kept, so that lists returned by find() stay valid while views are removed */
+    std::unordered_map<Key, view_bucket_t> buckets;
+};
+}
+
+struct wf::view_registry_t::impl
+{
+    /** The indexed properties of a view, as of its last update. */
+    struct entry_t
+    {
+        std::string app_id;
+        wf::output_t *output = nullptr;
+        wf::workspace_set_t *wset = nullptr;
+        view_role_t role = VIEW_ROLE_TOPLEVEL;
+    };
+
+    std::unordered_map<view_interface_t*, entry_t> entries;
+    std::unordered_map<uint32_t, wayfire_view> by_id;
+    view_index_t<std::string> by_app_id;
+    view_index_t<wf::output_t*> by_output;
+    view_index_t<wf::workspace_set_t*> by_wset;
+    view_index_t<view_role_t> by_role;
+
+    wf::signal::connection_t<wf::view_app_id_changed_signal> on_app_id_changed =
+        [=] (wf::view_app_id_changed_signal *ev) { update_view(ev->view); };
+    wf::signal::connection_t<wf::view_set_output_signal> on_set_output =
+        [=] (wf::view_set_output_signal *ev) { update_view(ev->view); };
+    wf::signal::connection_t<wf::view_mapped_signal> on_view_mapped =
+        [=] (wf::view_mapped_signal *ev) { update_view(ev->view); };
+    wf::signal::connection_t<wf::view_unmapped_signal> on_view_unmapped =
+        [=] (wf::view_unmapped_signal *ev) { update_view(ev->view); };
+
+    void connect_to_core()
+    {
+        /* A new core is created for each headless test, and destroying the old one disconnects us */
+        if (on_app_id_changed.is_connected())
+        {
+            return;
+        }
+
+        wf::get_core().connect(&on_app_id_changed);
+        wf::get_core().connect(&on_set_output);
+        wf::get_core().connect(&on_view_mapped);
+        wf::get_core().connect(&on_view_unmapped);
+    }
+
+    void add_view(wayfire_view view)
+    {
+        if (entries.count(view.get()))
+        {
+            return;
+        }
+
+        connect_to_core();
+        auto& entry = entries[view.get()];
+        entry.app_id = view->get_app_id();
+        entry.output = view->get_output();
+        entry.wset   = get_wset(view);
+        entry.role   = view->role;
+
+        by_id[view->get_id()] = view;
+        by_app_id.insert(view, entry.app_id);
+        by_output.insert(view, entry.output);
+        by_wset.insert(view, entry.wset);
+        by_role.insert(view, entry.role);
+    }
+
+    void update_view(wayfire_view view)
+    {
+        auto it = entries.find(view.get());
+        if (it == entries.end())
+        {
+            return;
+        }
+
+        auto& entry = it->second;
+        auto app_id = view->get_app_id();
+        if (app_id != entry.app_id)
+        {
+            by_app_id.move(view, entry.app_id, app_id);
+            entry.app_id = app_id;
+        }
+
+        if (view->get_output() != entry.output)
+        {
+            by_output.move(view, entry.output, view->get_output());
+            entry.output = view->get_output();
+        }
+
+        if (get_wset(view) != entry.wset)
+        {
+            by_wset.move(view, entry.wset, get_wset(view));
+            entry.wset = get_wset(view);
+        }
+
+        if (view->role != entry.role)
+        {
+            by_role.move(view, entry.role, view->role);
+            entry.role = view->role;
+        }
+    }
+
+    void remove_view(view_interface_t *view)
+    {
+        auto it = entries.find(view);
+        if (it == entries.end())
+        {
+            return;
+        }
+
+        auto& entry = it->second;
+        wayfire_view handle{view};
+        by_id.erase(view->get_id());
+        by_app_id.erase(handle, entry.app_id);
+        by_output.erase(handle, entry.output);
+        by_wset.erase(handle, entry.wset);
+        by_role.erase(handle, entry.role);
+        entries.erase(it);
+    }
+
+    static wf::workspace_set_t *get_wset(wayfire_view view)
+    {
+        auto toplevel = toplevel_cast(view);
+        return toplevel ? toplevel->get_wset().get() : nullptr;
+    }
+};
+
+wf::view_registry_t::view_registry_t() : priv(std::make_unique<impl>())
+{}
+
+wf::view_registry_t::~view_registry_t() = default;
+
+wf::view_registry_t& wf::view_registry_t::get()
+{
+    static view_registry_t registry;
+    return registry;
+}
+
+const std::vector<wayfire_view>& wf::view_registry_t::get_all()
+{
+    return tracking_allocator_t<view_interface_t>::get().get_all();
+}
+
+wayfire_view wf::view_registry_t::find_by_id(uint32_t id)
+{
+    auto it = priv->by_id.find(id);
+    return (it == priv->by_id.end()) ? nullptr : it->second;
+}
+
+const std::vector<wayfire_view>& wf::view_registry_t::with_app_id(const std::string& app_id)
+{
+    return priv->by_app_id.find(app_id);
+}
+
+const std::vector<wayfire_view>& wf::view_registry_t::on_output(wf::output_t *output)
+{
+    return priv->by_output.find(output);
+}
+
+const std::vector<wayfire_view>& wf::view_registry_t::in_wset(wf::workspace_set_t *wset)
+{
+    return priv->by_wset.find(wset);
+}
+
+const std::vector<wayfire_view>& wf::view_registry_t::with_role(view_role_t role)
+{
+    return priv->by_role.find(role);
+}
+
+void wf::view_registry_t::add_view(wayfire_view view)
+{
+    priv->add_view(view);
+}
+
+void wf::view_registry_t::update_view(wayfire_view view)
+{
+    priv->update_view(view);
+}
+
+void wf::view_registry_t::remove_view(view_interface_t *view)
+{
+    priv->remove_view(view);
+}
@@ -8,6 +8,7 @@
 #include "wayfire/scene-render.hpp"
 #include "wayfire/scene.hpp"
 #include "wayfire/view.hpp"
+#include "wayfire/view-registry.hpp"
 #include "wayfire/view-transform.hpp"
 
 #include <glm/glm.hpp>
@@ -17,6 +18,7 @@
 void wf::view_interface_t::set_role(view_role_t new_role)
 {
     role = new_role;
+    wf::view_registry_t::get().update_view({this});
 }
 
 std::string wf::view_interface_t::to_string() const
@@ -96,6 +98,11 @@ void wf::view_interface_t::take_snapshot(wf::auxilliary_buffer_t& buffer)
     auto root_node = get_surface_root_node();
     const wf::geometry_t bbox = root_node->get_bounding_box();
     float scale = get_output()->handle->scale;
+    if (buffer.get_owner().empty())
+    {
+        buffer.set_owner("snapshot of " + to_string());
+    }
+
     buffer.allocate(wf::dimensions(bbox), scale,
         wf::buffer_allocation_hints_t{.hdr_linear = get_output() && get_output()->is_hdr()});
 
@@ -176,6 +183,7 @@ void wf::view_interface_t::base_initialization()
     priv->transformed_node = std::make_shared<scene::transform_manager_node_t>();
     priv->root_node->set_children_list({priv->transformed_node});
     priv->root_node->set_enabled(false);
+    wf::view_registry_t::get().add_view({this});
 
     priv->pre_free = [=] (auto)
     {
@@ -195,6 +203,7 @@ void wf::view_interface_t::base_initialization()
 
 wf::view_interface_t::~view_interface_t()
 {
+    wf::view_registry_t::get().remove_view(this);
     wf::scene::remove_child(get_root_node());
 }
 
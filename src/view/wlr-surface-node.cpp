@@ -5,6 +5,7 @@
 #include "wayfire/scene.hpp"
 #include "wlr-surface-pointer-interaction.hpp"
 #include "wlr-surface-touch-interaction.cpp"
+#include "frame-pacing.hpp"
 #include "wayfire/output-layout.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
@@ -39,9 +40,11 @@ wf::scene::surface_state_t& wf::scene::surface_state_t::operator =(surface_state
     src_viewport = other.src_viewport;
     transform    = other.transform;
     color_transform = other.color_transform;
+    cached_texture  = std::move(other.cached_texture);
 
     other.current_buffer = NULL;
     other.texture = NULL;
+    other.cached_texture.reset();
     other.accumulated_damage.clear();
     other.opaque_region.clear();
     other.src_viewport.reset();
@@ -67,6 +70,12 @@ void wf::scene::surface_state_t::merge_state(wlr_surface *surface)
 
     acquire_point = {};
 
+    if (!surface->buffer || (current_buffer != &surface->buffer->base) ||
+        (texture != surface->buffer->texture))
+    {
+        cached_texture.reset();
+    }
+
     if (surface->buffer)
     {
         this->current_buffer = &surface->buffer->base;
@@ -164,6 +173,35 @@ void wf::scene::surface_state_t::merge_state(wlr_surface *surface)
     this->opaque_region = wf::regionf_t{&surface->opaque_region};
 }
 
+std::shared_ptr<wf::texture_t> wf::scene::surface_state_t::get_texture() const
+{
+    if (!current_buffer)
+    {
+        return nullptr;
+    }
+
+    if (!cached_texture)
+    {
+        cached_texture = wf::texture_t::from_buffer(current_buffer, texture);
+    }
+
+    cached_texture->set_source_box(src_viewport);
+    cached_texture->set_transform(transform);
+    cached_texture->set_color_transform(color_transform);
+    cached_texture->set_wait_timeline(acquire_point);
+    cached_texture->set_filter_mode({});
+    return cached_texture;
+}
+
+void wf::scene::surface_state_t::reuse_texture_from(surface_state_t& other)
+{
+    if (!cached_texture && current_buffer && (current_buffer == other.current_buffer) &&
+        (texture == other.texture))
+    {
+        cached_texture = std::move(other.cached_texture);
+    }
+}
+
 wf::scene::surface_state_t::~surface_state_t()
 {
     if (current_buffer)
@@ -213,6 +251,8 @@ wf::scene::wlr_surface_node_t::wlr_surface_node_t(wlr_surface *surface, bool aut
     {
         visibility.erase(ev->output);
         pending_visibility_delta.erase(ev->output);
+        visible_fraction.erase(ev->output);
+        frame_pacing_dirty = true;
     });
     wf::get_core().output_layout->connect(&on_output_remove);
 }
@@ -265,6 +305,7 @@ void wf::scene::wlr_surface_node_t::apply_state(surface_state_t&& state)
         state.accumulated_damage |= wf::construct_box({0, 0}, state.size);
     }
 
+    state.reuse_texture_from(current_state);
     this->current_state = std::move(state);
     this->size_on_primary_output = calculate_primary_output_size(current_state);
     this->current_state.opaque_region &= get_render_geometry();
@@ -345,6 +386,10 @@ void wf::scene::wlr_surface_node_t::send_frame_done(bool delay_until_vblank)
         timespec now;
         clock_gettime(CLOCK_MONOTONIC, &now);
         wlr_surface_send_frame_done(surface, &now);
+        last_frame_done = wf::get_current_time();
+        delayed_frame_done.disconnect();
+        update_frame_callback_rate(last_frame_done);
+        ++frames_in_window;
     } else
     {
         for (auto& [wo, _] : visibility)
@@ -354,21 +399,104 @@ void wf::scene::wlr_surface_node_t::send_frame_done(bool delay_until_vblank)
     }
 }
 
+void wf::scene::wlr_surface_node_t::send_paced_frame_done()
+{
+    const int max_rate = get_frame_pacing().max_rate;
+    if (max_rate <= 0)
+    {
+        send_frame_done(false);
+        return;
+    }
+
+    // Surfaces visible on multiple outputs get frame events from each of them, so we may be called multiple
+    // times per frame. The timer sends the frame callback when it is due.
+    const int64_t interval = 1000 / max_rate;
+    const int64_t elapsed  = wf::get_current_time() - last_frame_done;
+    if (elapsed >= interval)
+    {
+        send_frame_done(false);
+    } else if (!delayed_frame_done.is_connected())
+    {
+        delayed_frame_done.set_timeout(interval - elapsed, [=] () { send_frame_done(false); });
+    }
+}
+
+const wf::scene::frame_pacing_t& wf::scene::wlr_surface_node_t::get_frame_pacing()
+{
+    // The state of the view (and the per-app rules) are not tracked, so poll them from time to time.
+    static constexpr int64_t FRAME_PACING_REFRESH_MS = 250;
+    const int64_t now = wf::get_current_time();
+    if (frame_pacing_dirty || (now - frame_pacing_updated >= FRAME_PACING_REFRESH_MS))
+    {
+        double fraction = 0.0;
+        for (auto& [wo, f] : visible_fraction)
+        {
+            fraction = std::max(fraction, f);
+        }
+
+        frame_pacing = compute_frame_pacing(this, visible_fraction.empty() ? 1.0 : fraction);
+        frame_pacing_updated = now;
+        frame_pacing_dirty   = false;
+    }
+
+    return frame_pacing;
+}
+
+double wf::scene::wlr_surface_node_t::get_frame_callback_rate()
+{
+    update_frame_callback_rate(wf::get_current_time());
+    return frame_callback_rate;
+}
+
+void wf::scene::wlr_surface_node_t::update_frame_callback_rate(int64_t now)
+{
+    static constexpr int64_t FRAME_RATE_WINDOW_MS = 1000;
+    const int64_t elapsed = now - frame_rate_window_start;
+    if (elapsed >= FRAME_RATE_WINDOW_MS)
+    {
+        // A surface which stopped receiving frame callbacks has a long window with few frames, so its rate
+        // drops instead of keeping the last value.
+        frame_callback_rate     = frames_in_window * 1000.0 / elapsed;
+        frames_in_window        = 0;
+        frame_rate_window_start = now;
+    }
+}
+
+void wf::scene::wlr_surface_node_t::set_visible_fraction(wf::output_t *output, double fraction)
+{
+    auto& current = visible_fraction[output];
+    if (current != fraction)
+    {
+        current = fraction;
+        frame_pacing_dirty = true;
+    }
+}
+
 class wf::scene::wlr_surface_node_t::wlr_surface_render_instance_t : public render_instance_t
 {
     std::shared_ptr<wlr_surface_node_t> self;
     wf::signal::connection_t<wf::frame_done_signal> on_frame_done = [=] (wf::frame_done_signal *ev)
     {
-        self->send_frame_done(false);
+        self->send_paced_frame_done();
     };
 
     wf::output_t *visible_on;
     damage_callback push_damage;
     wf::regionf_t last_visibility;
 
+    // Whether the surface is displayed on an output layer of visible_on instead of being composited.
+    bool promoted = false;
+
     wf::signal::connection_t<node_damage_signal> on_surface_damage =
         [=] (node_damage_signal *data)
     {
+        if (promoted)
+        {
+            // Nothing to composite, the new buffer just has to be put on the output layer.
+            visible_on->render->schedule_redraw();
+            return;
+        }
+
         if (self->surface)
         {
             // Make sure to expand damage, because stretching the surface may cause additional damage.
@@ -421,6 +549,11 @@ class wf::scene::wlr_surface_node_t::wlr_surface_render_instance_t : public rend
     void schedule_instructions(std::vector<render_instruction_t>& instructions,
         const wf::render_target_t& target, wf::regionf_t& damage) override
     {
+        if (promoted)
+        {
+            return;
+        }
+
         wf::regionf_t our_damage = damage & self->get_bounding_box();
         if (!our_damage.empty())
         {
@@ -543,7 +676,17 @@ class wf::scene::wlr_surface_node_t::wlr_surface_render_instance_t : public rend
             "workarounds/enable_opaque_region_damage_optimizations"
         };
 
-        if (!(visible & our_box).empty())
+        const auto our_visible = visible & our_box;
+        double visible_area = 0.0;
+        for (auto& rect : our_visible)
+        {
+            visible_area += (rect.x2 - rect.x1) * (rect.y2 - rect.y1);
+        }
+
+        const double our_area = our_box.width * our_box.height;
+        self->set_visible_fraction(output, our_area > 0 ? std::min(1.0, visible_area / our_area) : 0.0);
+
+        if (!our_visible.empty())
         {
             // We are visible on the given output => send wl_surface.frame on output frame, so that clients
             // can draw the next frame.
@@ -554,6 +697,34 @@ class wf::scene::wlr_surface_node_t::wlr_surface_render_instance_t : public rend
             }
         }
     }
+
+    void collect_plane_candidates(wf::output_t *output, plane_collector_t& collector) override
+    {
+        promoted = false;
+        auto our_box = self->get_bounding_box();
+        auto& state  = self->current_state;
+
+        // Output layers cannot rotate buffers and do not wait for explicit sync fences. Color conversion is
+        // bypassed just like with direct scanout, see try_scanout().
+        bool suitable = self->surface && state.current_buffer && (output == visible_on) &&
+            (state.transform == output->handle->transform) && !state.acquire_point;
+        if (suitable && output->is_hdr())
+        {
+            suitable = (state.color_transform.transfer_function == WLR_COLOR_TRANSFER_FUNCTION_ST2084_PQ) &&
+                (state.color_transform.primaries == WLR_COLOR_NAMED_PRIMARIES_BT2020);
+        }
+
+        if (!suitable)
+        {
+            collector.occlude(our_box);
+            return;
+        }
+
+        wlr_fbox src_box = state.src_viewport.value_or(wlr_fbox{
+            0.0, 0.0, (double)state.current_buffer->width, (double)state.current_buffer->height,
+        });
+        collector.add_candidate(&promoted, state.current_buffer, src_box, our_box);
+    }
 };
 
 void wf::scene::wlr_surface_node_t::gen_render_instances(
@@ -582,13 +753,8 @@ wlr_surface*wf::scene::wlr_surface_node_t::get_surface() const
 std::shared_ptr<wf::texture_t> wf::scene::wlr_surface_node_t::to_texture(
     wf::dimensionsf_t *out_logical_size) const
 {
-    if (this->current_state.current_buffer)
+    if (auto tex = current_state.get_texture())
     {
-        auto tex = wf::texture_t::from_buffer(current_state.current_buffer, current_state.texture);
-        tex->set_source_box(current_state.src_viewport);
-        tex->set_transform(current_state.transform);
-        tex->set_color_transform(current_state.color_transform);
-        tex->set_wait_timeline(current_state.acquire_point);
         if (out_logical_size)
         {
             *out_logical_size = size_on_primary_output;
@@ -643,6 +809,8 @@ void wf::scene::wlr_surface_node_t::update_pending_outputs()
             if (visibility[wo] <= 0)
             {
                 visibility.erase(wo);
+                visible_fraction.erase(wo);
+                frame_pacing_dirty = true;
             }
         }
     }
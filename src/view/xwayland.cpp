@@ -235,6 +235,7 @@ void wf::init_xwayland(bool lazy)
 
     on_xwayland_ready.set_callback([&] (void *data)
     {
+        wf::get_core_impl().startup_timeline.end_phase("xwayland");
         if (!wf::xw::load_basic_atoms(xwayland_handle->display_name))
         {
             LOGE("Failed to load Xwayland atoms.");
@@ -255,6 +256,12 @@ void wf::init_xwayland(bool lazy)
         }
     });
 
+    if (!lazy)
+    {
+        // Measured until the server is ready. In lazy mode, Xwayland is started on demand instead.
+        wf::get_core_impl().startup_timeline.begin_phase("xwayland");
+    }
+
     xwayland_handle = wlr_xwayland_create(wf::get_core().display,
         wf::get_core_impl().compositor, lazy);
 
@@ -262,6 +269,9 @@ void wf::init_xwayland(bool lazy)
     {
         on_xwayland_surface_created.connect(&xwayland_handle->events.new_surface);
         on_xwayland_ready.connect(&xwayland_handle->events.ready);
+    } else
+    {
+        wf::get_core_impl().startup_timeline.end_phase("xwayland");
     }
 
 #endif
@@ -0,0 +1,116 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/seat.hpp>
+#include <wayfire/scene-operations.hpp>
+#include <wayfire/plugins/common/input-grab.hpp>
+
+#include "../support/headless-core-harness.hpp"
+
+namespace
+{
+class counting_pointer_interaction_t : public wf::pointer_interaction_t
+{
+  public:
+    int motion_count = 0;
+    wf::pointf_t last_position = {0, 0};
+    uint32_t last_time = 0;
+
+    void handle_pointer_motion(wf::pointf_t position, uint32_t time_ms) override
+    {
+        motion_count++;
+        last_position = position;
+        last_time     = time_ms;
+    }
+};
+
+const std::string coalescing_config =
+    "[input]\n"
+    "coalesce_pointer_motion = true\n";
+}
+
+TEST_CASE("pointer motion is handled per event without coalescing")
+{
+    wf::test::headless_core_harness_t harness;
+    counting_pointer_interaction_t pointer;
+    harness.pointer_motion(100, 100);
+
+    wf::input_grab_t input_grab{"test", harness.output(), nullptr, &pointer, nullptr};
+    input_grab.grab_input(wf::scene::layer::OVERLAY);
+    pointer.motion_count = 0;
+
+    const auto before = wf::get_core().seat->get_pointer_motion_stats();
+    for (int i = 0; i < 10; i++)
+    {
+        harness.pointer_relative_motion(1, 0);
+    }
+
+    const auto after = wf::get_core().seat->get_pointer_motion_stats();
+    CHECK(pointer.motion_count == 10);
+    CHECK(after.motion_events - before.motion_events == 10);
+    CHECK(after.position_updates - before.position_updates == 10);
+    input_grab.ungrab_input();
+}
+
+TEST_CASE("explicit grabs receive coalesced pointer motion once per frame")
+{
+    wf::test::headless_core_harness_t harness{coalescing_config};
+    counting_pointer_interaction_t pointer;
+    harness.pointer_motion(100, 100);
+
+    wf::input_grab_t input_grab{"test", harness.output(), nullptr, &pointer, nullptr};
+    input_grab.grab_input(wf::scene::layer::OVERLAY);
+    harness.roundtrip();
+    pointer.motion_count = 0;
+
+    const auto before = wf::get_core().seat->get_pointer_motion_stats();
+    for (int i = 0; i < 10; i++)
+    {
+        harness.pointer_relative_motion(1, 0);
+    }
+
+    CHECK(pointer.motion_count == 0);
+    REQUIRE(harness.run_until([&] { return pointer.motion_count > 0; }));
+
+    const auto after = wf::get_core().seat->get_pointer_motion_stats();
+    CHECK(pointer.motion_count == 1);
+    CHECK(pointer.last_position.x == doctest::Approx(110));
+    CHECK(after.motion_events - before.motion_events == 10);
+    CHECK(after.forwarded_events == before.forwarded_events);
+    CHECK(after.position_updates - before.position_updates == 1);
+    input_grab.ungrab_input();
+}
+
+TEST_CASE("focused nodes receive every motion event while focus updates are coalesced")
+{
+    wf::test::headless_core_harness_t harness{coalescing_config};
+    counting_pointer_interaction_t pointer;
+    harness.pointer_motion(100, 100);
+
+    auto node = std::make_shared<wf::scene::grab_node_t>("test", harness.output(), nullptr, &pointer, nullptr);
+    wf::scene::add_front(wf::get_core().scene()->layers[(int)wf::scene::layer::TOP], node);
+    REQUIRE(wf::get_core().get_cursor_focus() == node);
+    pointer.motion_count = 0;
+
+    const auto before = wf::get_core().seat->get_pointer_motion_stats();
+    for (int i = 0; i < 10; i++)
+    {
+        const uint32_t previous_time = pointer.last_time;
+        harness.pointer_relative_motion(1, 0);
+        CHECK(pointer.motion_count == i + 1);
+        CHECK(pointer.last_time > previous_time);
+    }
+
+    CHECK(pointer.last_position.x == doctest::Approx(110));
+    REQUIRE(harness.run_until([&]
+    {
+        return wf::get_core().seat->get_pointer_motion_stats().position_updates > before.position_updates;
+    }));
+
+    const auto after = wf::get_core().seat->get_pointer_motion_stats();
+    CHECK(pointer.motion_count == 10);
+    CHECK(after.forwarded_events - before.forwarded_events == 10);
+    CHECK(after.position_updates - before.position_updates == 1);
+    wf::scene::remove_child(node);
+}
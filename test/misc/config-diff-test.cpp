@@ -0,0 +1,143 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <string>
+#include <wayfire/config-backend.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/config/file.hpp>
+#include <wayfire/config/types.hpp>
+
+namespace
+{
+class test_backend_t : public wf::config_backend_t
+{
+  public:
+    void init(wl_display*, wf::config::config_manager_t&, const std::string&) override
+    {}
+
+    using wf::config_backend_t::config_snapshot_t;
+    using wf::config_backend_t::take_config_snapshot;
+    using wf::config_backend_t::diff_config_snapshot;
+};
+
+void add_section(wf::config::config_manager_t& config, const std::string& name, int num_options)
+{
+    auto section = std::make_shared<wf::config::section_t>(name);
+    for (int i = 0; i < num_options; i++)
+    {
+        section->register_new_option(
+            std::make_shared<wf::config::option_t<int>>("option_" + std::to_string(i), 0));
+    }
+
+    config.merge_section(section);
+}
+
+std::string generate_config_text(int num_sections, int num_options, int changed_value)
+{
+    std::string text;
+    for (int s = 0; s < num_sections; s++)
+    {
+        text += "[section_" + std::to_string(s) + "]\n";
+        for (int i = 0; i < num_options; i++)
+        {
+            const int value = ((s == 0) && (i == 0)) ? changed_value : i;
+            text += "option_" + std::to_string(i) + " = " + std::to_string(value) + "\n";
+        }
+    }
+
+    return text;
+}
+}
+
+TEST_CASE("diff reports only the changed options and their sections")
+{
+    wf::config::config_manager_t config;
+    add_section(config, "a", 3);
+    add_section(config, "b", 3);
+    auto before = test_backend_t::take_config_snapshot(config);
+
+    wf::reload_config_signal ev;
+    CHECK_FALSE(test_backend_t::diff_config_snapshot(before, config, ev));
+    REQUIRE(ev.changed_sections.has_value());
+    CHECK(ev.changed_sections->empty());
+    CHECK_FALSE(ev.section_changed("a"));
+
+    auto option = config.get_option("b/option_1");
+    option->set_value_str("5");
+    CHECK(test_backend_t::diff_config_snapshot(before, config, ev));
+    CHECK(*ev.changed_sections == std::set<std::string>{"b"});
+    CHECK(ev.changed_options.size() == 1);
+    CHECK(ev.option_changed(option));
+    CHECK_FALSE(ev.option_changed(config.get_option("b/option_0")));
+    CHECK(ev.section_changed("b"));
+    CHECK_FALSE(ev.section_changed("a"));
+}
+
+TEST_CASE("diff reports added and removed sections")
+{
+    wf::config::config_manager_t config;
+    add_section(config, "input", 1);
+    add_section(config, "core", 1);
+    auto before = test_backend_t::take_config_snapshot(config);
+
+    add_section(config, "input-device:mouse", 1);
+    config.delete_section(config.get_section("core"));
+
+    wf::reload_config_signal ev;
+    CHECK(test_backend_t::diff_config_snapshot(before, config, ev));
+    CHECK(*ev.changed_sections == std::set<std::string>{"core", "input-device:mouse"});
+    CHECK_FALSE(ev.section_or_instances_changed("input"));
+    CHECK(ev.section_or_instances_changed("input-device"));
+}
+
+TEST_CASE("a reload signal without change information matches everything")
+{
+    wf::reload_config_signal ev;
+    CHECK(ev.section_changed("core"));
+    CHECK(ev.section_or_instances_changed("input"));
+    CHECK(ev.option_changed(nullptr));
+}
+
+TEST_CASE("benchmark: diff of a 5000 line configuration")
+{
+    constexpr int num_sections = 100;
+    constexpr int num_options  = 49;
+
+    wf::config::config_manager_t config;
+    for (int s = 0; s < num_sections; s++)
+    {
+        add_section(config, "section_" + std::to_string(s), num_options);
+    }
+
+    wf::config::load_configuration_options_from_string(config,
+        generate_config_text(num_sections, num_options, 0), "benchmark");
+
+    constexpr int iterations = 50;
+    std::chrono::steady_clock::duration parse_time{0}, diff_time{0};
+    for (int iter = 1; iter <= iterations; iter++)
+    {
+        const auto text = generate_config_text(num_sections, num_options, iter);
+
+        auto start  = std::chrono::steady_clock::now();
+        auto before = test_backend_t::take_config_snapshot(config);
+        auto parsed = std::chrono::steady_clock::now();
+        wf::config::load_configuration_options_from_string(config, text, "benchmark");
+        parse_time += std::chrono::steady_clock::now() - parsed;
+
+        auto diff_start = std::chrono::steady_clock::now();
+        wf::reload_config_signal ev;
+        CHECK(test_backend_t::diff_config_snapshot(before, config, ev));
+        diff_time += (parsed - start) + (std::chrono::steady_clock::now() - diff_start);
+
+        CHECK(ev.changed_options.size() == 1);
+        CHECK(*ev.changed_sections == std::set<std::string>{"section_0"});
+    }
+
+    const auto to_us = [] (auto duration)
+    {
+        return std::chrono::duration<double, std::micro>(duration).count() / iterations;
+    };
+    MESSAGE(num_sections * (num_options + 1) << " lines: " << to_us(parse_time) << " us to parse, " <<
+        to_us(diff_time) << " us to snapshot and diff");
+}
@@ -0,0 +1,87 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "view/frame-pacing.hpp"
+
+namespace
+{
+wf::frame_pacing_config_t default_config()
+{
+    wf::frame_pacing_config_t config;
+    config.occluded_fraction = 0.1;
+    config.occluded_rate     = 15;
+    config.background_rate   = 10;
+    config.thumbnail_rate    = 30;
+    return config;
+}
+}
+
+TEST_CASE("Fully visible surfaces are not limited")
+{
+    auto result = wf::compute_frame_pacing(default_config(), {});
+    CHECK(result.max_rate == 0);
+    CHECK(result.reason == "none");
+    CHECK(result.visible_fraction == 1.0);
+}
+
+TEST_CASE("Mostly occluded surfaces are limited")
+{
+    wf::frame_pacing_input_t input;
+    input.visible_fraction = 0.05;
+    auto result = wf::compute_frame_pacing(default_config(), input);
+    CHECK(result.max_rate == 15);
+    CHECK(result.reason == "occluded");
+
+    input.visible_fraction = 0.5;
+    CHECK(wf::compute_frame_pacing(default_config(), input).max_rate == 0);
+}
+
+TEST_CASE("Background and thumbnail states are limited")
+{
+    wf::frame_pacing_input_t input;
+    input.thumbnail = true;
+    auto result = wf::compute_frame_pacing(default_config(), input);
+    CHECK(result.max_rate == 30);
+    CHECK(result.reason == "thumbnail");
+
+    input.other_workspace = true;
+    result = wf::compute_frame_pacing(default_config(), input);
+    CHECK(result.max_rate == 10);
+    CHECK(result.reason == "other-workspace");
+
+    input = {};
+    input.minimized = true;
+    result = wf::compute_frame_pacing(default_config(), input);
+    CHECK(result.max_rate == 10);
+    CHECK(result.reason == "minimized");
+}
+
+TEST_CASE("The lowest applicable limit wins")
+{
+    wf::frame_pacing_input_t input;
+    input.thumbnail = true;
+    input.rule_rate = 5;
+    auto result = wf::compute_frame_pacing(default_config(), input);
+    CHECK(result.max_rate == 5);
+    CHECK(result.reason == "rule");
+
+    input.rule_rate = 60;
+    result = wf::compute_frame_pacing(default_config(), input);
+    CHECK(result.max_rate == 30);
+    CHECK(result.reason == "thumbnail");
+}
+
+TEST_CASE("Disabled limits do not apply")
+{
+    auto config = default_config();
+    config.background_rate = 0;
+
+    wf::frame_pacing_input_t input;
+    input.minimized = true;
+    CHECK(wf::compute_frame_pacing(config, input).max_rate == 0);
+
+    input.visible_fraction = 0.0;
+    auto result = wf::compute_frame_pacing(config, input);
+    CHECK(result.max_rate == 15);
+    CHECK(result.reason == "occluded");
+}
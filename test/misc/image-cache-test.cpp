@@ -0,0 +1,109 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <config.h>
+#include <wayfire/img.hpp>
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "../support/headless-core-harness.hpp"
+
+#ifdef BUILD_WITH_IMAGEIO
+namespace
+{
+void write_png(const std::string& path, int width, int height)
+{
+    std::vector<uint8_t> pixels(width * height * 4, 0x80);
+    image_io::write_to_file(path, pixels.data(), width, height, "png");
+}
+
+std::shared_ptr<image_io::image_future_t> decode(wf::test::headless_core_harness_t& harness,
+    const std::string& path)
+{
+    auto future = image_io::decode_file_async(path);
+    REQUIRE(harness.run_until([&] { return future->is_ready(); }));
+    return future;
+}
+}
+
+TEST_CASE("decoded images are cached by path and modification time")
+{
+    wf::test::headless_core_harness_t harness;
+    char dir_template[] = "/tmp/wf-image-cache-XXXXXX";
+    REQUIRE(mkdtemp(dir_template));
+    const std::string path = std::string(dir_template) + "/image.png";
+
+    write_png(path, 16, 8);
+    const auto before = image_io::get_cache_stats();
+    auto first = decode(harness, path);
+    REQUIRE(first->get());
+    CHECK(first->get()->width == 16);
+    CHECK(first->get()->height == 8);
+    CHECK(first->get()->channels == 4);
+    CHECK(image_io::get_cache_stats().misses == before.misses + 1);
+
+    /* Loading the unchanged file again shares the decoded image */
+    auto second = image_io::decode_file_async(path);
+    CHECK(second == first);
+    CHECK(second->is_ready());
+    CHECK(image_io::get_cache_stats().hits == before.hits + 1);
+
+    /* A modified file is decoded again */
+    write_png(path, 32, 8);
+    timespec times[2] = {{.tv_sec = 0, .tv_nsec = UTIME_OMIT}, {.tv_sec = 1, .tv_nsec = 0}};
+    REQUIRE(utimensat(AT_FDCWD, path.c_str(), times, 0) == 0);
+    auto third = decode(harness, path);
+    REQUIRE(third->get());
+    CHECK(third->get()->width == 32);
+    CHECK(image_io::get_cache_stats().misses == before.misses + 2);
+
+    /* Missing files fail immediately, callbacks still run */
+    bool called = false;
+    auto missing = image_io::decode_file_async(std::string(dir_template) + "/missing.png");
+    missing->then([&] { called = true; });
+    CHECK(called);
+    CHECK(missing->get() == nullptr);
+
+    unlink(path.c_str());
+    rmdir(dir_template);
+}
+
+TEST_CASE("decoded images are evicted once nothing references them")
+{
+    wf::test::headless_core_harness_t harness;
+    char dir_template[] = "/tmp/wf-image-cache-XXXXXX";
+    REQUIRE(mkdtemp(dir_template));
+    const std::string path = std::string(dir_template) + "/image.png";
+    write_png(path, 16, 8);
+
+    const auto before = image_io::get_cache_stats();
+    auto future = decode(harness, path);
+    auto image  = future->get();
+    REQUIRE(image);
+    CHECK(image_io::get_cache_stats().cached_bytes == before.cached_bytes + 16 * 8 * 4);
+
+    /* The decoded image alone keeps the entry alive */
+    future.reset();
+    auto again = image_io::decode_file_async(path);
+    CHECK(again->is_ready());
+    CHECK(again->get() == image);
+    CHECK(image_io::get_cache_stats().hits == before.hits + 1);
+
+    again.reset();
+    image.reset();
+    CHECK(image_io::get_cache_stats().cached_bytes == before.cached_bytes);
+    CHECK(image_io::get_cache_stats().evictions == before.evictions + 1);
+
+    decode(harness, path);
+    CHECK(image_io::get_cache_stats().misses == before.misses + 2);
+
+    unlink(path.c_str());
+    rmdir(dir_template);
+}
+
+#endif
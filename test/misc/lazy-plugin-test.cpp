@@ -0,0 +1,91 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/bindings-repository.hpp>
+#include <wayfire/core.hpp>
+#include <wayfire/nonstd/json.hpp>
+#include <wayfire/plugin.hpp>
+#include <wayfire/signal-definitions.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unistd.h>
+
+#include <linux/input-event-codes.h>
+
+#include "../support/headless-core-harness.hpp"
+#include "../support/ipc-client.hpp"
+#include "../support/scoped-env.hpp"
+
+namespace
+{
+std::optional<wf::plugin_load_stats_t> find_stats(const std::string& name)
+{
+    auto stats = wf::get_plugin_load_stats();
+    auto it    = std::find_if(stats.begin(), stats.end(), [&] (auto& entry) { return entry.name == name; });
+    if (it == stats.end())
+    {
+        return {};
+    }
+
+    return *it;
+}
+}
+
+TEST_CASE("lazy plugins are initialized by their first binding or IPC method")
+{
+    const auto ipc_path = (std::filesystem::temp_directory_path() /
+        ("wayfire-lazy-plugin-test-" + std::to_string(getpid()) + ".socket")).string();
+    unlink(ipc_path.c_str());
+
+    wf::test::scoped_env_t plugin_path{"WAYFIRE_PLUGIN_PATH", TEST_PLUGIN_PATH};
+    wf::test::scoped_env_t ipc_socket{"_WAYFIRE_SOCKET", ipc_path};
+    wf::test::headless_core_harness_t harness{
+        "[core]\n"
+        "plugins = ipc idle alpha\n"
+        "lazy_plugins = idle alpha\n"
+        "\n"
+        "[idle]\n"
+        "toggle = <super> KEY_I\n",
+        true};
+    REQUIRE(harness.run_until([&] { return std::filesystem::exists(ipc_path); }));
+    wf::test::ipc_client_t ipc{ipc_path};
+
+    for (auto name : {"idle", "alpha"})
+    {
+        auto stats = find_stats(name);
+        REQUIRE(stats);
+        CHECK(stats->lazy);
+        CHECK_FALSE(stats->initialized);
+        CHECK(stats->init_time_us == 0);
+        CHECK(stats->load_time_us > 0);
+    }
+
+    /* The placeholder binding initializes idle, which then handles the same key press */
+    std::optional<bool> inhibited;
+    wf::signal::connection_t<wf::idle_inhibit_changed_signal> on_inhibit_changed =
+        [&] (wf::idle_inhibit_changed_signal *ev)
+    {
+        inhibited = ev->inhibit;
+    };
+    wf::get_core().connect(&on_inhibit_changed);
+
+    CHECK(wf::get_core().bindings->handle_key({WLR_MODIFIER_LOGO, KEY_I}, 0));
+    CHECK(find_stats("idle")->initialized);
+    CHECK(inhibited == true);
+
+    /* The method is in the wf/alpha/ namespace, and is handled by alpha once it is initialized. Without a
+     * view id, the handler itself reports the error. */
+    auto response = wf::test::call_method(harness, ipc, "wf/alpha/get-view-alpha");
+    CHECK(find_stats("alpha")->initialized);
+    REQUIRE(response.has_member("error"));
+    CHECK_FALSE(response.has_member("method"));
+    CHECK(response["error"].as_string().find("Missing view id") != std::string::npos);
+
+    /* Only the plugin's own binding is left, so the key press is handled once */
+    inhibited.reset();
+    CHECK(wf::get_core().bindings->handle_key({WLR_MODIFIER_LOGO, KEY_I}, 0));
+    CHECK(inhibited == false);
+}
@@ -0,0 +1,100 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/task-pool.hpp>
+#include <wayland-server-core.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct event_loop_t
+{
+    wl_event_loop *loop = wl_event_loop_create();
+    ~event_loop_t()
+    {
+        wl_event_loop_destroy(loop);
+    }
+};
+}
+
+TEST_CASE("parallel_for visits every element exactly once")
+{
+    event_loop_t ev;
+    wf::task_pool_t pool{ev.loop, 3};
+    REQUIRE(pool.get_num_workers() == 3);
+
+    std::vector<int> visits(10007, 0);
+    pool.parallel_for(0, visits.size(), 16, [&] (size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            visits[i]++;
+        }
+    });
+
+    for (auto v : visits)
+    {
+        REQUIRE(v == 1);
+    }
+}
+
+TEST_CASE("parallel_for runs inline from worker threads and without workers")
+{
+    event_loop_t ev;
+    wf::task_pool_t inline_pool{ev.loop, 0};
+    CHECK(inline_pool.get_num_workers() == 0);
+
+    int calls = 0;
+    inline_pool.parallel_for(0, 1000, 1, [&] (size_t begin, size_t end)
+    {
+        CHECK(begin == 0);
+        CHECK(end == 1000);
+        ++calls;
+    });
+    CHECK(calls == 1);
+
+    wf::task_pool_t pool{ev.loop, 2};
+    std::atomic<int> nested_calls{0};
+    std::atomic<bool> done{false};
+    pool.submit([&]
+    {
+        CHECK(wf::task_pool_t::is_worker_thread());
+        pool.parallel_for(0, 100, 1, [&] (size_t, size_t) { ++nested_calls; });
+    }, [&] { done = true; });
+
+    while (!done)
+    {
+        wl_event_loop_dispatch(ev.loop, 100);
+    }
+
+    CHECK(nested_calls == 1);
+    CHECK(!wf::task_pool_t::is_worker_thread());
+}
+
+TEST_CASE("completion callbacks run on the main thread")
+{
+    event_loop_t ev;
+    wf::task_pool_t pool{ev.loop, 2};
+
+    const auto main_thread = std::this_thread::get_id();
+    std::atomic<int> jobs_run{0};
+    int callbacks_run = 0;
+    for (int i = 0; i < 32; i++)
+    {
+        pool.submit([&] { ++jobs_run; }, [&]
+        {
+            CHECK(std::this_thread::get_id() == main_thread);
+            ++callbacks_run;
+        });
+    }
+
+    while (callbacks_run < 32)
+    {
+        wl_event_loop_dispatch(ev.loop, 100);
+    }
+
+    CHECK(jobs_run == 32);
+}
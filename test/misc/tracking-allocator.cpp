@@ -2,6 +2,9 @@
 #include "wayfire/signal-provider.hpp"
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest/doctest.h>
+#include <chrono>
+#include <memory>
+#include <vector>
 
 class base_t : public wf::signal::provider_t
 {
@@ -55,3 +58,67 @@ TEST_CASE("Misc factory works")
     REQUIRE(destruct_events == 1);
     REQUIRE(allocator.get_all().size() == 1);
 }
+
+TEST_CASE("Objects are listed in allocation order after others are freed")
+{
+    auto& allocator = wf::tracking_allocator_t<base_t>::get();
+    const size_t initial = allocator.get_all().size();
+
+    std::vector<std::shared_ptr<base_t>> objects;
+    for (int i = 0; i < 10; i++)
+    {
+        objects.push_back(allocator.allocate<base_t>());
+    }
+
+    objects[1].reset();
+    objects[4].reset();
+    objects[5].reset();
+    objects[9].reset();
+
+    std::vector<base_t*> expected;
+    for (auto& obj : objects)
+    {
+        if (obj)
+        {
+            expected.push_back(obj.get());
+        }
+    }
+
+    auto& all = allocator.get_all();
+    REQUIRE(all.size() == initial + expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        CHECK(all[initial + i].get() == expected[i]);
+    }
+}
+
+TEST_CASE("benchmark: short-lived objects next to thousands of live ones")
+{
+    auto& allocator = wf::tracking_allocator_t<base_t>::get();
+    const size_t initial = allocator.get_all().size();
+    std::vector<std::shared_ptr<base_t>> live;
+    for (int i = 0; i < 5000; i++)
+    {
+        live.push_back(allocator.allocate<base_t>());
+    }
+
+    /* Popups and tooltips: created and destroyed in bursts, with the list queried once per burst */
+    constexpr int bursts = 200;
+    constexpr int burst_size = 100;
+    auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < bursts; b++)
+    {
+        std::vector<std::shared_ptr<base_t>> burst;
+        for (int i = 0; i < burst_size; i++)
+        {
+            burst.push_back(allocator.allocate<base_t>());
+        }
+
+        burst.clear();
+        REQUIRE(allocator.get_all().size() == initial + live.size());
+    }
+
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    MESSAGE("5000 live objects: " << elapsed.count() / (bursts * burst_size) <<
+        " ns per short-lived allocation and deallocation");
+}
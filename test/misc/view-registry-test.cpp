@@ -0,0 +1,117 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/compositor-view.hpp>
+#include <wayfire/core.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/view-registry.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "../support/headless-core-harness.hpp"
+
+namespace
+{
+bool contains(const std::vector<wayfire_view>& views, const std::shared_ptr<wf::color_rect_view_t>& view)
+{
+    return std::find(views.begin(), views.end(), wayfire_view{view.get()}) != views.end();
+}
+}
+
+TEST_CASE("the view registry indexes views by id, role and output")
+{
+    wf::test::headless_core_harness_t harness;
+    auto output = harness.output();
+    auto& registry = wf::view_registry_t::get();
+
+    auto tooltip = wf::color_rect_view_t::create(wf::VIEW_ROLE_UNMANAGED, output, wf::scene::layer::TOP);
+    auto panel   = wf::color_rect_view_t::create(wf::VIEW_ROLE_DESKTOP_ENVIRONMENT, output,
+        wf::scene::layer::BACKGROUND);
+
+    CHECK(registry.find_by_id(tooltip->get_id()) == wayfire_view{tooltip.get()});
+    CHECK(contains(registry.with_role(wf::VIEW_ROLE_UNMANAGED), tooltip));
+    CHECK_FALSE(contains(registry.with_role(wf::VIEW_ROLE_UNMANAGED), panel));
+    CHECK(contains(registry.with_role(wf::VIEW_ROLE_DESKTOP_ENVIRONMENT), panel));
+    CHECK(contains(registry.on_output(output), tooltip));
+    CHECK(contains(registry.on_output(output), panel));
+    CHECK(contains(registry.with_app_id(tooltip->get_app_id()), tooltip));
+
+    tooltip->set_role(wf::VIEW_ROLE_DESKTOP_ENVIRONMENT);
+    CHECK_FALSE(contains(registry.with_role(wf::VIEW_ROLE_UNMANAGED), tooltip));
+    CHECK(contains(registry.with_role(wf::VIEW_ROLE_DESKTOP_ENVIRONMENT), tooltip));
+
+    tooltip->set_output(nullptr);
+    CHECK_FALSE(contains(registry.on_output(output), tooltip));
+    CHECK(contains(registry.on_output(nullptr), tooltip));
+
+    const auto panel_id = panel->get_id();
+    panel->close();
+    panel.reset();
+    CHECK(registry.find_by_id(panel_id) == nullptr);
+    CHECK(registry.on_output(output).empty());
+
+    tooltip->close();
+}
+
+TEST_CASE("benchmark: tooltip storm with 1000 live views")
+{
+    wf::test::headless_core_harness_t harness;
+    auto output = harness.output();
+    auto& registry = wf::view_registry_t::get();
+
+    std::vector<std::shared_ptr<wf::color_rect_view_t>> live;
+    for (int i = 0; i < 1000; i++)
+    {
+        live.push_back(wf::color_rect_view_t::create(wf::VIEW_ROLE_TOPLEVEL, output));
+    }
+
+    constexpr int tooltips = 5000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < tooltips; i++)
+    {
+        auto tooltip = wf::color_rect_view_t::create(wf::VIEW_ROLE_UNMANAGED, output, wf::scene::layer::TOP);
+        tooltip->close();
+    }
+
+    auto churn = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    CHECK(registry.with_role(wf::VIEW_ROLE_UNMANAGED).empty());
+
+    constexpr int lookups = 1000;
+    size_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; i++)
+    {
+        found += (registry.find_by_id(live[(i * 7) % live.size()]->get_id()) != nullptr);
+    }
+
+    auto indexed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; i++)
+    {
+        const auto id = live[(i * 7) % live.size()]->get_id();
+        for (auto& view : wf::get_core().get_all_views())
+        {
+            if (view->get_id() == id)
+            {
+                found++;
+                break;
+            }
+        }
+    }
+
+    auto scanned = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    CHECK(found == 2 * lookups);
+
+    MESSAGE("1000 live views: " << churn.count() / tooltips << " us per short-lived view, find by id " <<
+        indexed.count() / lookups << " us indexed vs " << scanned.count() / lookups <<
+        " us scanning a copy of all views");
+
+    for (auto& view : live)
+    {
+        view->close();
+    }
+}
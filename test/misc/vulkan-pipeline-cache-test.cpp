@@ -0,0 +1,305 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/vulkan.hpp>
+#include <wayfire/task-pool.hpp>
+#include <wayland-server-core.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "shaders/core-basic.vert.h"
+#include "shaders/core-basic.frag.h"
+
+namespace
+{
+/** A Vulkan device on a CPU implementation, i.e. lavapipe. */
+struct software_device_t
+{
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physical_device = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue   = VK_NULL_HANDLE;
+
+    ~software_device_t()
+    {
+        if (device)
+        {
+            vkDestroyDevice(device, nullptr);
+        }
+
+        if (instance)
+        {
+            vkDestroyInstance(instance, nullptr);
+        }
+    }
+};
+
+bool create_software_device(software_device_t& dev)
+{
+    VkApplicationInfo app_info{};
+    app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    app_info.apiVersion = VK_API_VERSION_1_1;
+
+    VkInstanceCreateInfo instance_info{};
+    instance_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    instance_info.pApplicationInfo = &app_info;
+    if (vkCreateInstance(&instance_info, nullptr, &dev.instance) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    uint32_t count = 0;
+    vkEnumeratePhysicalDevices(dev.instance, &count, nullptr);
+    std::vector<VkPhysicalDevice> devices(count);
+    vkEnumeratePhysicalDevices(dev.instance, &count, devices.data());
+    for (auto candidate : devices)
+    {
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(candidate, &props);
+        if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU)
+        {
+            dev.physical_device = candidate;
+            break;
+        }
+    }
+
+    if (!dev.physical_device)
+    {
+        return false;
+    }
+
+    uint32_t num_families = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(dev.physical_device, &num_families, nullptr);
+    std::vector<VkQueueFamilyProperties> families(num_families);
+    vkGetPhysicalDeviceQueueFamilyProperties(dev.physical_device, &num_families, families.data());
+    std::optional<uint32_t> graphics_family;
+    for (uint32_t i = 0; i < num_families; i++)
+    {
+        if (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        {
+            graphics_family = i;
+            break;
+        }
+    }
+
+    if (!graphics_family)
+    {
+        return false;
+    }
+
+    const float priority = 1.0f;
+    VkDeviceQueueCreateInfo queue_info{};
+    queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queue_info.queueFamilyIndex = *graphics_family;
+    queue_info.queueCount = 1;
+    queue_info.pQueuePriorities = &priority;
+
+    VkDeviceCreateInfo device_info{};
+    device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    device_info.queueCreateInfoCount = 1;
+    device_info.pQueueCreateInfos    = &queue_info;
+    if (vkCreateDevice(dev.physical_device, &device_info, nullptr, &dev.device) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    vkGetDeviceQueue(dev.device, *graphics_family, 0, &dev.queue);
+    return true;
+}
+
+VkRenderPass create_render_pass(VkDevice device)
+{
+    VkAttachmentDescription attachment{};
+    attachment.format  = VK_FORMAT_B8G8R8A8_UNORM;
+    attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    attachment.loadOp  = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachment.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.initialLayout  = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    attachment.finalLayout    = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference color_ref{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint    = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments    = &color_ref;
+
+    VkRenderPassCreateInfo pass_info{};
+    pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    pass_info.attachmentCount = 1;
+    pass_info.pAttachments    = &attachment;
+    pass_info.subpassCount    = 1;
+    pass_info.pSubpasses = &subpass;
+
+    VkRenderPass pass = VK_NULL_HANDLE;
+    vkCreateRenderPass(device, &pass_info, nullptr, &pass);
+    return pass;
+}
+
+VkDescriptorSetLayout create_texture_layout(VkDevice device)
+{
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.bindingCount = 1;
+    layout_info.pBindings    = &binding;
+
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    vkCreateDescriptorSetLayout(device, &layout_info, nullptr, &layout);
+    return layout;
+}
+
+wf::vk::pipeline_params_t core_pipeline_params(const std::shared_ptr<wf::vk::context_t>& context,
+    VkDescriptorSetLayout texture_layout)
+{
+    wf::vk::pipeline_params_t params{};
+    params.shaders = {
+        {.stage = VK_SHADER_STAGE_VERTEX_BIT,
+            .shader = context->load_shader_module(core_basic_vert_data, sizeof(core_basic_vert_data))},
+        {.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .shader = context->load_shader_module(core_basic_frag_data, sizeof(core_basic_frag_data))},
+    };
+    params.descriptor_set_layouts = {texture_layout};
+    params.push_constants = {
+        VkPushConstantRange{
+            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+            .offset     = 0,
+            .size = sizeof(glm::mat4) + 2 * sizeof(glm::vec2),
+        },
+    };
+
+    return params;
+}
+
+/**
+ * Create the pipelines for all texture transfer functions and rotations which the core shaders support,
+ * as the first frames after startup would, and return how long it took.
+ */
+std::chrono::microseconds create_core_pipelines(std::shared_ptr<wf::vk::context_t> context,
+    VkRenderPass pass, VkDescriptorSetLayout texture_layout)
+{
+    wf::vk::graphics_pipeline_t pipeline{context, core_pipeline_params(context, texture_layout)};
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& specialization : wf::vk::pipeline_specialization_t::get_common_texture_specializations())
+    {
+        auto [layout, vk_pipeline] = pipeline.pipeline_for_render_pass(pass, specialization);
+        REQUIRE(layout != VK_NULL_HANDLE);
+        REQUIRE(vk_pipeline != VK_NULL_HANDLE);
+    }
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+}
+
+TEST_CASE("the pipeline cache is persisted and reused by the next context")
+{
+    software_device_t dev;
+    if (!create_software_device(dev))
+    {
+        MESSAGE("No software Vulkan implementation (lavapipe) available, skipping");
+        return;
+    }
+
+    auto cache_home = std::filesystem::temp_directory_path() / "wayfire-vk-cache-XXXXXX";
+    std::string cache_home_str = cache_home.string();
+    REQUIRE(mkdtemp(cache_home_str.data()));
+    setenv("XDG_CACHE_HOME", cache_home_str.c_str(), 1);
+
+    VkRenderPass pass = create_render_pass(dev.device);
+    VkDescriptorSetLayout texture_layout = create_texture_layout(dev.device);
+    REQUIRE(pass != VK_NULL_HANDLE);
+    REQUIRE(texture_layout != VK_NULL_HANDLE);
+
+    std::chrono::microseconds cold, warm;
+    {
+        auto context = std::make_shared<wf::vk::context_t>(dev.physical_device, dev.device, dev.queue);
+        CHECK(context->get_pipeline_cache() != VK_NULL_HANDLE);
+        CHECK(context->get_loaded_pipeline_cache_size() == 0);
+        cold = create_core_pipelines(context, pass, texture_layout);
+    }
+
+    const auto cache_dir = std::filesystem::path(cache_home_str) / "wayfire";
+    REQUIRE(std::filesystem::exists(cache_dir));
+    REQUIRE_FALSE(std::filesystem::is_empty(cache_dir));
+
+    {
+        auto context = std::make_shared<wf::vk::context_t>(dev.physical_device, dev.device, dev.queue);
+        CHECK(context->get_loaded_pipeline_cache_size() > 0);
+        warm = create_core_pipelines(context, pass, texture_layout);
+    }
+
+    MESSAGE("first-frame pipeline creation: " << cold.count() << " us without cache, " <<
+        warm.count() << " us with the persisted cache");
+
+    vkDestroyDescriptorSetLayout(dev.device, texture_layout, nullptr);
+    vkDestroyRenderPass(dev.device, pass, nullptr);
+    std::filesystem::remove_all(cache_home_str);
+}
+
+TEST_CASE("expected specializations are compiled on worker threads")
+{
+    software_device_t dev;
+    if (!create_software_device(dev))
+    {
+        MESSAGE("No software Vulkan implementation (lavapipe) available, skipping");
+        return;
+    }
+
+    auto cache_home = std::filesystem::temp_directory_path() / "wayfire-vk-cache-XXXXXX";
+    std::string cache_home_str = cache_home.string();
+    REQUIRE(mkdtemp(cache_home_str.data()));
+    setenv("XDG_CACHE_HOME", cache_home_str.c_str(), 1);
+
+    VkRenderPass pass = create_render_pass(dev.device);
+    VkDescriptorSetLayout texture_layout = create_texture_layout(dev.device);
+    REQUIRE(pass != VK_NULL_HANDLE);
+    REQUIRE(texture_layout != VK_NULL_HANDLE);
+
+    wl_event_loop *loop = wl_event_loop_create();
+    {
+        wf::task_pool_t pool{loop, 2};
+        auto context = std::make_shared<wf::vk::context_t>(dev.physical_device, dev.device, dev.queue);
+        wf::vk::graphics_pipeline_t pipeline{context, core_pipeline_params(context, texture_layout)};
+
+        const auto specializations = wf::vk::pipeline_specialization_t::get_common_texture_specializations();
+        CHECK(specializations.size() == 3 * 8);
+        for (const auto& specialization : specializations)
+        {
+            pipeline.add_expected_specialization(specialization);
+        }
+
+        pipeline.warm_up_render_pass(pass, pool);
+
+        // Pipelines still being compiled are waited for, and each specialization is only compiled once.
+        for (const auto& specialization : specializations)
+        {
+            auto first = pipeline.pipeline_for_render_pass(pass, specialization);
+            REQUIRE(first.second != VK_NULL_HANDLE);
+            CHECK(pipeline.pipeline_for_render_pass(pass, specialization) == first);
+        }
+
+        // Destroying a pipeline waits for the compilation jobs which use its shader modules.
+        wf::vk::graphics_pipeline_t discarded{context, core_pipeline_params(context, texture_layout)};
+        for (const auto& specialization : specializations)
+        {
+            discarded.add_expected_specialization(specialization);
+        }
+
+        discarded.warm_up_render_pass(pass, pool);
+    }
+
+    wl_event_loop_destroy(loop);
+    vkDestroyDescriptorSetLayout(dev.device, texture_layout, nullptr);
+    vkDestroyRenderPass(dev.device, pass, nullptr);
+    std::filesystem::remove_all(cache_home_str);
+}
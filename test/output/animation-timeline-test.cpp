@@ -0,0 +1,102 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/frame-animation.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include "../support/headless-core-harness.hpp"
+
+TEST_CASE("animations are stepped with monotonic presentation times until they finish")
+{
+    wf::test::headless_core_harness_t harness;
+    auto render = harness.output()->render.get();
+
+    std::vector<int64_t> times;
+    int64_t time_in_hook = 0;
+    wf::animation_hook_t animation = [&] (int64_t presentation_ns)
+    {
+        times.push_back(presentation_ns);
+        time_in_hook = render->get_frame_presentation_time_ns();
+        return times.size() < 5;
+    };
+
+    render->add_animation(&animation);
+    REQUIRE(harness.run_until([&] { return times.size() >= 5; }));
+    CHECK(time_in_hook == times.back());
+    for (size_t i = 1; i < times.size(); i++)
+    {
+        CHECK(times[i] >= times[i - 1]);
+    }
+
+    // The animation removed itself by returning false, so it is not stepped again even if the output repaints.
+    render->damage_whole();
+    harness.run_until([] { return false; }, 10);
+    CHECK(times.size() == 5);
+}
+
+TEST_CASE("removed animations are no longer stepped")
+{
+    wf::test::headless_core_harness_t harness;
+    auto render = harness.output()->render.get();
+
+    int steps = 0;
+    wf::animation_hook_t animation = [&] (int64_t)
+    {
+        ++steps;
+        return true;
+    };
+
+    render->add_animation(&animation);
+    REQUIRE(harness.run_until([&] { return steps > 0; }));
+    render->rem_animation(&animation);
+
+    const int steps_before = steps;
+    render->damage_whole();
+    harness.run_until([] { return false; }, 10);
+    CHECK(steps == steps_before);
+}
+
+TEST_CASE("frame animations are sampled at the presentation time of the frame")
+{
+    wf::test::headless_core_harness_t harness;
+    auto render = harness.output()->render.get();
+
+    const int64_t length_ns = 100'000'000;
+    wf::animation::simple_frame_animation_t progression{
+        wf::create_option(wf::animation_description_t{100, wf::animation::smoothing::linear, "linear"})};
+
+    std::vector<int64_t> times;
+    std::vector<double> values;
+    bool finished = false;
+    wf::animation_hook_t animation = [&] (int64_t presentation_ns)
+    {
+        if (times.empty())
+        {
+            progression.animate(0, 1);
+        }
+
+        CHECK(wf::animation::get_frame_time_ns() == presentation_ns);
+        times.push_back(presentation_ns);
+        values.push_back(progression);
+        finished = !progression.running();
+        return !finished;
+    };
+
+    render->add_animation(&animation);
+    REQUIRE(harness.run_until([&] { return finished; }));
+    REQUIRE(times.size() > 1);
+
+    for (size_t i = 0; i < times.size(); i++)
+    {
+        const double expected = std::clamp((double)(times[i] - times.front()) / length_ns, 0.0, 1.0);
+        CHECK(values[i] == doctest::Approx(expected));
+        CHECK(progression.progress_at(times[i]) == doctest::Approx(expected));
+    }
+
+    CHECK(values.back() == doctest::Approx(1.0));
+}
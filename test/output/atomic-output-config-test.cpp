@@ -0,0 +1,168 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <wayfire/core.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/output-layout.hpp>
+#include <wayfire/seat.hpp>
+#include <wayfire/util.hpp>
+#include <wayfire/nonstd/wlroots-full.hpp>
+
+#include "../support/headless-core-harness.hpp"
+
+namespace
+{
+/** Counts the commits of each watched output, and the layout-wide signals. */
+struct output_events_t
+{
+    std::map<wlr_output*, int> commits;
+    int layout_changes = 0;
+    int added   = 0;
+    int removed = 0;
+
+    std::vector<std::unique_ptr<wf::wl_listener_wrapper>> on_commit;
+    wf::signal::connection_t<wf::output_layout_configuration_changed_signal> on_layout_changed = [=] (auto)
+    {
+        layout_changes++;
+    };
+    wf::signal::connection_t<wf::output_added_signal> on_added = [=] (auto) { added++; };
+    wf::signal::connection_t<wf::output_removed_signal> on_removed = [=] (auto) { removed++; };
+
+    output_events_t(const std::vector<wlr_output*>& outputs)
+    {
+        for (auto handle : outputs)
+        {
+            commits[handle] = 0;
+            auto listener = std::make_unique<wf::wl_listener_wrapper>();
+            listener->set_callback([this, handle] (void*) { commits[handle]++; });
+            listener->connect(&handle->events.commit);
+            on_commit.push_back(std::move(listener));
+        }
+
+        wf::get_core().output_layout->connect(&on_layout_changed);
+        wf::get_core().output_layout->connect(&on_added);
+        wf::get_core().output_layout->connect(&on_removed);
+    }
+};
+
+wlr_output *add_headless_output(wf::test::headless_core_harness_t& harness)
+{
+    wlr_output *handle = wlr_headless_add_output(wf::get_core().backend, 1280, 720);
+    REQUIRE(handle);
+    harness.roundtrip();
+    return handle;
+}
+
+void set_enabled(wf::output_configuration_t& config, wlr_output *handle, int x, int width, int height)
+{
+    auto& state = config[handle];
+    state.source   = wf::OUTPUT_IMAGE_SOURCE_SELF;
+    state.position = wf::output_config::position_t{x, 0};
+    state.mode     = {.width = width, .height = height, .refresh = 60000};
+    state.uses_custom_mode = true;
+}
+
+void set_disabled(wf::output_configuration_t& config, wlr_output *handle)
+{
+    config[handle].source = wf::OUTPUT_IMAGE_SOURCE_NONE;
+}
+}
+
+TEST_CASE("docking several outputs commits each of them once")
+{
+    wf::test::headless_core_harness_t harness;
+    wlr_output *builtin = harness.output()->handle;
+    wlr_output *left    = add_headless_output(harness);
+    wlr_output *right   = add_headless_output(harness);
+
+    auto config = wf::get_core().output_layout->get_current_configuration();
+    set_disabled(config, left);
+    set_disabled(config, right);
+    REQUIRE(wf::get_core().output_layout->apply_configuration(config));
+    REQUIRE(wf::get_core().output_layout->find_output(left) == nullptr);
+
+    output_events_t events{{builtin, left, right}};
+    set_enabled(config, left, 1280, 1920, 1080);
+    set_enabled(config, right, 3200, 2560, 1440);
+    REQUIRE(wf::get_core().output_layout->apply_configuration(config));
+
+    CHECK(events.commits[left] == 1);
+    CHECK(events.commits[right] == 1);
+    CHECK(events.commits[builtin] == 0);
+    CHECK(events.layout_changes == 1);
+    CHECK(events.added == 2);
+
+    auto wo = wf::get_core().output_layout->find_output(right);
+    REQUIRE(wo);
+    CHECK(wo->get_layout_geometry() == wf::geometry_t{3200, 0, 2560, 1440});
+    CHECK(right->width == 2560);
+}
+
+TEST_CASE("undocking moves the focus to a remaining output once")
+{
+    wf::test::headless_core_harness_t harness;
+    wlr_output *builtin = harness.output()->handle;
+    wlr_output *left    = add_headless_output(harness);
+    wlr_output *right   = add_headless_output(harness);
+
+    wf::get_core().seat->focus_output(wf::get_core().output_layout->find_output(right));
+
+    output_events_t events{{builtin, left, right}};
+    auto config = wf::get_core().output_layout->get_current_configuration();
+    set_disabled(config, left);
+    set_disabled(config, right);
+    REQUIRE(wf::get_core().output_layout->apply_configuration(config));
+
+    CHECK(events.commits[left] == 1);
+    CHECK(events.commits[right] == 1);
+    CHECK(events.commits[builtin] == 0);
+    CHECK(events.layout_changes == 1);
+    CHECK(events.removed == 2);
+    CHECK_FALSE(left->enabled);
+    CHECK_FALSE(right->enabled);
+    CHECK(wf::get_core().seat->get_active_output() == harness.output());
+    CHECK(wf::get_core().output_layout->get_outputs().size() == 1);
+}
+
+TEST_CASE("moving outputs does not commit them")
+{
+    wf::test::headless_core_harness_t harness;
+    wlr_output *builtin = harness.output()->handle;
+    wlr_output *other   = add_headless_output(harness);
+
+    output_events_t events{{builtin, other}};
+    auto config = wf::get_core().output_layout->get_current_configuration();
+    config[builtin].position = wf::output_config::position_t{1280, 0};
+    config[other].position   = wf::output_config::position_t{0, 0};
+    REQUIRE(wf::get_core().output_layout->apply_configuration(config));
+
+    CHECK(events.commits[builtin] == 0);
+    CHECK(events.commits[other] == 0);
+    CHECK(events.layout_changes == 1);
+    CHECK(harness.output()->get_layout_geometry().x == 1280);
+}
+
+TEST_CASE("changing the scale does not attach a new frame")
+{
+    wf::test::headless_core_harness_t harness;
+    wlr_output *builtin = harness.output()->handle;
+
+    bool attached_buffer = false;
+    wf::wl_listener_wrapper on_commit;
+    on_commit.set_callback([&] (void *data)
+    {
+        auto ev = static_cast<wlr_output_event_commit*>(data);
+        attached_buffer |= (ev->state->committed & WLR_OUTPUT_STATE_BUFFER) != 0;
+    });
+    on_commit.connect(&builtin->events.commit);
+
+    auto config = wf::get_core().output_layout->get_current_configuration();
+    config[builtin].scale = 2;
+    REQUIRE(wf::get_core().output_layout->apply_configuration(config));
+
+    CHECK(builtin->scale == 2);
+    CHECK_FALSE(attached_buffer);
+}
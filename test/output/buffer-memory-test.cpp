@@ -0,0 +1,88 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/render.hpp>
+
+#include <algorithm>
+#include <string>
+
+#include "../support/headless-core-harness.hpp"
+
+namespace
+{
+const wf::buffer_memory_owner_stats_t *find_owner(const wf::buffer_memory_stats_t& stats,
+    const std::string& owner)
+{
+    auto it = std::find_if(stats.owners.begin(), stats.owners.end(),
+        [&] (const auto& entry) { return entry.owner == owner; });
+    return (it == stats.owners.end()) ? nullptr : &(*it);
+}
+}
+
+TEST_CASE("Auxilliary buffers are accounted per owner and signal memory pressure")
+{
+    // Static option wrappers cache the option of the first core, so use a single harness per process.
+    wf::test::headless_core_harness_t harness{
+        "[workarounds]\n"
+        "aux_buffer_budget = 1\n"
+        "aux_buffer_pool_size = 0\n"};
+
+    const auto initial = wf::get_buffer_memory_stats();
+    CHECK(initial.budget_bytes == 1024 * 1024);
+
+    int pressure_events = 0;
+    wf::signal::connection_t<wf::buffer_memory_pressure_signal> on_pressure =
+        [&] (wf::buffer_memory_pressure_signal *ev)
+    {
+        CHECK(ev->used_bytes > ev->budget_bytes);
+        ++pressure_events;
+    };
+    wf::get_core().connect(&on_pressure);
+
+    {
+        wf::auxilliary_buffer_t first;
+        wf::auxilliary_buffer_t second;
+        first.set_owner("test-first");
+        REQUIRE(first.allocate({100, 100}) == wf::buffer_reallocation_result_t::REALLOCATED);
+        REQUIRE(second.allocate({50, 20}) == wf::buffer_reallocation_result_t::REALLOCATED);
+
+        auto stats = wf::get_buffer_memory_stats();
+        CHECK(stats.total_buffers == initial.total_buffers + 2);
+        REQUIRE(find_owner(stats, "test-first"));
+        CHECK(find_owner(stats, "test-first")->bytes == 100 * 100 * 4);
+        REQUIRE(find_owner(stats, "unknown"));
+
+        // Changing the owner moves the accounted memory.
+        second.set_owner("test-second");
+        stats = wf::get_buffer_memory_stats();
+        auto initial_unknown = find_owner(initial, "unknown");
+        auto current_unknown = find_owner(stats, "unknown");
+        CHECK((current_unknown ? current_unknown->buffers : 0) ==
+            (initial_unknown ? initial_unknown->buffers : 0));
+        REQUIRE(find_owner(stats, "test-second"));
+        CHECK(find_owner(stats, "test-second")->bytes == 50 * 20 * 4);
+
+        // Moving the buffer keeps its accounting.
+        wf::auxilliary_buffer_t moved = std::move(first);
+        stats = wf::get_buffer_memory_stats();
+        CHECK(stats.total_buffers == initial.total_buffers + 2);
+        CHECK(find_owner(stats, "test-first")->buffers == 1);
+
+        // Going over the budget signals memory pressure once, on idle.
+        REQUIRE(second.allocate({1024, 512}) == wf::buffer_reallocation_result_t::REALLOCATED);
+        CHECK(pressure_events == 0);
+        harness.run_until([&] { return pressure_events > 0; }, 10);
+        CHECK(pressure_events == 1);
+
+        harness.roundtrip();
+        CHECK(pressure_events == 1);
+        CHECK(wf::get_buffer_memory_stats().pressure_events == initial.pressure_events + 1);
+    }
+
+    auto final_stats = wf::get_buffer_memory_stats();
+    CHECK(final_stats.total_buffers == initial.total_buffers);
+    CHECK(final_stats.total_bytes == initial.total_bytes);
+    CHECK(find_owner(final_stats, "test-first") == nullptr);
+    CHECK(find_owner(final_stats, "test-second") == nullptr);
+}
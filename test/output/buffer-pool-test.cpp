@@ -0,0 +1,49 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/render.hpp>
+
+#include "../support/headless-core-harness.hpp"
+
+TEST_CASE("Freed auxilliary buffers are reused for allocations of the same size")
+{
+    wf::test::headless_core_harness_t harness{
+        "[workarounds]\n"
+        "aux_buffer_pool_size = 16\n"
+        "aux_buffer_pool_timeout = 50\n"};
+
+    const auto initial = wf::get_buffer_pool_stats();
+
+    wf::auxilliary_buffer_t buffer;
+    REQUIRE(buffer.allocate({128, 64}) == wf::buffer_reallocation_result_t::REALLOCATED);
+    auto *first_wlr_buffer = buffer.get_buffer();
+    CHECK(wf::get_buffer_pool_stats().misses == initial.misses + 1);
+
+    buffer.free();
+    auto stats = wf::get_buffer_pool_stats();
+    CHECK(stats.pooled_buffers == initial.pooled_buffers + 1);
+    CHECK(stats.pooled_bytes == initial.pooled_bytes + 128 * 64 * 4);
+
+    // Same size: served from the pool.
+    REQUIRE(buffer.allocate({128, 64}) == wf::buffer_reallocation_result_t::REALLOCATED);
+    CHECK(buffer.get_buffer() == first_wlr_buffer);
+    stats = wf::get_buffer_pool_stats();
+    CHECK(stats.hits == initial.hits + 1);
+    CHECK(stats.pooled_buffers == initial.pooled_buffers);
+
+    // Different size: the old buffer goes back to the pool, and a new one is allocated.
+    REQUIRE(buffer.allocate({256, 64}) == wf::buffer_reallocation_result_t::REALLOCATED);
+    stats = wf::get_buffer_pool_stats();
+    CHECK(stats.misses == initial.misses + 2);
+    CHECK(stats.pooled_buffers == initial.pooled_buffers + 1);
+
+    // Buffers which are not reused are trimmed after the timeout.
+    CHECK(harness.run_until([&] { return wf::get_buffer_pool_stats().pooled_buffers == 0; }));
+    CHECK(wf::get_buffer_pool_stats().trimmed >= initial.trimmed + 1);
+
+    // Buffers larger than the pool are never kept.
+    REQUIRE(buffer.allocate({4096, 2048}) == wf::buffer_reallocation_result_t::REALLOCATED);
+    buffer.free();
+    CHECK(wf::get_buffer_pool_stats().pooled_bytes <= 16 * 1024 * 1024);
+}
@@ -0,0 +1,143 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <set>
+#include "output/plane-assignment.hpp"
+
+namespace
+{
+/**
+ * A fake output backend: it accepts at most max_layers layers, and never accepts the buffers in rejected.
+ */
+class fake_backend_t : public wf::plane_test_backend_t
+{
+  public:
+    size_t max_layers = 3;
+    std::set<wlr_buffer*> rejected;
+    bool fail_tests   = false;
+    int num_tests     = 0;
+    std::vector<wlr_buffer*> last_tested;
+
+    bool test_layers(std::vector<wf::plane_layer_t>& layers) override
+    {
+        ++num_tests;
+        last_tested.clear();
+        for (size_t i = 0; i < layers.size(); i++)
+        {
+            last_tested.push_back(layers[i].buffer);
+            layers[i].accepted = (i < max_layers) && !rejected.count(layers[i].buffer);
+        }
+
+        return !fail_tests;
+    }
+};
+
+wlr_buffer *fake_buffer(uintptr_t id)
+{
+    return reinterpret_cast<wlr_buffer*>(id);
+}
+
+wf::plane_layer_t layer(uintptr_t id, wlr_box box)
+{
+    return {
+        .buffer  = fake_buffer(id),
+        .src_box = {0, 0, (double)box.width, (double)box.height},
+        .dst_box = box,
+    };
+}
+}
+
+TEST_CASE("All accepted candidates are promoted in one test")
+{
+    fake_backend_t backend;
+    auto result = wf::assign_planes({
+        layer(1, {0, 0, 100, 100}),
+        layer(2, {200, 0, 100, 100}),
+    }, backend);
+
+    CHECK(result == std::vector<bool>{true, true});
+    CHECK(backend.num_tests == 1);
+    // Layers are tested from bottom to top
+    CHECK(backend.last_tested == std::vector<wlr_buffer*>{fake_buffer(2), fake_buffer(1)});
+}
+
+TEST_CASE("No candidates means no tests")
+{
+    fake_backend_t backend;
+    CHECK(wf::assign_planes({}, backend).empty());
+    CHECK(backend.num_tests == 0);
+}
+
+TEST_CASE("Rejected candidates demote overlapping candidates below them")
+{
+    fake_backend_t backend;
+    backend.rejected = {fake_buffer(1)};
+
+    // 1 is on top and overlaps 2, but not 3.
+    auto result = wf::assign_planes({
+        layer(1, {0, 0, 100, 100}),
+        layer(2, {50, 50, 100, 100}),
+        layer(3, {500, 500, 100, 100}),
+    }, backend);
+
+    CHECK(result == std::vector<bool>{false, false, true});
+    CHECK(backend.num_tests == 2);
+    CHECK(backend.last_tested == std::vector<wlr_buffer*>{fake_buffer(3)});
+}
+
+TEST_CASE("A rejected candidate does not demote candidates above it")
+{
+    fake_backend_t backend;
+    backend.rejected = {fake_buffer(2)};
+
+    auto result = wf::assign_planes({
+        layer(1, {0, 0, 100, 100}),
+        layer(2, {50, 50, 100, 100}),
+    }, backend);
+
+    CHECK(result == std::vector<bool>{true, false});
+}
+
+TEST_CASE("Candidates beyond the plane limit are composited")
+{
+    fake_backend_t backend;
+    backend.max_layers = 1;
+
+    // The bottom-most layer gets the only plane, the others overlap nothing.
+    auto result = wf::assign_planes({
+        layer(1, {0, 0, 10, 10}),
+        layer(2, {20, 0, 10, 10}),
+        layer(3, {40, 0, 10, 10}),
+    }, backend);
+
+    CHECK(result == std::vector<bool>{false, false, true});
+}
+
+TEST_CASE("Failed tests fall back to compositing everything")
+{
+    fake_backend_t backend;
+    backend.fail_tests = true;
+
+    auto result = wf::assign_planes({
+        layer(1, {0, 0, 100, 100}),
+        layer(2, {200, 0, 100, 100}),
+    }, backend);
+
+    CHECK(result == std::vector<bool>{false, false});
+    CHECK(backend.num_tests == 1);
+}
+
+TEST_CASE("Configurations which are not verified in time are composited")
+{
+    fake_backend_t backend;
+    backend.max_layers = 1;
+
+    // The reduced configuration would need a second test.
+    auto result = wf::assign_planes({
+        layer(1, {0, 0, 10, 10}),
+        layer(2, {20, 0, 10, 10}),
+    }, backend, 1);
+
+    CHECK(result == std::vector<bool>{false, false});
+    CHECK(backend.num_tests == 1);
+}
@@ -0,0 +1,89 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <wayfire/core.hpp>
+
+#include "../support/headless-core-harness.hpp"
+
+namespace
+{
+std::optional<wf::startup_phase_t> find_phase(const std::string& name)
+{
+    for (auto& phase : wf::get_startup_timeline())
+    {
+        if (phase.name == name)
+        {
+            return phase;
+        }
+    }
+
+    return {};
+}
+
+int64_t percentile(std::vector<int64_t> samples, double p)
+{
+    std::sort(samples.begin(), samples.end());
+    const size_t idx = std::min(samples.size() - 1, (size_t)(p * samples.size()));
+    return samples[idx];
+}
+}
+
+TEST_CASE("startup timeline records core init, plugin loading and the first commit")
+{
+    wf::test::headless_core_harness_t harness{{}, true};
+    REQUIRE(harness.run_until([] { return find_phase("first-commit").has_value(); }));
+
+    auto core_init = find_phase("core-init");
+    auto plugins   = find_phase("plugins");
+    auto first_commit = find_phase("first-commit");
+    REQUIRE(core_init.has_value());
+    REQUIRE(plugins.has_value());
+
+    CHECK(core_init->duration_us >= 0);
+    CHECK(plugins->duration_us >= 0);
+    CHECK(plugins->start_us >= core_init->start_us + core_init->duration_us);
+    CHECK(first_commit->duration_us == 0);
+    CHECK(first_commit->start_us >= core_init->start_us);
+    CHECK_FALSE(find_phase("xwayland").has_value());
+}
+
+/*
+ * The harness creates the display, backend and renderer itself and then calls core init, so this measures
+ * only the phases from core init to the first commit. The backend, renderer, config and backend-start phases
+ * are recorded in main() and are only available from a real wayfire process, for example through the
+ * wayfire/startup-timeline IPC method. Process start, dynamic linking and the launcher fork are not included
+ * either.
+ */
+TEST_CASE("benchmark: headless startup to first commit")
+{
+    constexpr int runs = 20;
+    std::vector<int64_t> total;
+    std::map<std::string, std::vector<int64_t>> per_phase;
+
+    for (int i = 0; i < runs; i++)
+    {
+        wf::test::headless_core_harness_t harness{{}, true};
+        REQUIRE(harness.run_until([] { return find_phase("first-commit").has_value(); }));
+        for (auto& phase : wf::get_startup_timeline())
+        {
+            if (phase.name == "first-commit")
+            {
+                total.push_back(phase.start_us);
+            } else
+            {
+                per_phase[phase.name].push_back(phase.duration_us);
+            }
+        }
+    }
+
+    MESSAGE("startup to first commit over " << runs << " runs: p50 " << percentile(total, 0.5) <<
+        " us, p90 " << percentile(total, 0.9) << " us, p99 " << percentile(total, 0.99) << " us");
+    for (auto& [name, durations] : per_phase)
+    {
+        MESSAGE("    " << name << ": p50 " << percentile(durations, 0.5) << " us, p90 " <<
+            percentile(durations, 0.9) << " us");
+    }
+}
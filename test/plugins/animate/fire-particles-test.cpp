@@ -0,0 +1,86 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../support/headless-core-harness.hpp"
+#include "../../../plugins/animate/fire/particle.hpp"
+
+#include <wayfire/task-pool.hpp>
+#include <wayfire/util/log.hpp>
+
+#include <chrono>
+
+namespace
+{
+ParticleEmitter make_emitter()
+{
+    ParticleEmitter emitter;
+    emitter.pos_min   = {0, 90};
+    emitter.pos_max   = {800, 110};
+    emitter.speed_min = {-10, -25};
+    emitter.speed_max = {10, 5};
+    emitter.gravity   = {-1, -3};
+    emitter.fade_min  = 0.1;
+    emitter.fade_max  = 0.6;
+    emitter.radius_min = 8;
+    emitter.radius_max = 12;
+    emitter.color_min  = {0.5, 0.2, 0.0};
+    emitter.color_max  = {1.0, 0.4, 0.1};
+    return emitter;
+}
+}
+
+TEST_CASE("particles are spawned, updated and die")
+{
+    wf::test::headless_core_harness_t harness;
+
+    ParticleSystem ps{1000};
+    CHECK(ps.statistic() == 0);
+
+    auto emitter = make_emitter();
+    CHECK(ps.spawn(100, emitter) == 100);
+    CHECK(ps.statistic() == 100);
+
+    // There are only 1000 slots
+    CHECK(ps.spawn(2000, emitter) == 900);
+    CHECK(ps.statistic() == 1000);
+    CHECK(ps.spawn(1, emitter) == 0);
+
+    // Shrinking kills the particles in the removed slots
+    ps.resize(500);
+    CHECK(ps.statistic() == 500);
+
+    // fade is at least 0.1 and life decays by 0.24 * fade per update
+    for (int i = 0; i < 50; i++)
+    {
+        ps.update();
+    }
+
+    CHECK(ps.statistic() == 0);
+    CHECK(ps.spawn(500, emitter) == 500);
+}
+
+TEST_CASE("benchmark: particle update throughput")
+{
+    wf::test::headless_core_harness_t harness;
+    LOGI("Task pool workers: ", wf::get_core().task_pool->get_num_workers());
+
+    auto emitter = make_emitter();
+    for (int count : {10000, 25000, 50000, 100000})
+    {
+        ParticleSystem ps{count};
+        constexpr int frames = 200;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; frame++)
+        {
+            ps.spawn(count / 10, emitter);
+            ps.update();
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        const double us_per_frame =
+            std::chrono::duration<double, std::micro>(elapsed).count() / frames;
+        MESSAGE(count << " particles: " << us_per_frame << " us per frame");
+        CHECK(ps.statistic() > 0);
+    }
+}
@@ -0,0 +1,297 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/output.hpp>
+#include <wayfire/toplevel.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "../../../plugins/tile/tree.hpp"
+#include "../../support/mapped-toplevel.hpp"
+
+namespace
+{
+/** A leaf standing in for a view node, which counts how often it is laid out. */
+struct test_leaf_t : public wf::tile::tree_node_t
+{
+    int visits     = 0;
+    int configures = 0;
+
+    void set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx) override
+    {
+        visits++;
+        if (geometry != this->geometry)
+        {
+            configures++;
+        }
+
+        tree_node_t::set_geometry(geometry, tx);
+        needs_layout = false;
+    }
+
+    void set_gaps(const wf::tile::gap_size_t& gaps) override
+    {
+        if ((this->gaps.left != gaps.left) || (this->gaps.right != gaps.right) ||
+            (this->gaps.top != gaps.top) || (this->gaps.bottom != gaps.bottom))
+        {
+            invalidate_layout();
+        }
+
+        this->gaps = gaps;
+    }
+};
+
+struct test_tree_t
+{
+    static constexpr wf::geometry_t workarea = {0, 0, 3840, 2160};
+
+    std::unique_ptr<wf::tile::split_node_t> root;
+    /* leaves[column] contains all leaves in the given top-level column */
+    std::vector<std::vector<test_leaf_t*>> leaves;
+
+    /**
+     * Build a tree of columns, each split into rows, each split again into columns of leaves, in the same
+     * way as the tile plugin does when views are added one by one.
+     */
+    test_tree_t(int columns, int rows, int leaves_per_row)
+    {
+        root = std::make_unique<wf::tile::split_node_t>(wf::tile::SPLIT_VERTICAL);
+        auto tx = wf::txn::transaction_t::create(100);
+        root->set_geometry(workarea, tx);
+
+        leaves.resize(columns);
+        for (int c = 0; c < columns; c++)
+        {
+            auto column = std::make_unique<wf::tile::split_node_t>(wf::tile::SPLIT_HORIZONTAL);
+            auto column_ptr = column.get();
+            root->add_child(std::move(column), tx);
+            for (int r = 0; r < rows; r++)
+            {
+                auto row = std::make_unique<wf::tile::split_node_t>(wf::tile::SPLIT_VERTICAL);
+                auto row_ptr = row.get();
+                column_ptr->add_child(std::move(row), tx);
+                for (int l = 0; l < leaves_per_row; l++)
+                {
+                    auto leaf = std::make_unique<test_leaf_t>();
+                    leaves[c].push_back(leaf.get());
+                    row_ptr->add_child(std::move(leaf), tx);
+                }
+            }
+        }
+
+        root->set_gaps({.left = 5, .right = 5, .top = 5, .bottom = 5, .internal = 5});
+        root->set_geometry(workarea, tx);
+        reset_counters();
+    }
+
+    void reset_counters()
+    {
+        for_each_leaf([] (test_leaf_t *leaf) { leaf->visits = leaf->configures = 0; });
+    }
+
+    template<class F>
+    void for_each_leaf(F&& func)
+    {
+        for (auto& column : leaves)
+        {
+            for (auto leaf : column)
+            {
+                func(leaf);
+            }
+        }
+    }
+
+    int total(int test_leaf_t::*counter)
+    {
+        int sum = 0;
+        for_each_leaf([&] (test_leaf_t *leaf) { sum += leaf->*counter; });
+        return sum;
+    }
+
+    /** Move the border between the first two columns, like the resize controller does. */
+    void drag_border(int delta, wf::txn::transaction_uptr& tx)
+    {
+        auto& first  = root->children[0];
+        auto& second = root->children[1];
+        auto g1 = first->geometry;
+        auto g2 = second->geometry;
+        g1.width += delta;
+        g2.x     += delta;
+        g2.width -= delta;
+        first->set_geometry(g1, tx);
+        second->set_geometry(g2, tx);
+    }
+};
+}
+
+TEST_CASE("relayout with unchanged geometry does not visit any leaf")
+{
+    test_tree_t tree{4, 3, 2};
+    auto tx = wf::txn::transaction_t::create(100);
+    tree.root->set_geometry(test_tree_t::workarea, tx);
+    CHECK(tree.total(&test_leaf_t::visits) == 0);
+}
+
+TEST_CASE("resizing two columns only lays out their subtrees")
+{
+    test_tree_t tree{4, 3, 2};
+    auto tx = wf::txn::transaction_t::create(100);
+    tree.drag_border(10, tx);
+
+    for (int c = 0; c < 4; c++)
+    {
+        for (auto leaf : tree.leaves[c])
+        {
+            if (c < 2)
+            {
+                CHECK(leaf->configures == 1);
+            } else
+            {
+                CHECK(leaf->visits == 0);
+            }
+        }
+    }
+
+    /* The rows keep spanning the whole column */
+    auto first_column = tree.root->children[0].get();
+    for (auto& row : first_column->children)
+    {
+        CHECK(row->geometry.width == first_column->geometry.width);
+    }
+}
+
+TEST_CASE("invalidated nodes are laid out again even if their geometry did not change")
+{
+    test_tree_t tree{4, 3, 2};
+    tree.leaves[2][3]->invalidate_layout();
+
+    auto tx = wf::txn::transaction_t::create(100);
+    tree.root->set_geometry(test_tree_t::workarea, tx);
+
+    /* Only the invalidated leaf and its sibling are visited, and none of them changes */
+    CHECK(tree.total(&test_leaf_t::visits) == 2);
+    CHECK(tree.leaves[2][3]->visits == 1);
+    CHECK(tree.total(&test_leaf_t::configures) == 0);
+}
+
+TEST_CASE("changing the gaps relays out the nodes whose gaps changed")
+{
+    test_tree_t tree{4, 3, 2};
+    auto tx = wf::txn::transaction_t::create(100);
+
+    /* Same gaps: nothing to do */
+    tree.root->set_gaps(tree.root->get_gaps());
+    tree.root->set_geometry(test_tree_t::workarea, tx);
+    CHECK(tree.total(&test_leaf_t::visits) == 0);
+
+    /* Only the leaves on the left edge of the layout have a left outer gap */
+    auto gaps = tree.root->get_gaps();
+    gaps.left = 20;
+    tree.root->set_gaps(gaps);
+    tree.root->set_geometry(test_tree_t::workarea, tx);
+    for (int c = 1; c < 4; c++)
+    {
+        for (auto leaf : tree.leaves[c])
+        {
+            CHECK(leaf->visits == 0);
+        }
+    }
+
+    CHECK(tree.leaves[0][0]->visits == 1);
+    CHECK(tree.leaves[0][0]->get_gaps().left == 20);
+    CHECK(tree.total(&test_leaf_t::configures) == 0);
+
+    /* The internal gap affects every leaf */
+    tree.reset_counters();
+    gaps.internal = 10;
+    tree.root->set_gaps(gaps);
+    tree.root->set_geometry(test_tree_t::workarea, tx);
+    CHECK(tree.total(&test_leaf_t::visits) == 4 * 3 * 2);
+}
+
+TEST_CASE("removing a child lays out the remaining siblings")
+{
+    test_tree_t tree{4, 3, 2};
+    auto tx = wf::txn::transaction_t::create(100);
+
+    auto column = tree.root->children[3].get();
+    auto row    = column->children[0]->as_split_node();
+    auto removed = row->remove_child({row->children[0]}, tx);
+    REQUIRE(removed);
+
+    auto remaining = row->children[0].get();
+    CHECK(remaining->geometry == row->geometry);
+    CHECK(remaining->get_gaps().left == row->get_gaps().left);
+    CHECK(remaining->get_gaps().right == row->get_gaps().right);
+}
+
+TEST_CASE("view nodes configure their view only when its tiled state changes")
+{
+    wf::test::headless_core_harness_t harness{"[simple-tile]\nanimation_duration = 0\n"};
+    auto tiled = wf::test::map_toplevel(harness, "tiled", 200, 100);
+    auto toplevel = tiled.view->toplevel();
+    auto configures = [&] (const wf::txn::transaction_uptr& tx)
+    {
+        auto& objects = tx->get_objects();
+        return std::count(objects.begin(), objects.end(), toplevel);
+    };
+
+    const auto workarea = harness.output()->get_relative_geometry();
+    auto root = std::make_unique<wf::tile::split_node_t>(wf::tile::SPLIT_VERTICAL);
+    auto tx   = wf::txn::transaction_t::create(100);
+    root->set_geometry(workarea, tx);
+    root->add_child(std::make_unique<wf::tile::view_node_t>(tiled.view), tx);
+    CHECK(configures(tx) > 0);
+    CHECK(toplevel->pending().geometry == workarea);
+    CHECK(toplevel->pending().tiled_edges == wf::TILED_EDGES_ALL);
+
+    /* The view is already configured to its tiled geometry */
+    tx = wf::txn::transaction_t::create(100);
+    root->invalidate_subtree_layout();
+    root->set_geometry(workarea, tx);
+    CHECK(configures(tx) == 0);
+
+    /* Going fullscreen keeps the geometry of a view tiled over the whole output, but it must be committed */
+    tx = wf::txn::transaction_t::create(100);
+    toplevel->pending().fullscreen = true;
+    root->invalidate_subtree_layout();
+    root->set_geometry(workarea, tx);
+    CHECK(toplevel->pending().geometry == workarea);
+    CHECK(configures(tx) > 0);
+}
+
+TEST_CASE("benchmark: dragging a split border with 200 tiled views")
+{
+    test_tree_t tree{10, 4, 5};
+    constexpr int steps = 2000;
+
+    auto run = [&] (bool full_relayout)
+    {
+        tree.reset_counters();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < steps; i++)
+        {
+            auto tx = wf::txn::transaction_t::create(100);
+            if (full_relayout)
+            {
+                /* What every relayout did before it became incremental */
+                tree.root->invalidate_subtree_layout();
+                tree.root->set_geometry(test_tree_t::workarea, tx);
+            }
+
+            tree.drag_border((i % 2) ? -3 : 3, tx);
+        }
+
+        auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+        return std::make_pair(elapsed.count() / steps, 1.0 * tree.total(&test_leaf_t::visits) / steps);
+    };
+
+    auto [full_us, full_visits] = run(true);
+    auto [incremental_us, incremental_visits] = run(false);
+
+    CHECK(incremental_visits == 40);
+    MESSAGE("200 views, per drag step: full relayout " << full_us << " us / " << full_visits <<
+        " views visited, incremental " << incremental_us << " us / " << incremental_visits << " views visited");
+}
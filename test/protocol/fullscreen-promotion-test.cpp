@@ -0,0 +1,65 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/scene-operations.hpp>
+#include <wayfire/toplevel-view.hpp>
+#include <wayfire/window-manager.hpp>
+
+#include "../support/headless-core-harness.hpp"
+#include "../support/mapped-toplevel.hpp"
+
+TEST_CASE("fullscreen promotion is only re-evaluated on relevant events")
+{
+    wf::test::headless_core_harness_t harness;
+    auto output = harness.output();
+
+    auto mapped = wf::test::map_toplevel(harness, "promotion test", 200, 120);
+    auto& client = *mapped.client;
+    auto view    = mapped.view;
+
+    /* Updates outside of the workspace layer, and geometry updates of the views, do not change which view
+     * is on top */
+    const auto before = output->get_promotion_stats();
+    wf::scene::update(output->node_for_layer(wf::scene::layer::TOP), wf::scene::update_flag::CHILDREN_LIST);
+    wf::scene::update(view->get_root_node(), wf::scene::update_flag::GEOMETRY);
+    CHECK(output->get_promotion_stats().searches == before.searches);
+    CHECK(output->get_promotion_stats().events == before.events + 1);
+
+    wf::get_core().default_wm->fullscreen_request(view, output, true);
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_pending_configure() && client.last_toplevel_configure_fullscreen();
+    }));
+    client.attach_and_commit(1280, 720);
+
+    auto top_layer = output->node_for_layer(wf::scene::layer::TOP);
+    REQUIRE(harness.run_until([&] { return !top_layer->is_enabled(); }));
+    CHECK(output->get_promotion_stats().promotions == before.promotions + 1);
+
+    /* Unmapping the promoted view restores the top layer */
+    client.destroy_toplevel();
+    REQUIRE(harness.run_until([&] { return top_layer->is_enabled(); }));
+}
+
+TEST_CASE("moving a view below the top view does not search the stack again")
+{
+    wf::test::headless_core_harness_t harness;
+    auto output = harness.output();
+
+    auto below = wf::test::map_toplevel(harness, "below", 200, 120);
+    auto above = wf::test::map_toplevel(harness, "above", 200, 120);
+
+    auto before = output->get_promotion_stats();
+    below.view->move(10, 10);
+    REQUIRE(harness.run_until([&] { return below.view->get_geometry().x == 10; }));
+    CHECK(output->get_promotion_stats().searches == before.searches);
+
+    /* The top view itself may leave the current workspace */
+    before = output->get_promotion_stats();
+    above.view->move(20, 20);
+    REQUIRE(harness.run_until([&] { return above.view->get_geometry().x == 20; }));
+    CHECK(output->get_promotion_stats().searches == before.searches + 1);
+}
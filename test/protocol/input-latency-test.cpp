@@ -0,0 +1,300 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/nonstd/wlroots-full.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/toplevel-view.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "../support/headless-core-harness.hpp"
+#include "../support/ipc-client.hpp"
+#include "../support/mapped-toplevel.hpp"
+#include "../support/scoped-env.hpp"
+
+namespace
+{
+using latency_clock = std::chrono::steady_clock;
+
+/** The times at which one injected input event passed each stage on its way to the screen. */
+struct latency_sample_t
+{
+    latency_clock::time_point injected;
+    /** Core emitted the input event */
+    latency_clock::time_point input;
+    /** The client committed a new buffer in response */
+    latency_clock::time_point client_commit;
+    /** The output started repainting */
+    latency_clock::time_point paint;
+    /** The output committed the repainted frame */
+    latency_clock::time_point output_commit;
+};
+
+/**
+ * Timestamps the stages of a latency sample. Each stage is recorded the first time it happens after the
+ * previous stage, so that unrelated commits and repaints before the input arrives are ignored.
+ */
+class latency_probe_t
+{
+  public:
+    latency_sample_t sample;
+
+    latency_probe_t(wf::output_t *output, wlr_surface *surface) : output(output)
+    {
+        wf::get_core().connect(&on_motion);
+        wf::get_core().connect(&on_button);
+        wf::get_core().connect(&on_key);
+        output->render->add_effect(&on_paint, wf::OUTPUT_EFFECT_PRE);
+
+        on_surface_commit.set_callback([=] (void*)
+        {
+            mark(sample.client_commit, sample.input);
+        });
+        on_surface_commit.connect(&surface->events.commit);
+
+        on_output_commit.set_callback([=] (void *data)
+        {
+            auto ev = static_cast<wlr_output_event_commit*>(data);
+            if (ev->state->committed & WLR_OUTPUT_STATE_BUFFER)
+            {
+                mark(sample.output_commit, sample.paint);
+            }
+        });
+        on_output_commit.connect(&output->handle->events.commit);
+    }
+
+    ~latency_probe_t()
+    {
+        output->render->rem_effect(&on_paint);
+    }
+
+    void start()
+    {
+        sample = {};
+        sample.injected = latency_clock::now();
+    }
+
+    bool is_complete() const
+    {
+        return sample.output_commit != latency_clock::time_point{};
+    }
+
+  private:
+    wf::output_t *output;
+
+    static void mark(latency_clock::time_point& stage, const latency_clock::time_point& previous)
+    {
+        if ((previous != latency_clock::time_point{}) && (stage == latency_clock::time_point{}))
+        {
+            stage = latency_clock::now();
+        }
+    }
+
+    wf::signal::connection_t<wf::input_event_signal<wlr_pointer_motion_event>> on_motion = [=] (auto)
+    {
+        mark(sample.input, sample.injected);
+    };
+    wf::signal::connection_t<wf::input_event_signal<wlr_pointer_button_event>> on_button = [=] (auto)
+    {
+        mark(sample.input, sample.injected);
+    };
+    wf::signal::connection_t<wf::input_event_signal<wlr_keyboard_key_event>> on_key = [=] (auto)
+    {
+        mark(sample.input, sample.injected);
+    };
+
+    wf::effect_hook_t on_paint = [=] ()
+    {
+        mark(sample.paint, sample.client_commit);
+    };
+
+    wf::wl_listener_wrapper on_surface_commit;
+    wf::wl_listener_wrapper on_output_commit;
+};
+
+/**
+ * Start a compositor with the ipc and stipc plugins and the given extra configuration, map a test client
+ * which redraws whenever it receives input, and measure @count injected input events, cycling between
+ * pointer motion, pointer buttons and keys.
+ */
+std::vector<latency_sample_t> measure_latency(const std::string& config, int count)
+{
+    static int instance = 0;
+    const auto ipc_path = (std::filesystem::temp_directory_path() /
+        ("wayfire-input-latency-test-" + std::to_string(getpid()) + "-" + std::to_string(instance++) +
+            ".socket")).string();
+    unlink(ipc_path.c_str());
+
+    wf::test::scoped_env_t plugin_path{"WAYFIRE_PLUGIN_PATH", TEST_PLUGIN_PATH};
+    wf::test::scoped_env_t ipc_socket{"_WAYFIRE_SOCKET", ipc_path};
+    wf::test::headless_core_harness_t harness{"[core]\nplugins = ipc stipc\n\n" + config, true};
+    REQUIRE(harness.run_until([&] { return std::filesystem::exists(ipc_path); }));
+    wf::test::ipc_client_t ipc{ipc_path};
+
+    constexpr int width = 400, height = 300;
+    auto mapped  = wf::test::map_toplevel(harness, "latency test", width, height);
+    auto& client = *mapped.client;
+    auto view    = mapped.view;
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_pointer() && client.has_keyboard();
+    }));
+
+    const auto geometry = view->get_geometry();
+    const double center_x = geometry.x + geometry.width / 2.0;
+    const double center_y = geometry.y + geometry.height / 2.0;
+    auto move_cursor = [&] (double x, double y)
+    {
+        wf::json_t data;
+        data["x"] = x;
+        data["y"] = y;
+        return wf::test::call_method(harness, ipc, "stipc/move_cursor", data);
+    };
+
+    move_cursor(center_x, center_y);
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return std::any_of(client.pointer_events().begin(), client.pointer_events().end(),
+            [] (auto& ev) { return ev.type == wf::test::pointer_event_t::ENTER; });
+    }));
+
+    latency_probe_t probe{harness.output(), view->get_wlr_surface()};
+    std::vector<latency_sample_t> samples;
+    for (int i = 0; i < count; i++)
+    {
+        /* Inject at different points of the refresh cycle */
+        auto idle_until = latency_clock::now() + std::chrono::milliseconds((i * 7) % 17);
+        while (latency_clock::now() < idle_until)
+        {
+            harness.dispatch_once(1);
+        }
+
+        client.dispatch_once();
+        client.clear_pointer_events();
+        client.clear_keyboard_events();
+
+        const int kind     = i % 3;
+        const bool pressed = (i / 3) % 2 == 0;
+        wf::json_t data;
+        probe.start();
+        if (kind == 0)
+        {
+            move_cursor(center_x + (pressed ? 1 : -1), center_y);
+        } else if (kind == 1)
+        {
+            data["combo"] = std::string("BTN_LEFT");
+            data["mode"]  = std::string(pressed ? "press" : "release");
+            wf::test::call_method(harness, ipc, "stipc/feed_button", data);
+        } else
+        {
+            data["key"]   = std::string("KEY_A");
+            data["state"] = pressed;
+            wf::test::call_method(harness, ipc, "stipc/feed_key", data);
+        }
+
+        REQUIRE(harness.run_until([&]
+        {
+            client.dispatch_once();
+            if (kind == 2)
+            {
+                return std::any_of(client.keyboard_events().begin(), client.keyboard_events().end(),
+                    [] (auto& ev) { return ev.type == wf::test::keyboard_event_t::KEY; });
+            }
+
+            auto type = (kind == 0) ? wf::test::pointer_event_t::MOTION : wf::test::pointer_event_t::BUTTON;
+            return std::any_of(client.pointer_events().begin(), client.pointer_events().end(),
+                [&] (auto& ev) { return ev.type == type; });
+        }));
+
+        /* Redraw in response to the input */
+        client.attach_and_commit(width, height,
+            std::vector<uint32_t>(width * height, (i % 2) ? 0xFFFF0000 : 0xFF0000FF));
+        REQUIRE(harness.run_until([&] { return probe.is_complete(); }));
+        samples.push_back(probe.sample);
+    }
+
+    return samples;
+}
+
+double to_ms(latency_clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/** Format the 50th, 90th and 99th percentile and the maximum of @values. */
+std::string describe_distribution(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    auto percentile = [&] (double p)
+    {
+        return values[std::min(values.size() - 1, (size_t)(p * values.size()))];
+    };
+
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "p50 %6.2f  p90 %6.2f  p99 %6.2f  max %6.2f ms",
+        percentile(0.5), percentile(0.9), percentile(0.99), values.back());
+    return buffer;
+}
+}
+
+TEST_CASE("injected input reaches the screen through a redrawing client")
+{
+    auto samples = measure_latency("", 6);
+    REQUIRE(samples.size() == 6);
+    for (auto& sample : samples)
+    {
+        CHECK(sample.injected <= sample.input);
+        CHECK(sample.input <= sample.client_commit);
+        CHECK(sample.client_commit <= sample.paint);
+        CHECK(sample.paint <= sample.output_commit);
+    }
+}
+
+TEST_CASE("benchmark: input-to-present latency across scheduler settings")
+{
+    struct setting_t
+    {
+        std::string name;
+        std::string config;
+    };
+
+    const std::vector<setting_t> settings = {
+        {"full frame budget", "[workarounds]\ndynamic_repaint_delay = false\n"},
+        {"dynamic repaint delay", "[workarounds]\ndynamic_repaint_delay = true\n"},
+        {"min_render_budget = 4", "[output:HEADLESS-1]\nmin_render_budget = 4\n"},
+        {"min_render_budget = 8", "[output:HEADLESS-1]\nmin_render_budget = 8\n"},
+    };
+
+    constexpr int count = 90;
+    for (auto& setting : settings)
+    {
+        auto samples = measure_latency(setting.config, count);
+        std::vector<double> total, input, client, paint, present;
+        for (auto& sample : samples)
+        {
+            total.push_back(to_ms(sample.output_commit - sample.injected));
+            input.push_back(to_ms(sample.input - sample.injected));
+            client.push_back(to_ms(sample.client_commit - sample.input));
+            paint.push_back(to_ms(sample.paint - sample.client_commit));
+            present.push_back(to_ms(sample.output_commit - sample.paint));
+        }
+
+        MESSAGE(setting.name << ", " << count << " samples\n" <<
+            "  inject to output commit:  " << describe_distribution(total) << "\n" <<
+            "  inject to core input:     " << describe_distribution(input) << "\n" <<
+            "  input to client commit:   " << describe_distribution(client) << "\n" <<
+            "  client commit to repaint: " << describe_distribution(paint) << "\n" <<
+            "  repaint to output commit: " << describe_distribution(present));
+    }
+}
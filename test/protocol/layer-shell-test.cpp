@@ -141,3 +141,59 @@ TEST_CASE("layer-shell popup with keyboard none does not steal focus")
 
     CHECK(wf::get_core().seat->get_active_view() == focused_view);
 }
+
+TEST_CASE("layer-shell commits without changes do not rearrange the output")
+{
+    wf::test::headless_core_harness_t harness;
+    wf::test::wayland_layer_shell_client_t layer_client{harness.socket_name()};
+    REQUIRE(harness.run_until([&]
+    {
+        layer_client.dispatch_once();
+        return layer_client.has_required_globals();
+    }));
+
+    const auto initial_workarea = harness.output()->workarea->get_workarea();
+    const int panel_height = 30;
+
+    layer_client.create_layer_surface("coalesced-arrangement",
+        LAYER_OVERLAY,
+        LAYER_KEYBOARD_NONE,
+        0, panel_height,
+        LAYER_ANCHOR_TOP | LAYER_ANCHOR_LEFT | LAYER_ANCHOR_RIGHT);
+    layer_client.set_layer_exclusive_zone(panel_height);
+
+    REQUIRE(harness.run_until([&]
+    {
+        layer_client.dispatch_once();
+        return layer_client.has_pending_layer_configure();
+    }));
+
+    layer_client.attach_layer_and_commit(initial_workarea.width, panel_height);
+    REQUIRE(harness.run_until([&]
+    {
+        layer_client.dispatch_once();
+        return harness.output()->workarea->get_workarea().y == initial_workarea.y + panel_height;
+    }));
+
+    int workarea_changes = 0;
+    wf::signal::connection_t<wf::workarea_changed_signal> on_workarea_changed =
+        [&] (wf::workarea_changed_signal*) { ++workarea_changes; };
+    harness.output()->connect(&on_workarea_changed);
+
+    // Some status bars set their layer state again whenever they redraw, for example every clock tick.
+    const uint32_t serial = layer_client.last_layer_configure_serial();
+    for (int i = 0; i < 10; i++)
+    {
+        layer_client.set_layer_exclusive_zone(panel_height);
+        layer_client.attach_layer_and_commit(initial_workarea.width, panel_height);
+        harness.run_until([&]
+        {
+            layer_client.dispatch_once();
+            return false;
+        }, 20);
+    }
+
+    CHECK(workarea_changes == 0);
+    CHECK(layer_client.last_layer_configure_serial() == serial);
+    CHECK(harness.output()->workarea->get_workarea().y == initial_workarea.y + panel_height);
+}
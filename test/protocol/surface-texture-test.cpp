@@ -0,0 +1,155 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/toplevel-view.hpp>
+#include <wayfire/unstable/wlr-surface-node.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../support/headless-core-harness.hpp"
+#include "../support/mapped-toplevel.hpp"
+#include "../support/wayland-xdg-client.hpp"
+
+namespace
+{
+std::atomic<uint64_t> allocation_count{0};
+}
+
+void *operator new(size_t size)
+{
+    ++allocation_count;
+    if (void *ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+wf::scene::wlr_surface_node_t *find_surface_node(const wf::scene::node_ptr& root)
+{
+    if (auto node = dynamic_cast<wf::scene::wlr_surface_node_t*>(root.get()))
+    {
+        return node;
+    }
+
+    for (auto& child : root->get_children())
+    {
+        if (auto node = find_surface_node(child))
+        {
+            return node;
+        }
+    }
+
+    return nullptr;
+}
+
+struct mapped_clients_t
+{
+    std::vector<std::unique_ptr<wf::test::wayland_xdg_client_t>> clients;
+    std::vector<wayfire_view> views;
+
+    mapped_clients_t(wf::test::headless_core_harness_t& harness, int count, int width, int height)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            auto mapped = wf::test::map_toplevel(harness, "surface-texture " + std::to_string(i), width,
+                height);
+            clients.push_back(std::move(mapped.client));
+            views.push_back(mapped.view);
+        }
+    }
+};
+}
+
+TEST_CASE("surface texture wrapper is reused until the buffer changes")
+{
+    wf::test::headless_core_harness_t harness;
+    mapped_clients_t mapped{harness, 1, 200, 120};
+
+    auto node = find_surface_node(mapped.views.front()->get_surface_root_node());
+    REQUIRE(node);
+
+    auto tex = node->to_texture();
+    REQUIRE(tex);
+    CHECK(tex == node->to_texture());
+    CHECK(tex->get_width() == 200);
+
+    // Properties set by a consumer do not leak into the next user of the shared wrapper
+    tex->set_filter_mode(WLR_SCALE_FILTER_BILINEAR);
+    CHECK(!node->to_texture()->get_filter_mode().has_value());
+
+    mapped.clients.front()->attach_and_commit(300, 200);
+    REQUIRE(harness.run_until([&] () { return node->get_bounding_box().width == 300; }));
+
+    auto resized = node->to_texture();
+    REQUIRE(resized);
+    CHECK(resized != tex);
+    CHECK(resized->get_width() == 300);
+}
+
+TEST_CASE("benchmark: allocations per frame with 50 static surfaces")
+{
+    wf::test::headless_core_harness_t harness;
+    mapped_clients_t mapped{harness, 50, 100, 100};
+
+    // Spread the views in a grid so that none of them is occluded
+    for (size_t i = 0; i < mapped.views.size(); i++)
+    {
+        auto toplevel = wf::toplevel_cast(mapped.views[i]);
+        REQUIRE(toplevel);
+        toplevel->move(10 + (i % 10) * 125, 10 + (i / 10) * 140);
+    }
+
+    harness.roundtrip();
+
+    auto *output = harness.output();
+    uint64_t frame_start = 0;
+    uint64_t frame_allocations = 0;
+    int frames = 0;
+    wf::effect_hook_t on_pre = [&] { frame_start = allocation_count; };
+    wf::effect_hook_t on_post = [&]
+    {
+        frame_allocations += allocation_count - frame_start;
+        ++frames;
+    };
+
+    output->render->add_effect(&on_pre, wf::OUTPUT_EFFECT_PRE);
+    output->render->add_effect(&on_post, wf::OUTPUT_EFFECT_POST);
+
+    constexpr int target_frames = 120;
+    for (int i = 0; i < target_frames; i++)
+    {
+        const int frames_before = frames;
+        output->render->damage_whole();
+        output->render->schedule_redraw();
+        REQUIRE(harness.run_until([&] () { return frames > frames_before; }));
+    }
+
+    output->render->rem_effect(&on_pre);
+    output->render->rem_effect(&on_post);
+
+    MESSAGE(mapped.views.size() << " static surfaces: " <<
+        1.0 * frame_allocations / frames << " allocations per frame");
+    CHECK(frames >= target_frames);
+}
@@ -0,0 +1,131 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/scene.hpp>
+#include <wayfire/toplevel-view.hpp>
+#include <wayfire/view-helpers.hpp>
+#include <wayfire/workspace-set.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "../support/headless-core-harness.hpp"
+#include "../support/mapped-toplevel.hpp"
+
+namespace
+{
+/** Map @count xdg toplevels, each from its own client, and return their views in the order they mapped. */
+std::vector<wayfire_toplevel_view> map_views(wf::test::headless_core_harness_t& harness, int count,
+    std::vector<std::unique_ptr<wf::test::wayland_xdg_client_t>>& clients)
+{
+    std::vector<wayfire_toplevel_view> mapped;
+    for (int i = 0; i < count; i++)
+    {
+        auto toplevel = wf::test::map_toplevel(harness, "view " + std::to_string(i), 64, 64);
+        mapped.push_back(toplevel.view);
+        clients.push_back(std::move(toplevel.client));
+    }
+
+    return mapped;
+}
+
+/** The stacking order as get_views() computed it before it was cached: a sort by scenegraph position. */
+std::vector<wayfire_toplevel_view> sort_by_scenegraph(std::vector<wayfire_toplevel_view> views)
+{
+    auto path_to_root = [] (wf::scene::node_t *node)
+    {
+        std::vector<size_t> path;
+        for (; node->parent(); node = node->parent())
+        {
+            auto& children = node->parent()->get_children();
+            auto it = std::find_if(children.begin(), children.end(),
+                [&] (auto& child) { return child.get() == node; });
+            path.push_back(it - children.begin());
+        }
+
+        std::reverse(path.begin(), path.end());
+        return path;
+    };
+
+    std::sort(views.begin(), views.end(), [&] (wayfire_toplevel_view a, wayfire_toplevel_view b)
+    {
+        return path_to_root(a->get_root_node().get()) < path_to_root(b->get_root_node().get());
+    });
+    return views;
+}
+}
+
+TEST_CASE("views are sorted by stacking order and follow restacking")
+{
+    wf::test::headless_core_harness_t harness;
+    std::vector<std::unique_ptr<wf::test::wayland_xdg_client_t>> clients;
+    auto views = map_views(harness, 3, clients);
+    auto wset  = harness.output()->wset();
+
+    auto sorted = wset->get_views(wf::WSET_SORT_STACKING);
+    REQUIRE(sorted.size() == 3);
+    CHECK(sorted == sort_by_scenegraph(views));
+
+    wf::view_bring_to_front(views[0]);
+    sorted = wset->get_views(wf::WSET_SORT_STACKING);
+    CHECK(sorted.front() == views[0]);
+    CHECK(sorted == sort_by_scenegraph(views));
+
+    /* Filters are applied on top of the stacking order */
+    views[1]->minimized = true;
+    auto unminimized = wset->get_views(wf::WSET_SORT_STACKING | wf::WSET_EXCLUDE_MINIMIZED);
+    CHECK(unminimized.size() == 2);
+    CHECK(std::find(unminimized.begin(), unminimized.end(), views[1]) == unminimized.end());
+    CHECK(unminimized.front() == views[0]);
+    views[1]->minimized = false;
+
+    /* Views which leave the wset leave the stacking order */
+    wset->remove_view(views[2]);
+    sorted = wset->get_views(wf::WSET_SORT_STACKING);
+    CHECK(sorted.size() == 2);
+    CHECK(std::find(sorted.begin(), sorted.end(), views[2]) == sorted.end());
+    wset->add_view(views[2]);
+    CHECK(wset->get_views(wf::WSET_SORT_STACKING).size() == 3);
+}
+
+TEST_CASE("benchmark: stacking order of 300 views")
+{
+    wf::test::headless_core_harness_t harness;
+    std::vector<std::unique_ptr<wf::test::wayland_xdg_client_t>> clients;
+    auto views = map_views(harness, 300, clients);
+    auto wset  = harness.output()->wset();
+    constexpr int iterations = 1000;
+
+    auto measure = [&] (bool restack, auto&& get_sorted)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+        {
+            if (restack)
+            {
+                wf::view_bring_to_front(views[(i * 7) % views.size()]);
+            }
+
+            auto sorted = get_sorted();
+            REQUIRE(sorted.size() == views.size());
+        }
+
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+               iterations;
+    };
+
+    auto cached = [&] { return wset->get_views(wf::WSET_SORT_STACKING | wf::WSET_MAPPED_ONLY); };
+    auto sorted = [&] { return sort_by_scenegraph(wset->get_views(wf::WSET_MAPPED_ONLY)); };
+    CHECK(cached() == sorted());
+
+    const double cached_us  = measure(false, cached);
+    const double restack_us = measure(true, cached);
+    const double sort_us    = measure(false, sorted);
+
+    MESSAGE("300 views, get_views(WSET_SORT_STACKING): " << cached_us << " us cached, " << restack_us <<
+        " us after each restack, " << sort_us << " us sorting by scenegraph position");
+}
@@ -378,6 +378,15 @@ void wf::test::headless_core_harness_t::pointer_motion(double x, double y)
     wl_display_flush_clients(priv->core->display);
 }
 
+void wf::test::headless_core_harness_t::pointer_relative_motion(double dx, double dy)
+{
+    auto position = priv->core->seat->priv->cursor->get_cursor_position();
+    priv->core->seat->priv->cursor->warp_cursor({position.x + dx, position.y + dy});
+    priv->core->seat->priv->lpointer->handle_cursor_motion(priv->touch_time++);
+    wlr_seat_pointer_notify_frame(priv->core->seat->seat);
+    wl_display_flush_clients(priv->core->display);
+}
+
 void wf::test::headless_core_harness_t::pointer_button(uint32_t button, uint32_t state)
 {
     wlr_pointer_button_event ev = {};
@@ -0,0 +1,50 @@
+#include "mapped-toplevel.hpp"
+
+#include <stdexcept>
+
+#include <wayfire/core.hpp>
+#include <wayfire/signal-definitions.hpp>
+
+wf::test::mapped_toplevel_t wf::test::map_toplevel(headless_core_harness_t& harness,
+    const std::string& title, int width, int height)
+{
+    mapped_toplevel_t mapped;
+    wf::signal::connection_t<wf::view_mapped_signal> on_map = [&] (wf::view_mapped_signal *ev)
+    {
+        if (!mapped.view)
+        {
+            mapped.view = wf::toplevel_cast(ev->view);
+        }
+    };
+    wf::get_core().connect(&on_map);
+
+    mapped.client = std::make_unique<wayland_xdg_client_t>(harness.socket_name());
+    auto& client = *mapped.client;
+    if (!harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_required_globals();
+    }))
+    {
+        throw std::runtime_error("Timed out waiting for the compositor's globals");
+    }
+
+    client.create_toplevel(title, "org.wayfire.Test");
+    if (!harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_pending_configure();
+    }))
+    {
+        throw std::runtime_error("Timed out waiting for the initial configure of \"" + title + "\"");
+    }
+
+    client.clear_pending_configure();
+    client.attach_and_commit(width, height);
+    if (!harness.run_until([&] { return mapped.view != nullptr; }))
+    {
+        throw std::runtime_error("Timed out waiting for \"" + title + "\" to be mapped");
+    }
+
+    return mapped;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <wayfire/toplevel-view.hpp>
+
+#include "headless-core-harness.hpp"
+#include "wayland-xdg-client.hpp"
+
+namespace wf::test
+{
+struct mapped_toplevel_t
+{
+    std::unique_ptr<wayland_xdg_client_t> client;
+    wayfire_toplevel_view view;
+};
+
+/**
+ * Connect a new xdg-shell client to @harness, create a toplevel with the given title, commit a buffer of the
+ * given size once the toplevel is configured, and wait until the compositor maps the view.
+ *
+ * The initial configure is cleared, so that the client's next pending configure is a new one.
+ * Throws std::runtime_error if any step times out.
+ */
+mapped_toplevel_t map_toplevel(headless_core_harness_t& harness, const std::string& title,
+    int width, int height);
+}
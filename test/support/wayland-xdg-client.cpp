@@ -5,6 +5,7 @@
 #include <utility>
 #include <vector>
 #include <cmath>
+#include <unistd.h>
 
 #include <wayland-client-core.h>
 #include <wayland-client-protocol.h>
@@ -23,6 +24,7 @@ struct wf::test::wayland_xdg_client_t::impl
     wl_seat *seat = nullptr;
     wl_pointer *pointer = nullptr;
     wl_touch *touch     = nullptr;
+    wl_keyboard *keyboard = nullptr;
     xdg_wm_base *wm_base = nullptr;
     wp_fractional_scale_manager_v1 *fractional_scale_manager = nullptr;
     wp_viewporter *viewporter = nullptr;
@@ -43,6 +45,7 @@ struct wf::test::wayland_xdg_client_t::impl
     std::pair<int, int> committed_buffer_size = {0, 0};
     std::vector<pointer_event_t> pointer_events;
     std::vector<touch_event_t> touch_events;
+    std::vector<keyboard_event_t> keyboard_events;
 
     static void handle_registry_global(void *data, wl_registry *registry,
         uint32_t name, const char *interface, uint32_t version)
@@ -107,6 +110,16 @@ struct wf::test::wayland_xdg_client_t::impl
             wl_touch_destroy(self->touch);
             self->touch = nullptr;
         }
+
+        if ((capabilities & WL_SEAT_CAPABILITY_KEYBOARD) && !self->keyboard)
+        {
+            self->keyboard = wl_seat_get_keyboard(seat);
+            wl_keyboard_add_listener(self->keyboard, &keyboard_listener, self);
+        } else if (!(capabilities & WL_SEAT_CAPABILITY_KEYBOARD) && self->keyboard)
+        {
+            wl_keyboard_destroy(self->keyboard);
+            self->keyboard = nullptr;
+        }
     }
 
     static void handle_seat_name(void*, wl_seat*, const char*)
@@ -139,8 +152,12 @@ struct wf::test::wayland_xdg_client_t::impl
             wl_fixed_to_double(x), wl_fixed_to_double(y)});
     }
 
-    static void handle_pointer_button(void*, wl_pointer*, uint32_t, uint32_t, uint32_t, uint32_t)
-    {}
+    static void handle_pointer_button(void *data, wl_pointer*, uint32_t, uint32_t,
+        uint32_t button, uint32_t state)
+    {
+        auto *self = static_cast<impl*>(data);
+        self->pointer_events.push_back({pointer_event_t::BUTTON, 0.0, 0.0, button, state});
+    }
 
     static void handle_pointer_axis(void*, wl_pointer*, uint32_t, uint32_t, wl_fixed_t)
     {}
@@ -230,6 +247,46 @@ struct wf::test::wayland_xdg_client_t::impl
         .orientation = handle_touch_orientation,
     };
 
+    static void handle_keyboard_keymap(void*, wl_keyboard*, uint32_t, int32_t fd, uint32_t)
+    {
+        close(fd);
+    }
+
+    static void handle_keyboard_enter(void *data, wl_keyboard*, uint32_t, wl_surface*, wl_array*)
+    {
+        auto *self = static_cast<impl*>(data);
+        self->keyboard_events.push_back({keyboard_event_t::ENTER});
+    }
+
+    static void handle_keyboard_leave(void *data, wl_keyboard*, uint32_t, wl_surface*)
+    {
+        auto *self = static_cast<impl*>(data);
+        self->keyboard_events.push_back({keyboard_event_t::LEAVE});
+    }
+
+    static void handle_keyboard_key(void *data, wl_keyboard*, uint32_t, uint32_t,
+        uint32_t key, uint32_t state)
+    {
+        auto *self = static_cast<impl*>(data);
+        self->keyboard_events.push_back({keyboard_event_t::KEY, key, state});
+    }
+
+    static void handle_keyboard_modifiers(void*, wl_keyboard*, uint32_t, uint32_t, uint32_t,
+        uint32_t, uint32_t)
+    {}
+
+    static void handle_keyboard_repeat_info(void*, wl_keyboard*, int32_t, int32_t)
+    {}
+
+    static constexpr wl_keyboard_listener keyboard_listener = {
+        .keymap = handle_keyboard_keymap,
+        .enter  = handle_keyboard_enter,
+        .leave  = handle_keyboard_leave,
+        .key    = handle_keyboard_key,
+        .modifiers   = handle_keyboard_modifiers,
+        .repeat_info = handle_keyboard_repeat_info,
+    };
+
     static void handle_ping(void*, xdg_wm_base *wm_base, uint32_t serial)
     {
         xdg_wm_base_pong(wm_base, serial);
@@ -357,6 +414,11 @@ wf::test::wayland_xdg_client_t::~wayland_xdg_client_t()
         wl_touch_destroy(priv->touch);
     }
 
+    if (priv->keyboard)
+    {
+        wl_keyboard_destroy(priv->keyboard);
+    }
+
     if (priv->pointer)
     {
         wl_pointer_destroy(priv->pointer);
@@ -428,6 +490,11 @@ bool wf::test::wayland_xdg_client_t::has_touch() const
     return priv->touch;
 }
 
+bool wf::test::wayland_xdg_client_t::has_keyboard() const
+{
+    return priv->keyboard;
+}
+
 void wf::test::wayland_xdg_client_t::create_toplevel(const std::string& title,
     const std::string& app_id)
 {
@@ -648,3 +715,13 @@ void wf::test::wayland_xdg_client_t::clear_touch_events()
 {
     priv->touch_events.clear();
 }
+
+const std::vector<wf::test::keyboard_event_t>& wf::test::wayland_xdg_client_t::keyboard_events() const
+{
+    return priv->keyboard_events;
+}
+
+void wf::test::wayland_xdg_client_t::clear_keyboard_events()
+{
+    priv->keyboard_events.clear();
+}
@@ -14,6 +14,7 @@ struct wl_surface;
 struct wl_buffer;
 struct wl_seat;
 struct wl_pointer;
+struct wl_keyboard;
 struct wl_touch;
 struct xdg_wm_base;
 struct xdg_surface;
@@ -45,10 +46,28 @@ struct pointer_event_t
         LEAVE,
         MOTION,
         FRAME,
+        BUTTON,
     } type;
 
     double x = 0.0;
     double y = 0.0;
+    /* For BUTTON events */
+    uint32_t button = 0;
+    uint32_t state  = 0;
+};
+
+struct keyboard_event_t
+{
+    enum type_t
+    {
+        ENTER,
+        LEAVE,
+        KEY,
+    } type;
+
+    /* For KEY events */
+    uint32_t key   = 0;
+    uint32_t state = 0;
 };
 
 class wayland_xdg_client_t
@@ -69,6 +88,7 @@ class wayland_xdg_client_t
     bool has_required_globals() const;
     bool has_pointer() const;
     bool has_touch() const;
+    bool has_keyboard() const;
     void create_toplevel(const std::string& title, const std::string& app_id);
     bool has_pending_configure() const;
     uint32_t last_configure_serial() const;
@@ -90,6 +110,8 @@ class wayland_xdg_client_t
     void clear_pointer_events();
     const std::vector<touch_event_t>& touch_events() const;
     void clear_touch_events();
+    const std::vector<keyboard_event_t>& keyboard_events() const;
+    void clear_keyboard_events();
 
   private:
     struct impl;